@@ -0,0 +1,100 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <random>
+
+#include <arm7tdmi/disassembler.h>
+
+#include "opcodes.h"
+
+namespace {
+    constexpr size_t opcode_count = 4096;
+
+    template <typename Opcode, typename Decode>
+    u32 decode_all(const std::vector<Opcode>& ops, Decode decode) {
+        u32 sum = 0;
+        for (const Opcode op : ops) {
+            sum += static_cast<u32>(decode(op));
+        }
+        return sum;
+    }
+}
+
+TEST_CASE("decode_throughput", "[benchmark][decode]")
+{
+    const auto arm_ops = opcodes::arm(opcode_count);
+    const auto thumb_ops = opcodes::thumb(opcode_count);
+
+    std::mt19937 rng(7);
+    std::vector<u32> arm_random(opcode_count);
+    std::vector<u16> thumb_random(opcode_count);
+    for (auto& op : arm_random) op = rng();
+    for (auto& op : thumb_random) op = static_cast<u16>(rng());
+
+    BENCHMARK("arm_decode_mix_4096") {
+        return decode_all(arm_ops, [](const u32 op) { return arm7tdmi::arm::decode(op); });
+    };
+
+    BENCHMARK("arm_decode_uniform_4096") {
+        return decode_all(arm_random, [](const u32 op) { return arm7tdmi::arm::decode(op); });
+    };
+
+    BENCHMARK("thumb_decode_mix_4096") {
+        return decode_all(thumb_ops, [](const u16 op) { return arm7tdmi::thumb::decode(op); });
+    };
+
+    BENCHMARK("thumb_decode_uniform_4096") {
+        return decode_all(thumb_random, [](const u16 op) { return arm7tdmi::thumb::decode(op); });
+    };
+
+    std::vector<arm7tdmi::arm::instruction> arm_out(opcode_count);
+    std::vector<arm7tdmi::thumb::instruction> thumb_out(opcode_count);
+
+    BENCHMARK("arm_decode_batch_mix_4096") {
+        arm7tdmi::arm::decode_batch(arm_ops, arm_out);
+        return arm_out.back();
+    };
+
+    BENCHMARK("arm_decode_batch_uniform_4096") {
+        arm7tdmi::arm::decode_batch(arm_random, arm_out);
+        return arm_out.back();
+    };
+
+    BENCHMARK("thumb_decode_batch_mix_4096") {
+        arm7tdmi::thumb::decode_batch(thumb_ops, thumb_out);
+        return thumb_out.back();
+    };
+
+    BENCHMARK("thumb_decode_batch_uniform_4096") {
+        arm7tdmi::thumb::decode_batch(thumb_random, thumb_out);
+        return thumb_out.back();
+    };
+}
+
+TEST_CASE("disassemble_throughput", "[benchmark][decode]")
+{
+    const auto arm_ops = opcodes::arm(opcode_count);
+    const auto thumb_ops = opcodes::thumb(opcode_count);
+    std::vector<char> out(opcode_count * arm7tdmi::disassembly_line_size);
+
+    BENCHMARK("arm_disassemble_4096") {
+        char line[arm7tdmi::disassembly_line_size];
+        size_t total = 0;
+        for (size_t i = 0; i < arm_ops.size(); ++i) {
+            total += arm7tdmi::arm::disassemble(arm_ops[i], static_cast<u32>(i * 4), line, sizeof(line));
+        }
+        return total;
+    };
+
+    BENCHMARK("arm_disassemble_batch_4096") {
+        return arm7tdmi::arm::disassemble_batch(arm_ops, 0, out);
+    };
+
+    BENCHMARK("thumb_disassemble_batch_4096") {
+        return arm7tdmi::thumb::disassemble_batch(thumb_ops, 0, out);
+    };
+}
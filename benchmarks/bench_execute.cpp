@@ -0,0 +1,75 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+
+#include "opcodes.h"
+
+// Cost of cpu::execute per instruction class, over 256 opcodes of that class.
+
+namespace {
+    constexpr size_t opcode_count = 256;
+
+    template <typename Opcode, typename Instruction>
+    void execute_all(arm7tdmi::cpu& cpu, const Instruction instr, const std::vector<Opcode>& ops) {
+        for (const Opcode op : ops) {
+            cpu.registers.pc(0x100);
+            cpu.execute(instr, op);
+        }
+    }
+
+    void reset(arm7tdmi::cpu& cpu) {
+        cpu.registers = {};
+        cpu.registers.cpsr_set_mode(arm7tdmi::cpu_mode::supervisor);
+        for (u32 i = 0; i < 15; ++i) {
+            cpu.registers.set(i, 0x1000 + i * 0x40);
+        }
+        cpu.set_state(arm7tdmi::cpu_state::arm);
+    }
+}
+
+TEST_CASE("execute_arm", "[benchmark][execute]")
+{
+    auto memory = arm7tdmi::basic_memory(0x4000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    const auto ops = opcodes::arm(opcode_count * 64);
+
+    for (const auto& c : opcodes::arm_mix) {
+        std::vector<u32> class_ops;
+        for (const u32 op : ops) {
+            if (arm7tdmi::arm::decode(op) == c.instr && class_ops.size() < opcode_count) class_ops.push_back(op);
+        }
+
+        reset(cpu);
+        BENCHMARK(std::string("arm_") + arm7tdmi::arm::instruction_to_string(c.instr) + "_256") {
+            execute_all(cpu, c.instr, class_ops);
+            return cpu.registers.pc();
+        };
+    }
+}
+
+TEST_CASE("execute_thumb", "[benchmark][execute]")
+{
+    auto memory = arm7tdmi::basic_memory(0x4000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    const auto ops = opcodes::thumb(opcode_count * 64);
+
+    for (const auto& c : opcodes::thumb_mix) {
+        std::vector<u16> class_ops;
+        for (const u16 op : ops) {
+            if (arm7tdmi::thumb::decode(op) == c.instr && class_ops.size() < opcode_count) class_ops.push_back(op);
+        }
+
+        reset(cpu);
+        cpu.set_state(arm7tdmi::cpu_state::thumb);
+        BENCHMARK(std::string("thumb_") + arm7tdmi::thumb::instruction_to_string(c.instr) + "_256") {
+            execute_all(cpu, c.instr, class_ops);
+            return cpu.registers.pc();
+        };
+    }
+}
@@ -0,0 +1,51 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <arm7tdmi/memory.h>
+
+namespace {
+    constexpr u32 memory_size = 0x10000;
+    constexpr u32 accesses = 4096;
+
+    template <typename T, arm7tdmi::AlignmentType Alignment>
+    u32 read_all(const arm7tdmi::memory_interface& memory, const u32 offset) {
+        u32 sum = 0;
+        for (u32 i = 0; i < accesses; ++i) {
+            T value = 0;
+            memory.read<T, Alignment>((i * 12 + offset) % (memory_size - 4), &value);
+            sum += value;
+        }
+        return sum;
+    }
+
+    template <typename T, arm7tdmi::AlignmentType Alignment>
+    u32 write_all(arm7tdmi::memory_interface& memory, const u32 offset) {
+        u32 ok = 0;
+        for (u32 i = 0; i < accesses; ++i) {
+            ok += memory.write<T, Alignment>((i * 12 + offset) % (memory_size - 4), static_cast<T>(i));
+        }
+        return ok;
+    }
+}
+
+// offset 0 is aligned for every width, offset 1 is misaligned for halfwords and words
+#define MEMORY_BENCHMARKS(T, ALIGNMENT, NAME)                                                               \
+    BENCHMARK("read_" #T "_" NAME "_aligned_4096") { return read_all<T, ALIGNMENT>(memory, 0); };          \
+    BENCHMARK("read_" #T "_" NAME "_misaligned_4096") { return read_all<T, ALIGNMENT>(memory, 1); };       \
+    BENCHMARK("write_" #T "_" NAME "_aligned_4096") { return write_all<T, ALIGNMENT>(memory, 0); };        \
+    BENCHMARK("write_" #T "_" NAME "_misaligned_4096") { return write_all<T, ALIGNMENT>(memory, 1); }
+
+TEST_CASE("memory_access", "[benchmark][memory]")
+{
+    auto memory = arm7tdmi::basic_memory(memory_size);
+
+    MEMORY_BENCHMARKS(u8, arm7tdmi::AlignmentType::Force, "force");
+    MEMORY_BENCHMARKS(u16, arm7tdmi::AlignmentType::Force, "force");
+    MEMORY_BENCHMARKS(u32, arm7tdmi::AlignmentType::Force, "force");
+    MEMORY_BENCHMARKS(u32, arm7tdmi::AlignmentType::Rotate, "rotate");
+    MEMORY_BENCHMARKS(u32, arm7tdmi::AlignmentType::None, "none");
+}
@@ -0,0 +1,137 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <arm7tdmi/predecode.h>
+#include <arm7tdmi/tiers.h>
+
+#include "kernels.h"
+
+// Whole program throughput. Each benchmark runs a kernel to completion and checks its checksum, so
+// MIPS = the kernel's instructions a run (kernels.h) / mean time in microseconds.
+
+namespace {
+    u32 run(arm7tdmi::cpu& cpu) {
+        cpu.registers = {};
+        cpu.set_state(arm7tdmi::cpu_state::thumb);
+        u32 pc = 0;
+        do {
+            pc = cpu.registers.pc();
+            cpu.step();
+        } while (cpu.registers.pc() != pc);
+        return cpu.registers.r0();
+    }
+}
+
+TEST_CASE("program_throughput", "[benchmark][program]")
+{
+    auto memory = arm7tdmi::basic_memory(kernels::memory_size);
+    auto cpu = arm7tdmi::cpu(&memory);
+
+    kernels::load(memory, kernels::checksum);
+    const u32 checksum = kernels::expected_checksum(memory);
+    BENCHMARK("thumb_checksum_1k") {
+        const u32 r0 = run(cpu);
+        REQUIRE(r0 == checksum);
+        return r0;
+    };
+
+    kernels::load(memory, kernels::memcpy);
+    const u32 copied = kernels::expected_memcpy(memory);
+    BENCHMARK("thumb_memcpy_1k") {
+        const u32 r0 = run(cpu);
+        REQUIRE(r0 == copied);
+        return r0;
+    };
+
+    kernels::load(memory, kernels::histogram);
+    const u32 histogram = kernels::expected_histogram(memory);
+    BENCHMARK("thumb_histogram_1k") {
+        const u32 r0 = run(cpu);
+        REQUIRE(r0 == histogram);
+        return r0;
+    };
+}
+
+TEST_CASE("block_loop_throughput", "[benchmark][program]")
+{
+    auto memory = arm7tdmi::basic_memory(kernels::memory_size);
+    // 0x0000: LDMIA R1!, {R3-R6}; STMIA R0!, {R3-R6}; SUB R2, #16; BNE 0x0000
+    // 0x0008: B 0x0008
+    const u16 loop[] = {0xc978, 0xc078, 0x3a10, 0xd1fb, 0xe7fe};
+    for (u32 i = 0; i < std::size(loop); ++i) {
+        memory.write<u16>(i * 2, loop[i]);
+    }
+
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    cache.fill(memory);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_predecode(&cache);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+
+    // Copies 1KiB from the data area
+    auto copy = [&]() {
+        cpu.registers.pc(0x0000);
+        cpu.registers.r0(0x2000);
+        cpu.registers.r1(kernels::data_address);
+        cpu.registers.r2(0x400);
+        while (cpu.registers.pc() != 0x0008) {
+            cpu.step();
+        }
+        return cpu.registers.r0();
+    };
+
+    BENCHMARK("thumb_memcpy_1k_stepped") {
+        return copy();
+    };
+
+    cpu.set_block_loops(true);
+    BENCHMARK("thumb_memcpy_1k_block_loops") {
+        return copy();
+    };
+}
+
+TEST_CASE("tiered_throughput", "[benchmark][program]")
+{
+    auto memory = arm7tdmi::basic_memory(kernels::memory_size);
+    // The same copy loop as block_loop_throughput
+    const u16 loop[] = {0xc978, 0xc078, 0x3a10, 0xd1fb, 0xe7fe};
+    for (u32 i = 0; i < std::size(loop); ++i) {
+        memory.write<u16>(i * 2, loop[i]);
+    }
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+
+    auto copy = [&]() {
+        cpu.registers.pc(0x0000);
+        cpu.registers.r0(0x2000);
+        cpu.registers.r1(kernels::data_address);
+        cpu.registers.r2(0x400);
+        while (cpu.registers.pc() != 0x0008) {
+            cpu.step();
+        }
+        return cpu.registers.r0();
+    };
+
+    BENCHMARK("thumb_memcpy_1k_interpreted") {
+        return copy();
+    };
+
+    arm7tdmi::tiered_execution tiers;
+    cpu.set_tiers(&tiers);
+    BENCHMARK("thumb_memcpy_1k_tiered") {
+        return copy();
+    };
+
+    arm7tdmi::tier_config untimed;
+    untimed.timing = false;
+    arm7tdmi::tiered_execution untimed_tiers(untimed);
+    cpu.set_tiers(&untimed_tiers);
+    BENCHMARK("thumb_memcpy_1k_tiered_untimed") {
+        return copy();
+    };
+}
@@ -0,0 +1,49 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <arm7tdmi/register.h>
+
+namespace {
+    constexpr u32 iterations = 4096;
+
+    u32 get_all(const arm7tdmi::cpu_registers& registers, const arm7tdmi::Register reg) {
+        u32 sum = 0;
+        for (u32 i = 0; i < iterations; ++i) {
+            sum += registers.get(reg);
+        }
+        return sum;
+    }
+
+    void set_all(arm7tdmi::cpu_registers& registers, const arm7tdmi::Register reg) {
+        for (u32 i = 0; i < iterations; ++i) {
+            registers.set(reg, i);
+        }
+    }
+}
+
+TEST_CASE("register_access", "[benchmark][registers]")
+{
+    arm7tdmi::cpu_registers registers = {};
+
+    // Unbanked, FIQ banked and per-mode banked registers
+    for (const auto mode : {arm7tdmi::cpu_mode::user, arm7tdmi::cpu_mode::fiq, arm7tdmi::cpu_mode::irq, arm7tdmi::cpu_mode::supervisor}) {
+        registers.cpsr_set_mode(mode);
+        const std::string suffix = mode == arm7tdmi::cpu_mode::user ? "user"
+            : mode == arm7tdmi::cpu_mode::fiq ? "fiq"
+            : mode == arm7tdmi::cpu_mode::irq ? "irq" : "supervisor";
+
+        BENCHMARK("get_r0_" + suffix + "_4096") { return get_all(registers, arm7tdmi::Register::R0); };
+        BENCHMARK("get_r8_" + suffix + "_4096") { return get_all(registers, arm7tdmi::Register::R8); };
+        BENCHMARK("get_r13_" + suffix + "_4096") { return get_all(registers, arm7tdmi::Register::R13); };
+        BENCHMARK("set_r0_" + suffix + "_4096") { set_all(registers, arm7tdmi::Register::R0); };
+        BENCHMARK("set_r13_" + suffix + "_4096") { set_all(registers, arm7tdmi::Register::R13); };
+
+        if (mode != arm7tdmi::cpu_mode::user) {
+            BENCHMARK("get_spsr_" + suffix + "_4096") { return get_all(registers, arm7tdmi::Register::SPSR); };
+        }
+    }
+}
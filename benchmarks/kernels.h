@@ -0,0 +1,149 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <random>
+#include <span>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+
+// Small guest programs for whole-program throughput, hand assembled so the benchmarks
+// don't need the Arm GNU Toolchain. They are THUMB, and only use instructions the interpreter
+// implements, so a run does real work: each one starts at 0x0000, works through 1KiB of random data
+// at 0x1000, leaves its checksum in R0, and finishes on a branch to itself. Constants are loaded
+// from a pool at 0x0070.
+
+namespace kernels {
+
+    constexpr u32 pool_address = 0x0070;
+    constexpr u32 data_address = 0x1000;
+    constexpr u32 data_size = 0x400;
+    constexpr u32 copy_address = 0x2000;
+    constexpr u32 bucket_address = 0x3000;
+    constexpr u32 memory_size = 0x4000;
+
+    // Counts the bytes >= 0x80, 6650 instructions a run
+    constexpr std::array<u16, 12> checksum = {
+        0x2700, // 0x0000: MOV R7, #0
+        0x6f39, // 0x0002: LDR R1, [R7, #0x70]     @ data_address
+        0x6f7a, // 0x0004: LDR R2, [R7, #0x74]     @ data_size
+        0x2000, // 0x0006: MOV R0, #0
+        0x780b, // 0x0008: LDRB R3, [R1, #0]
+        0x2b80, // 0x000a: CMP R3, #0x80
+        0xd300, // 0x000c: BCC 0x0010
+        0x3001, // 0x000e: ADD R0, #1
+        0x3101, // 0x0010: ADD R1, #1
+        0x3a01, // 0x0012: SUB R2, #1
+        0xd1f8, // 0x0014: BNE 0x0008
+        0xe7fe, // 0x0016: B 0x0016
+    };
+
+    // Copies 1KiB, 16 bytes at a time, then reads the last word back from the copy, 263
+    // instructions a run
+    constexpr std::array<u16, 11> memcpy = {
+        0x2700, // 0x0000: MOV R7, #0
+        0x6f39, // 0x0002: LDR R1, [R7, #0x70]     @ data_address
+        0x6fba, // 0x0004: LDR R2, [R7, #0x78]     @ copy_address
+        0x2740, // 0x0006: MOV R7, #64
+        0xc978, // 0x0008: LDMIA R1!, {R3-R6}
+        0xc278, // 0x000a: STMIA R2!, {R3-R6}
+        0x3f01, // 0x000c: SUB R7, #1
+        0xd1fb, // 0x000e: BNE 0x0008
+        0x3a04, // 0x0010: SUB R2, #4
+        0xca01, // 0x0012: LDMIA R2!, {R0}
+        0xe7fe, // 0x0014: B 0x0014
+    };
+
+    // Counts the bytes in each quarter of 0-255 into 4 buckets, summing the bucket number (1-4) of
+    // every byte into R0, 13801 instructions a run
+    constexpr std::array<u16, 41> histogram = {
+        0x2700, // 0x0000: MOV R7, #0
+        0x6f39, // 0x0002: LDR R1, [R7, #0x70]     @ data_address
+        0x6f7a, // 0x0004: LDR R2, [R7, #0x74]     @ data_size
+        0x6ffd, // 0x0006: LDR R5, [R7, #0x7c]     @ bucket_address
+        0x2000, // 0x0008: MOV R0, #0
+        0x2400, // 0x000a: MOV R4, #0
+        0x602c, // 0x000c: STR R4, [R5, #0]
+        0x606c, // 0x000e: STR R4, [R5, #4]
+        0x60ac, // 0x0010: STR R4, [R5, #8]
+        0x60ec, // 0x0012: STR R4, [R5, #12]
+        0x780b, // 0x0014: LDRB R3, [R1, #0]
+        0x2b40, // 0x0016: CMP R3, #0x40
+        0xd304, // 0x0018: BCC 0x0024
+        0x2b80, // 0x001a: CMP R3, #0x80
+        0xd307, // 0x001c: BCC 0x002e
+        0x2bc0, // 0x001e: CMP R3, #0xc0
+        0xd30a, // 0x0020: BCC 0x0038
+        0xe00e, // 0x0022: B 0x0042
+        0x682c, // 0x0024: LDR R4, [R5, #0]
+        0x3401, // 0x0026: ADD R4, #1
+        0x602c, // 0x0028: STR R4, [R5, #0]
+        0x3001, // 0x002a: ADD R0, #1
+        0xe00d, // 0x002c: B 0x004a
+        0x686c, // 0x002e: LDR R4, [R5, #4]
+        0x3401, // 0x0030: ADD R4, #1
+        0x606c, // 0x0032: STR R4, [R5, #4]
+        0x3002, // 0x0034: ADD R0, #2
+        0xe008, // 0x0036: B 0x004a
+        0x68ac, // 0x0038: LDR R4, [R5, #8]
+        0x3401, // 0x003a: ADD R4, #1
+        0x60ac, // 0x003c: STR R4, [R5, #8]
+        0x3003, // 0x003e: ADD R0, #3
+        0xe003, // 0x0040: B 0x004a
+        0x68ec, // 0x0042: LDR R4, [R5, #12]
+        0x3401, // 0x0044: ADD R4, #1
+        0x60ec, // 0x0046: STR R4, [R5, #12]
+        0x3004, // 0x0048: ADD R0, #4
+        0x3101, // 0x004a: ADD R1, #1
+        0x3a01, // 0x004c: SUB R2, #1
+        0xd1e1, // 0x004e: BNE 0x0014
+        0xe7fe, // 0x0050: B 0x0050
+    };
+
+    inline void load(arm7tdmi::basic_memory& memory, const std::span<const u16> program) {
+        for (size_t i = 0; i < program.size(); ++i) {
+            memory.write<u16>(static_cast<u32>(i * sizeof(u16)), program[i]);
+        }
+
+        memory.write<u32>(pool_address, data_address);
+        memory.write<u32>(pool_address + 4, data_size);
+        memory.write<u32>(pool_address + 8, copy_address);
+        memory.write<u32>(pool_address + 12, bucket_address);
+
+        std::mt19937 rng(1234);
+        for (u32 address = data_address; address < data_address + data_size; address += sizeof(u32)) {
+            memory.write<u32>(address, rng());
+        }
+    }
+
+    // The checksums the kernels should leave in R0, computed from the loaded data
+    inline u32 expected_checksum(const arm7tdmi::basic_memory& memory) {
+        u32 count = 0;
+        for (u32 address = data_address; address < data_address + data_size; ++address) {
+            u8 byte = 0;
+            memory.read<u8>(address, &byte);
+            count += byte >= 0x80;
+        }
+        return count;
+    }
+
+    inline u32 expected_memcpy(const arm7tdmi::basic_memory& memory) {
+        u32 word = 0;
+        memory.read<u32>(data_address + data_size - sizeof(u32), &word);
+        return word;
+    }
+
+    inline u32 expected_histogram(const arm7tdmi::basic_memory& memory) {
+        u32 sum = 0;
+        for (u32 address = data_address; address < data_address + data_size; ++address) {
+            u8 byte = 0;
+            memory.read<u8>(address, &byte);
+            sum += (byte >> 6) + 1;
+        }
+        return sum;
+    }
+}
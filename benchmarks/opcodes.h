@@ -0,0 +1,93 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include <arm7tdmi/decoder.h>
+
+// Opcode streams with roughly the instruction mix of compiled ARM/Thumb code, rather
+// than uniformly random bits (which are mostly data processing and coprocessor space). Each opcode is
+// random within its class' encoding, with the class confirmed by the scalar decoder. Block transfers
+// never use the S bit and BX only uses R0-R7, so every opcode can be executed from any state.
+
+namespace opcodes {
+
+    template <typename Instruction, typename Opcode>
+    struct weighted_class {
+        Instruction instr;
+        Opcode format;
+        Opcode mask;
+        u32 weight;
+    };
+
+    inline const weighted_class<arm7tdmi::arm::instruction, u32> arm_mix[] = {
+        {arm7tdmi::arm::instruction::data_processing, 0x00000000, 0x0c000000, 45},
+        {arm7tdmi::arm::instruction::single_data_transfer, 0x04000000, 0x0c000000, 22},
+        {arm7tdmi::arm::instruction::branch, 0x0a000000, 0x0e000000, 12},
+        {arm7tdmi::arm::instruction::block_data_transfer, 0x08000000, 0x0e400000, 7},
+        {arm7tdmi::arm::instruction::halfword_data_transfer_immediate, 0x004000b0, 0x0e4000f0, 4},
+        {arm7tdmi::arm::instruction::multiply, 0x00000090, 0x0f8000f0, 3},
+        {arm7tdmi::arm::instruction::branch_and_exchange, 0x012fff10, 0x0ffffff8, 3},
+        {arm7tdmi::arm::instruction::multiply_long, 0x00800090, 0x0f8000f0, 1},
+        {arm7tdmi::arm::instruction::software_interrupt, 0x0f000000, 0x0f000000, 1},
+        {arm7tdmi::arm::instruction::psr_transfer_mrs, 0x010f0000, 0x0fbf0fff, 1},
+        {arm7tdmi::arm::instruction::psr_transfer_msr, 0x0129f000, 0x0fbffff0, 1},
+    };
+
+    inline const weighted_class<arm7tdmi::thumb::instruction, u16> thumb_mix[] = {
+        {arm7tdmi::thumb::instruction::move_compare_add_subtract_immediate, 0x2000, 0xe000, 18},
+        {arm7tdmi::thumb::instruction::load_store_with_immediate_offset, 0x6000, 0xe000, 14},
+        {arm7tdmi::thumb::instruction::alu_operations, 0x4000, 0xfc00, 10},
+        {arm7tdmi::thumb::instruction::conditional_branch, 0xd000, 0xf000, 9},
+        {arm7tdmi::thumb::instruction::move_shifted_register, 0x0000, 0xe000, 8},
+        {arm7tdmi::thumb::instruction::add_subtract, 0x1800, 0xf800, 7},
+        {arm7tdmi::thumb::instruction::long_branch_with_link, 0xf000, 0xf000, 6},
+        {arm7tdmi::thumb::instruction::pc_relative_load, 0x4800, 0xf800, 5},
+        {arm7tdmi::thumb::instruction::sp_relative_load_store, 0x9000, 0xf000, 5},
+        {arm7tdmi::thumb::instruction::push_pop_registers, 0xb400, 0xf600, 4},
+        {arm7tdmi::thumb::instruction::hi_register_operations_branch_exchange, 0x4400, 0xfc00, 4},
+        {arm7tdmi::thumb::instruction::unconditional_branch, 0xe000, 0xf800, 3},
+        {arm7tdmi::thumb::instruction::load_store_with_register_offset, 0x5000, 0xf200, 2},
+        {arm7tdmi::thumb::instruction::load_store_halfword, 0x8000, 0xf000, 2},
+        {arm7tdmi::thumb::instruction::load_address, 0xa000, 0xf000, 1},
+        {arm7tdmi::thumb::instruction::multiple_load_store, 0xc000, 0xf000, 1},
+        {arm7tdmi::thumb::instruction::add_offset_to_stack_pointer, 0xb000, 0xff00, 1},
+        {arm7tdmi::thumb::instruction::load_store_sign_extended_byte_halfword, 0x5200, 0xf200, 1},
+    };
+
+    template <typename Opcode, typename Mix, typename Decode>
+    std::vector<Opcode> generate(const Mix& mix, Decode decode, const size_t count, const u32 seed = 42) {
+        std::mt19937 rng(seed);
+        std::vector<u32> weights;
+        for (const auto& c : mix) weights.push_back(c.weight);
+        std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+        std::vector<Opcode> out;
+        out.reserve(count);
+        while (out.size() < count) {
+            const auto& c = mix[pick(rng)];
+            Opcode opcode = static_cast<Opcode>((rng() & ~c.mask) | c.format);
+            if constexpr (sizeof(Opcode) == sizeof(u32)) {
+                // Mostly unconditional, as compiled code is
+                if (rng() % 5 != 0) opcode = (opcode & 0x0fffffff) | 0xe0000000;
+                if ((opcode >> 28) == 0xf) opcode &= 0xefffffff;
+            }
+            if (decode(opcode) == c.instr) {
+                out.push_back(opcode);
+            }
+        }
+        return out;
+    }
+
+    inline std::vector<u32> arm(const size_t count) {
+        return generate<u32>(arm_mix, [](const u32 op) { return arm7tdmi::arm::decode(op); }, count);
+    }
+
+    inline std::vector<u16> thumb(const size_t count) {
+        return generate<u16>(thumb_mix, [](const u16 op) { return arm7tdmi::thumb::decode(op); }, count);
+    }
+}
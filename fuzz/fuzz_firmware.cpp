@@ -0,0 +1,163 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+// libFuzzer harness for guest firmware. The image is loaded and run up to the entry point once, and
+// the machine is checkpointed there. Every input is then written into guest memory, with its address
+// in R0 and length in R1, and run from the checkpoint until the stop address, a fetch fault, or the
+// cycle budget. Between inputs only the registers and the pages the run dirtied are restored.
+//
+// Guest edge coverage is handed to libFuzzer through its extra counters section, alongside the
+// coverage of the host.
+//
+// Configured through the environment, since libFuzzer owns the command line:
+//   ARM7TDMI_FUZZ_IMAGE       ELF image (required)
+//   ARM7TDMI_FUZZ_INPUT       Address the input is written to (required)
+//   ARM7TDMI_FUZZ_INPUT_SIZE  Largest input, longer ones are truncated (default 4096)
+//   ARM7TDMI_FUZZ_ENTRY       Symbol or address to checkpoint at (default: the ELF entry point)
+//   ARM7TDMI_FUZZ_STOP        Symbol or address which ends a run (default: none)
+//   ARM7TDMI_FUZZ_CYCLES      Cycle budget per input (default 100000)
+//   ARM7TDMI_FUZZ_MEMORY      Guest memory size (default 0x40000)
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <arm7tdmi/coverage.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/timeline.h>
+
+namespace {
+    // Cycles allowed for the image to reach the entry point
+    constexpr u64 startup_cycles = 100'000'000;
+
+    __attribute__((section("__libfuzzer_extra_counters")))
+    u8 guest_edges[arm7tdmi::coverage::edge_map_size];
+
+    struct harness {
+        std::unique_ptr<arm7tdmi::basic_memory> memory;
+        std::unique_ptr<arm7tdmi::cpu> core;
+        std::unique_ptr<arm7tdmi::coverage> coverage;
+        arm7tdmi::checkpoint snapshot;
+
+        u32 input_address = 0;
+        u32 input_size = 0;
+        bool has_stop = false;
+        u32 stop = 0;
+        u64 cycles = 0;
+    };
+
+    harness* fuzz = nullptr;
+
+    [[noreturn]] void fail(const std::string& message) {
+        fmt::print(stderr, "fuzz_firmware: {}\n", message);
+        std::exit(1);
+    }
+
+    // Symbol name, or decimal/0x prefixed number
+    bool resolve(const arm7tdmi::elf_image& image, const char* text, u32* out) {
+        for (const auto& symbol : image.symbols()) {
+            if (symbol.name == text) {
+                *out = symbol.address;
+                return true;
+            }
+        }
+        char* end = nullptr;
+        *out = static_cast<u32>(std::strtoul(text, &end, 0));
+        return end != text && *end == '\0';
+    }
+
+    u64 environment_number(const char* name, const u64 fallback) {
+        const char* value = std::getenv(name);
+        return value ? std::strtoull(value, nullptr, 0) : fallback;
+    }
+}
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+    const char* image_path = std::getenv("ARM7TDMI_FUZZ_IMAGE");
+    const char* input = std::getenv("ARM7TDMI_FUZZ_INPUT");
+    if (!image_path || !input) {
+        fail("ARM7TDMI_FUZZ_IMAGE and ARM7TDMI_FUZZ_INPUT must be set");
+    }
+
+    std::ifstream file(image_path, std::ios::binary);
+    arm7tdmi::elf_image image;
+    if (!file || !image.load(file)) {
+        fail(fmt::format("{} is not an ARM ELF image", image_path));
+    }
+
+    fuzz = new harness;
+    fuzz->memory = std::make_unique<arm7tdmi::basic_memory>(environment_number("ARM7TDMI_FUZZ_MEMORY", 0x40000));
+    if (!image.load_segments(*fuzz->memory)) {
+        fail("image does not fit in guest memory, raise ARM7TDMI_FUZZ_MEMORY");
+    }
+    fuzz->core = std::make_unique<arm7tdmi::cpu>(fuzz->memory.get());
+    fuzz->coverage = std::make_unique<arm7tdmi::coverage>(0, static_cast<u32>(fuzz->memory->size()));
+
+    if (!resolve(image, input, &fuzz->input_address)) {
+        fail(fmt::format("unknown input address {}", input));
+    }
+    fuzz->input_size = static_cast<u32>(environment_number("ARM7TDMI_FUZZ_INPUT_SIZE", 4096));
+    fuzz->cycles = environment_number("ARM7TDMI_FUZZ_CYCLES", 100'000);
+    if (const char* stop = std::getenv("ARM7TDMI_FUZZ_STOP")) {
+        if (!resolve(image, stop, &fuzz->stop)) {
+            fail(fmt::format("unknown stop address {}", stop));
+        }
+        fuzz->has_stop = true;
+    }
+
+    // THUMB entry points have bit 0 set
+    auto& core = *fuzz->core;
+    core.registers.pc(image.entry() & ~1u);
+    core.set_state(image.entry() & 1u ? arm7tdmi::cpu_state::thumb : arm7tdmi::cpu_state::arm);
+
+    u32 entry = core.registers.pc();
+    if (const char* name = std::getenv("ARM7TDMI_FUZZ_ENTRY")) {
+        if (!resolve(image, name, &entry)) {
+            fail(fmt::format("unknown entry {}", name));
+        }
+    }
+    while (core.registers.pc() != entry) {
+        if (core.get_cycles() >= startup_cycles || !core.step()) {
+            fail(fmt::format("image never reached the entry point {:#010x}", entry));
+        }
+    }
+
+    fuzz->coverage->attach(guest_edges);
+    core.set_coverage(fuzz->coverage.get());
+
+    fuzz->memory->clear_dirty_pages();
+    fuzz->snapshot.save(core, *fuzz->memory);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const u8* data, size_t size) {
+    auto& core = *fuzz->core;
+    auto& memory = *fuzz->memory;
+    fuzz->snapshot.restore_dirty(core, memory);
+
+    size = std::min<size_t>(size, fuzz->input_size);
+    for (size_t i = 0; i < size; ++i) {
+        memory.write<u8>(fuzz->input_address + static_cast<u32>(i), data[i]);
+    }
+    core.registers.r0(fuzz->input_address);
+    core.registers.r1(static_cast<u32>(size));
+
+    fuzz->coverage->start(core.registers.pc());
+    const u64 end = core.get_cycles() + fuzz->cycles;
+    while (core.get_cycles() < end) {
+        if (fuzz->has_stop && core.registers.pc() == fuzz->stop) {
+            break;
+        }
+        if (!core.step()) {
+            break;
+        }
+    }
+    return 0;
+}
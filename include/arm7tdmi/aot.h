@@ -0,0 +1,153 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <ostream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/util.h>
+
+namespace arm7tdmi {
+
+    class memory_interface;
+
+    // Changes whenever aot_context, aot_block or the symbols of a compiled module change
+    constexpr u32 aot_abi_version = 2;
+
+    /**
+     * State passed to a compiled block. The cpu copies the visible registers and CPSR in and out
+     * around each block, and data accesses go back through the cpu, so statistics, predecode
+     * invalidation and memory wrappers see them as they would from the interpreter.
+     */
+    struct aot_context {
+        u32 r[16];
+        u32 cpsr;
+
+        // Set by a block which ends with a taken branch, along with the address just past the branch
+        bool branched;
+        u32 branch_end;
+
+        void* cpu;
+        bool (*read8)(void* cpu, u32 address, u8* out) noexcept;
+        bool (*read32)(void* cpu, u32 address, u32* out) noexcept;
+        bool (*write8)(void* cpu, u32 address, u8 value) noexcept;
+        bool (*write32)(void* cpu, u32 address, u32 value) noexcept;
+    };
+
+    /**
+     * Executes guest instructions from the block's address up to its first branch or unsupported
+     * instruction, leaving r[15] at the next instruction to execute.
+     * @return Instructions executed.
+     */
+    using aot_function = u32 (*)(aot_context& context) noexcept;
+
+    struct aot_block {
+        u32 address;
+        bool thumb;
+
+        // Bytes of guest code the block was compiled from, and their hle_hooks::signature
+        u32 size;
+        u64 hash;
+
+        // Opcode of the block's first instruction, see cpu::get_opcode
+        u32 opcode;
+
+        aot_function function;
+    };
+
+    struct aot_seed {
+        u32 address;
+        bool thumb;
+    };
+
+    /**
+     * Writes C++ source for every basic block reachable from the seeds through direct branches, one
+     * function per block, and a table of them exported as a module aot_module::load() accepts.
+     *
+     * Blocks contain only instructions the interpreter implements completely: ARM B/BL, and THUMB
+     * branches, BL, move/compare/add/subtract immediate, LDMIA/STMIA and load/store with immediate
+     * offset. A block ends at its first branch, so indirect branches (BX, POP {PC}) and anything else
+     * are left to the interpreter.
+     * @return Number of blocks written.
+     */
+    u32 write_aot_source(const memory_interface& memory, std::span<const aot_seed> seeds, std::ostream& out) noexcept;
+
+    /**
+     * Blocks compiled ahead of time, which the cpu (cpu::set_aot) runs in place of the interpreter
+     * whenever pc is at the start of one.
+     *
+     * A block executes in a single step(), so the IRQ line is only sampled between blocks, and
+     * per-instruction statistics are not counted for it. Blocks are not invalidated by writes to the
+     * code they were compiled from, verify() against memory before running self-modifying code.
+     */
+    class aot_module final {
+    public:
+        aot_module() noexcept = default;
+        ~aot_module() noexcept;
+
+        aot_module(const aot_module&) = delete;
+        aot_module& operator=(const aot_module&) = delete;
+
+        /**
+         * Loads the blocks of a shared object compiled from write_aot_source() output.
+         * @return False if it can't be loaded, or was compiled for a different aot_abi_version.
+         */
+        bool load(const std::string& path) noexcept;
+
+        /**
+         * Adds blocks linked into the executable.
+         */
+        void add(std::span<const aot_block> blocks) noexcept;
+
+        /**
+         * Drops the blocks whose code in memory differs from the code they were compiled from.
+         * @return Number of blocks dropped.
+         */
+        u32 verify(const memory_interface& memory) noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return _blocks.size(); }
+
+        [[nodiscard]] const aot_block* find_block(const u32 address, const bool thumb) const noexcept {
+            const auto& blocks = thumb ? _thumb : _arm;
+            const auto it = blocks.find(address);
+            return it != blocks.end() ? &it->second : nullptr;
+        }
+
+        [[nodiscard]] aot_function find(const u32 address, const bool thumb) const noexcept {
+            const auto* block = find_block(address, thumb);
+            return block ? block->function : nullptr;
+        }
+
+    private:
+        std::vector<void*> _libraries;
+        std::vector<aot_block> _blocks;
+        std::unordered_map<u32, aot_block> _arm;
+        std::unordered_map<u32, aot_block> _thumb;
+    };
+
+    /**
+     * Flag setting arithmetic used by compiled blocks, as the interpreter's.
+     */
+    inline u32 aot_add(aot_context& context, const u32 a, const u32 b) noexcept {
+        const u32 result = a + b;
+        const u32 c = result < a;
+        const u32 v = ((a ^ result) & (b ^ result)) >> 31;
+        context.cpsr = (context.cpsr & 0x0fffffffu) | (result & 0x80000000u) | ((result == 0) << 30) | (c << 29) | (v << 28);
+        return result;
+    }
+
+    inline u32 aot_subtract(aot_context& context, const u32 a, const u32 b) noexcept {
+        const u32 result = a - b;
+        const u32 c = a >= b;
+        const u32 v = ((a ^ b) & (a ^ result)) >> 31;
+        context.cpsr = (context.cpsr & 0x0fffffffu) | (result & 0x80000000u) | ((result == 0) << 30) | (c << 29) | (v << 28);
+        return result;
+    }
+
+}
@@ -0,0 +1,104 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/cpu.h>
+
+namespace arm7tdmi {
+
+    class memory_interface;
+
+    struct batch_statistics {
+        // Instructions fetched and decoded once for a group of lanes, and the lanes they were executed for
+        u64 lockstep_steps = 0;
+        u64 lockstep_lanes = 0;
+
+        // Instructions executed by a lane on its own, after it diverged
+        u64 scalar_steps = 0;
+    };
+
+    /**
+     * Runs many instances of the same program, each with its own memory, in lockstep.
+     *
+     * Lanes whose pc and state agree are stepped as a group: the instruction is fetched and decoded
+     * once, then dispatched to every lane, so coverage, hooks and statistics attached to a lane see it
+     * as they would from cpu::step(). Groups are kept from one step to the next, a group splits when
+     * its lanes' pcs diverge, and lanes rejoin a group as soon as their pcs agree again. Lanes with a
+     * predecode cache, compiled blocks or tiers attached (cpu::uses_code_caches), or an IRQ to take,
+     * are stepped on their own.
+     *
+     * Each lane keeps its registers in its own cpu rather than in structure-of-arrays form, and
+     * executes through the cpu's handlers rather than vector kernels across lanes. A lane-wide kernel
+     * would bypass the instrumentation attached to each lane, and the interpreter implements too few
+     * ALU instructions for one to pay off, so only fetch and decode are shared.
+     *
+     * Every lane must hold the same program image, since a group fetches code from its first lane's memory.
+     */
+    class cpu_batch final {
+    public:
+        explicit cpu_batch(const std::vector<memory_interface*>& memories) noexcept;
+
+        [[nodiscard]] u32 lanes() const noexcept { return static_cast<u32>(_lanes.size()); }
+        [[nodiscard]] cpu& lane(const u32 index) noexcept { return *_lanes[index]; }
+        [[nodiscard]] const cpu& lane(const u32 index) const noexcept { return *_lanes[index]; }
+
+        /**
+         * @return True if the lane has stopped, because an instruction could not be fetched.
+         */
+        [[nodiscard]] bool halted(const u32 index) const noexcept { return _halted[index]; }
+
+        /**
+         * Steps every running lane by one instruction, or by one block for lanes running compiled code.
+         */
+        void step() noexcept;
+
+        /**
+         * Calls step() the given number of times.
+         */
+        void run(u64 steps) noexcept;
+
+        [[nodiscard]] const batch_statistics& statistics() const noexcept { return _statistics; }
+
+    private:
+        struct group {
+            // pc and state of the group's lanes, as in group_key()
+            u64 key;
+            std::vector<u32> lanes;
+        };
+
+        [[nodiscard]] static u64 group_key(const cpu& lane) noexcept {
+            return static_cast<u64>(lane.registers.pc()) << 1 | static_cast<u64>(lane.get_state() == cpu_state::thumb);
+        }
+
+        void step_group(const u32* group, u32 size) noexcept;
+        void step_scalar(u32 lane) noexcept;
+        void place(u32 lane) noexcept;
+
+        std::vector<memory_interface*> _memories;
+        std::vector<std::unique_ptr<cpu>> _lanes;
+        std::vector<u8> _halted;
+
+        // Groups being stepped, and the groups their lanes land in, only the first _group_count and
+        // _next_count of each are in use. They are swapped every step, so lane lists keep their allocations.
+        std::vector<group> _groups;
+        std::vector<group> _next;
+        size_t _group_count = 0;
+        size_t _next_count = 0;
+        std::unordered_map<u64, u32> _next_index;
+        u64 _last_key = ~0ull;
+        u32 _last_group = 0;
+
+        // Lanes of the group being stepped which run together
+        std::vector<u32> _together;
+
+        batch_statistics _statistics;
+    };
+
+}
@@ -0,0 +1,54 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/hle.h>
+
+namespace arm7tdmi {
+
+    /**
+     * Host implementations of BIOS calls made by SWI (cpu::set_bios), indexed by function number: the
+     * comment field of a THUMB SWI, or bits 23-16 of an ARM SWI's, as BIOSes for ARM7TDMI devices
+     * number them. A call with no function, or whose function returns false, enters the guest's SWI
+     * handler as usual.
+     */
+    class bios_calls final {
+    public:
+        // Function numbers used by add_standard()
+        static constexpr u8 div = 0x06;
+        static constexpr u8 div_arm = 0x07;
+        static constexpr u8 sqrt = 0x08;
+        static constexpr u8 cpu_set = 0x0b;
+        static constexpr u8 cpu_fast_set = 0x0c;
+
+        void add(u8 function, hle_function implementation) noexcept { _functions[function] = std::move(implementation); }
+        void remove(const u8 function) noexcept { _functions[function] = nullptr; }
+
+        /**
+         * Adds the arithmetic and copy functions found in GBA compatible BIOSes:
+         * - div: r0 / r1 signed, quotient in r0, remainder in r1, absolute quotient in r3
+         * - div_arm: the same with the operands swapped
+         * - sqrt: integer square root of r0 in r0
+         * - cpu_set: copy or fill (r2 bit 24) of r2 bits 0-20 halfwords, or words if r2 bit 26, from r0 to r1
+         * - cpu_fast_set: copy or fill of r2 bits 0-20 words, rounded up to 8, from r0 to r1
+         * Division by zero is left to the guest's handler.
+         */
+        void add_standard() noexcept;
+
+        /**
+         * @return False if there is no function, or it declined the call.
+         */
+        bool call(const u8 function, cpu_registers& registers, memory_interface& memory) const noexcept {
+            return _functions[function] && _functions[function](registers, memory);
+        }
+
+    private:
+        std::array<hle_function, 256> _functions;
+    };
+
+}
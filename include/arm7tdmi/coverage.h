@@ -0,0 +1,115 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include <arm7tdmi/common.h>
+
+namespace arm7tdmi {
+
+    /**
+     * Guest code coverage, updated by the cpu on taken branches only.
+     *
+     * Every taken branch (and IRQ entry) ends a block, and counts the edge in an AFL style map: the
+     * target address is hashed, and the byte at hash ^ (previous hash >> 1) is incremented. The block
+     * itself, its start and end hashed together, is looked up in a small table of blocks already
+     * seen, and only marked in the executed bitmap on a miss. Straight-line code costs nothing, and
+     * a block run again costs a compare. Blocks longer than max_block_size bytes are marked up to it
+     * and counted as truncated.
+     *
+     * The edge map can be attached to an AFL shared memory segment, or any external 64 KiB buffer.
+     */
+    class coverage final {
+    public:
+        static constexpr u32 edge_map_size = 1u << 16;
+        static constexpr u32 max_block_size = 8192;
+
+        /**
+         * @param code_begin, code_end Region [begin, end) tracked by the executed bitmap.
+         */
+        coverage(u32 code_begin, u32 code_end) noexcept;
+        ~coverage() noexcept;
+
+        coverage(const coverage&) = delete;
+        coverage& operator=(const coverage&) = delete;
+
+        /**
+         * Ends the current block just before end, and starts the next one at target.
+         */
+        void edge(u32 end, u32 target) noexcept;
+
+        /**
+         * Starts a new block without counting an edge, e.g. when the cpu is moved to an entry point.
+         * cpu::set_coverage starts one at the cpu's pc.
+         */
+        void start(const u32 pc) noexcept { _block_start = pc; _previous = 0; }
+
+        /**
+         * Clears the edge map and the executed bitmap, for the next run of a fuzzing loop.
+         */
+        void reset() noexcept;
+
+        [[nodiscard]] bool executed(u32 address) const noexcept;
+        [[nodiscard]] u32 executed_halfwords() const noexcept;
+
+        /**
+         * Blocks longer than max_block_size, e.g. from a start() left over from another run.
+         */
+        [[nodiscard]] u64 truncated_blocks() const noexcept { return _truncated; }
+
+        [[nodiscard]] u8* edges() noexcept { return _edges; }
+        [[nodiscard]] const u8* edges() const noexcept { return _edges; }
+
+        /**
+         * Uses an external edge map of edge_map_size bytes, nullptr goes back to the internal one.
+         */
+        void attach(u8* map) noexcept;
+
+        /**
+         * Attaches the edge map to the shared memory segment named by the __AFL_SHM_ID environment variable.
+         * @return False if it isn't set, or the segment can't be attached (or on hosts without System V shared memory).
+         */
+        bool attach_afl_shared_memory() noexcept;
+
+    private:
+        static constexpr u32 seen_blocks = 4096;
+
+        static u32 hash(const u32 address) noexcept { return ((address >> 1) * 0x9e3779b1u) >> 16; }
+        static u64 block_key(const u32 begin, const u32 end) noexcept { return static_cast<u64>(begin) << 32 | end; }
+
+        void mark(u32 begin, u32 end) noexcept;
+        void detach_shared_memory() noexcept;
+
+        u32 _code_begin;
+        u32 _code_end;
+        std::vector<u64> _executed;
+        // Direct mapped by hash of (start, end), block_key of the last block marked in each slot
+        std::vector<u64> _seen;
+        u64 _truncated = 0;
+
+        u8* _edges = nullptr;
+        std::vector<u8> _own_edges;
+        void* _shared = nullptr;
+
+        u32 _block_start = 0;
+        u32 _previous = 0;
+    };
+
+    inline void coverage::edge(const u32 end, const u32 target) noexcept {
+        const u64 block = block_key(_block_start, end);
+        u64& seen = _seen[((block * 0x9e3779b97f4a7c15ull) >> 32) & (seen_blocks - 1)];
+        if (seen != block) {
+            seen = block;
+            mark(_block_start, end);
+        }
+
+        const u32 location = hash(target);
+        _edges[(location ^ _previous) & (edge_map_size - 1)]++;
+        _previous = location >> 1;
+        _block_start = target;
+    }
+
+}
@@ -7,11 +7,22 @@
 #include <arm7tdmi/common.h>
 #include "decoder.h"
 #include "register.h"
+#include "statistics.h"
 #include "util.h"
 
 namespace arm7tdmi {
 
     class memory_interface;
+    class coverage;
+    class predecode_cache;
+    class hle_hooks;
+    class semihosting;
+    class bios_calls;
+    class aot_module;
+    class tiered_execution;
+    struct aot_context;
+    struct tiered_block;
+    struct predecoded_thumb;
 
     class cpu final {
     public:
@@ -21,7 +32,148 @@ namespace arm7tdmi {
         explicit cpu(memory_interface* memory) noexcept;
         ~cpu() noexcept = default;
 
+        /**
+         * Bus every fetch and data access goes through, e.g. a trace_recorder wrapping the memory.
+         */
+        void set_memory(memory_interface* memory) noexcept { _memory = memory; }
+
         [[nodiscard]] cpu_state get_state() const noexcept { return _state; }
+        void set_state(const cpu_state state) noexcept { _state = state; }
+
+        /**
+         * Number of cycles executed so far. Instruction timings are not modelled yet, so every
+         * instruction retired by step() counts as a single cycle.
+         */
+        [[nodiscard]] u64 get_cycles() const noexcept { return _cycles; }
+        void set_cycles(const u64 cycles) noexcept { _cycles = cycles; }
+
+        /**
+         * Level of the external IRQ line. While asserted and CPSR.I is clear, the next step() enters
+         * the IRQ exception before fetching.
+         */
+        [[nodiscard]] bool get_irq_line() const noexcept { return _irq_line; }
+        void set_irq_line(const bool asserted) noexcept { _irq_line = asserted; }
+
+        /**
+         * Asserts the IRQ line once the cycle count reaches cycle, for host timers. Unlike asserting it
+         * between steps, this also interrupts between the two instructions of a fused pair, and stops a
+         * bulk block loop (set_block_loops) on the cycle it is due.
+         */
+        void schedule_irq(const u64 cycle) noexcept { _irq_cycle = cycle; }
+        [[nodiscard]] u64 get_irq_cycle() const noexcept { return _irq_cycle; }
+
+        /**
+         * Whether the next step() enters the IRQ exception.
+         */
+        [[nodiscard]] bool irq_pending() const noexcept { return (_irq_line || _cycles >= _irq_cycle) && !registers.cpsr_get_i(); }
+
+        /**
+         * Opcode of the first instruction the last step() executed, as dispatched, whether it was
+         * fetched or came from the predecode cache. For a compiled block (set_aot, set_tiers) it is
+         * the opcode of the block's first instruction.
+         */
+        [[nodiscard]] u32 get_opcode() const noexcept { return _opcode; }
+
+        /**
+         * Address just past the last instruction the last step() executed, which is the return address
+         * a call made by it leaves in LR. Past the second instruction of a fused pair, the branch back
+         * of a bulk block loop, or the last instruction of a compiled block.
+         */
+        [[nodiscard]] u32 get_instruction_end() const noexcept { return _instruction_end; }
+
+        /**
+         * Whether address is within the instruction at pc, so that reading it is the instruction fetch.
+         */
+        [[nodiscard]] bool fetching(const u32 address) const noexcept {
+            return address - registers.pc() < (_state == cpu_state::thumb ? sizeof(u16) : sizeof(u32));
+        }
+
+        /**
+         * Coverage updated on every taken branch and IRQ entry, nullptr to disable. Its first block
+         * starts at pc.
+         */
+        void set_coverage(coverage* coverage) noexcept;
+
+        /**
+         * Decoded instructions step() executes from instead of fetching, nullptr to disable. Writes
+         * made by instructions invalidate the entries they overlap.
+         */
+        void set_predecode(predecode_cache* predecode) noexcept { _predecode = predecode; }
+        [[nodiscard]] predecode_cache* get_predecode() const noexcept { return _predecode; }
+
+        /**
+         * Blocks compiled ahead of time, run instead of interpreting whenever pc is at the start of one,
+         * nullptr to disable. See aot_module.
+         */
+        void set_aot(const aot_module* aot) noexcept { _aot = aot; }
+        [[nodiscard]] const aot_module* get_aot() const noexcept { return _aot; }
+
+        /**
+         * Runs each block in the tier its entry count earns it, nullptr to disable. While attached,
+         * step() interprets cold code with decode and ignores set_predecode, set_aot and
+         * set_block_loops, which the tiers take the place of. See tiered_execution.
+         */
+        void set_tiers(tiered_execution* tiers) noexcept { _tiers = tiers; _tier_block = nullptr; _tier_next = 1; }
+        [[nodiscard]] tiered_execution* get_tiers() const noexcept { return _tiers; }
+
+        /**
+         * Host replacements for guest functions, looked up on every taken branch, nullptr to disable.
+         */
+        void set_hooks(hle_hooks* hooks) noexcept { _hooks = hooks; }
+        [[nodiscard]] hle_hooks* get_hooks() const noexcept { return _hooks; }
+
+        /**
+         * Host handlers for SWIs, nullptr to disable. Semihosting SWIs go to semihosting, then other
+         * SWIs to bios, and anything neither handles enters the supervisor exception at 0x08.
+         */
+        void set_semihosting(semihosting* semihosting) noexcept { _semihosting = semihosting; }
+        void set_bios(bios_calls* bios) noexcept { _bios = bios; }
+        [[nodiscard]] semihosting* get_semihosting() const noexcept { return _semihosting; }
+        [[nodiscard]] bios_calls* get_bios() const noexcept { return _bios; }
+
+        /**
+         * Recognises THUMB copy and fill loops (LDMIA/STMIA, STMIA or STR then ADD, counted down by
+         * SUB #imm and closed by a conditional branch) when executing from the predecode cache, and
+         * runs all their iterations in one step() as a host memmove or fill. Registers, flags, memory
+         * and cycles end up as if each instruction had been stepped. Loops over memory without direct
+         * access (memory_interface::direct_read) or which overwrite their own source or code are
+         * stepped normally. Off by default, since the IRQ line cannot change while a loop runs.
+         */
+        void set_block_loops(const bool enabled) noexcept { _block_loops = enabled; }
+        [[nodiscard]] bool get_block_loops() const noexcept { return _block_loops; }
+
+        /**
+         * Whether step() may run code from a predecode cache, compiled blocks or tiers rather than
+         * fetching it, so callers which fetch and dispatch for the cpu must call step() instead.
+         */
+        [[nodiscard]] bool uses_code_caches() const noexcept { return _predecode || _aot || _tiers; }
+
+#ifdef ARM7TDMI_STATISTICS
+        [[nodiscard]] const cpu_statistics& statistics() const noexcept { return _statistics; }
+        void reset_statistics() noexcept { _statistics = {}; }
+#endif
+
+        /**
+         * Fetches, decodes and executes the instruction at pc, then advances pc to the next
+         * instruction unless the instruction branched.
+         * @return False if the instruction could not be fetched.
+         */
+        bool step() noexcept;
+
+        /**
+         * Same as step(), but always executes exactly one instruction through the interpreter, never a
+         * fused pair, bulk block loop, compiled block or tier. Writes still invalidate the attached code
+         * caches, so step() can carry on from here. For tools which observe every instruction.
+         * @return False if the instruction could not be fetched.
+         */
+        bool step_instruction() noexcept;
+
+        /**
+         * Executes an instruction already fetched from pc and decoded, then advances pc and the cycle
+         * count exactly as step() would. Lets callers which share fetch or decode work drive the cpu.
+         */
+        void dispatch(arm::instruction instr, u32 opcode) noexcept;
+        void dispatch(thumb::instruction instr, u16 opcode) noexcept;
 
         void execute(arm::instruction instr, u32 opcode) noexcept;
         void execute(thumb::instruction instr, u16 opcode) noexcept;
@@ -43,6 +195,8 @@ namespace arm7tdmi {
         void execute_arm_unknown(u32 instr) noexcept;
 
         [[nodiscard]] bool check_condition(u32 instr) const noexcept;
+        // check_condition, counting the instruction in condition_failed when it fails
+        [[nodiscard]] bool condition_passed(u32 instr) noexcept;
 
         void execute_thumb_software_interrupt(u16 instr) noexcept;
         void execute_thumb_unconditional_branch(u16 instr) noexcept;
@@ -66,8 +220,71 @@ namespace arm7tdmi {
         void execute_thumb_unknown(u16 instr) noexcept;
 
     private:
+        void enter_exception(cpu_mode mode, u32 vector, u32 return_address) noexcept;
+
+        // Executes both instructions of a fused pair from the predecode cache, see fused_pair
+        void dispatch_fused(const predecoded_thumb& entry) noexcept;
+
+        // step() with tiers attached, from the IRQ check on
+        bool step_tiered() noexcept;
+        void take_irq() noexcept;
+
+        // Runs a compiled block from pc, opcode is its first instruction's
+        void run_aot(u32 (*function)(aot_context&) noexcept, u32 opcode) noexcept;
+
+        // Data accesses for compiled blocks, cpu is this cpu
+        template <typename T>
+        static bool aot_read(void* cpu, u32 address, T* out) noexcept;
+        template <typename T>
+        static bool aot_write(void* cpu, u32 address, T value) noexcept;
+
+        // Runs the SWI on the host if a handler takes it, otherwise enters the guest's handler
+        void software_interrupt(u32 comment, u32 function, u32 size) noexcept;
+
+        // Runs the hook at pc after a taken branch, if there is one, and returns from it through lr
+        void call_hook() noexcept;
+
+        // Runs a whole copy or fill loop starting at pc, false if the loop at pc isn't one
+        bool execute_block_loop(const predecoded_thumb& head) noexcept;
+
+        // Return a + b and a - b, setting NZCV
+        u32 add_with_flags(u32 a, u32 b) noexcept;
+        u32 subtract_with_flags(u32 a, u32 b) noexcept;
+
+        // Data accesses made by instructions, counted by width when statistics are enabled
+        template <typename T>
+        bool read(u32 address, T* out) noexcept;
+        template <typename T>
+        bool write(u32 address, T value) noexcept;
+
         cpu_state _state = cpu_state::arm;
         memory_interface* _memory = nullptr;
+        coverage* _coverage = nullptr;
+        predecode_cache* _predecode = nullptr;
+        hle_hooks* _hooks = nullptr;
+        const aot_module* _aot = nullptr;
+        tiered_execution* _tiers = nullptr;
+        semihosting* _semihosting = nullptr;
+        bios_calls* _bios = nullptr;
+        u64 _cycles = 0;
+        u32 _opcode = 0;
+        u32 _instruction_end = 0;
+        bool _irq_line = false;
+        u64 _irq_cycle = ~0ull;
+        bool _block_loops = false;
+
+        // Set by instructions which write to pc, so step() knows not to advance it.
+        bool _branched = false;
+
+        // Predecoded block being run by step_tiered() and the index of its next instruction, and the
+        // address execution continues at unless it branches. An odd address starts a new block.
+        const tiered_block* _tier_block = nullptr;
+        u32 _tier_index = 0;
+        u32 _tier_next = 1;
+
+#ifdef ARM7TDMI_STATISTICS
+        cpu_statistics _statistics;
+#endif
 
     };
 }
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <span>
+
 #include <arm7tdmi/common.h>
 
 namespace arm7tdmi {
@@ -32,6 +34,24 @@ namespace arm7tdmi {
 
         instruction decode(u32 opcode) noexcept;
 
+        struct pattern {
+            instruction instr;
+            u32 mask;
+            u32 format;
+        };
+
+        /**
+         * The encodings decode() tests, in the order it tests them. An opcode decodes as the first
+         * pattern where (opcode & mask) == format, or unknown if none match.
+         */
+        std::span<const pattern> patterns() noexcept;
+
+        /**
+         * Decodes min(opcodes.size(), out.size()) opcodes through a lookup table, falling back to
+         * decode() only for the few encodings the table cannot resolve. Same results as decode().
+         */
+        void decode_batch(std::span<const u32> opcodes, std::span<instruction> out) noexcept;
+
     }
 
     namespace thumb {
@@ -63,6 +83,21 @@ namespace arm7tdmi {
 
         instruction decode(u16 opcode) noexcept;
 
+        struct pattern {
+            instruction instr;
+            u16 mask;
+            u16 format;
+        };
+
+        /**
+         * The encodings decode() tests, in the order it tests them.
+         */
+        std::span<const pattern> patterns() noexcept;
+
+        /**
+         * Decodes min(opcodes.size(), out.size()) opcodes through a lookup table on the top byte.
+         */
+        void decode_batch(std::span<const u16> opcodes, std::span<instruction> out) noexcept;
 
     }
 
@@ -0,0 +1,51 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <span>
+
+#include <arm7tdmi/common.h>
+
+namespace arm7tdmi {
+
+    /**
+     * Line size used by the batch disassemblers, including the terminator. Longer lines are truncated.
+     */
+    constexpr size_t disassembly_line_size = 64;
+
+    namespace arm {
+
+        /**
+         * Writes the instruction as assembly, e.g. "ldreq r0, [r1, #4]", into buffer and terminates it.
+         * Never allocates. Branch targets are resolved against the instruction's address.
+         * @return Characters written, excluding the terminator. Truncated to size - 1.
+         */
+        size_t disassemble(u32 opcode, u32 address, char* buffer, size_t size) noexcept;
+
+        /**
+         * Disassembles consecutive opcodes starting at address, line i at out[i * disassembly_line_size].
+         * @return Lines written, min(opcodes.size(), out.size() / disassembly_line_size).
+         */
+        size_t disassemble_batch(std::span<const u32> opcodes, u32 address, std::span<char> out) noexcept;
+
+    }
+
+    namespace thumb {
+
+        /**
+         * Writes the instruction as assembly. The two halves of a long branch with link are written
+         * as "bl.hi" with the partial target they leave in lr, and "bl.lo" with the low offset.
+         */
+        size_t disassemble(u16 opcode, u32 address, char* buffer, size_t size) noexcept;
+
+        /**
+         * Same as arm::disassemble_batch, but a long branch with link prefix followed by its suffix
+         * is written as "bl" with the full target.
+         */
+        size_t disassemble_batch(std::span<const u16> opcodes, u32 address, std::span<char> out) noexcept;
+
+    }
+
+}
@@ -0,0 +1,76 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+
+namespace arm7tdmi {
+
+    class memory_interface;
+
+    struct elf_symbol {
+        std::string name;
+        u32 address = 0;
+        u32 size = 0;
+
+        // Set for THUMB functions, whose symbol value has bit 0 set
+        bool thumb = false;
+    };
+
+    struct elf_segment {
+        u32 address = 0;
+        u32 offset = 0;
+        u32 file_size = 0;
+        u32 memory_size = 0;
+        bool executable = false;
+    };
+
+    /**
+     * Minimal reader for 32 bit little endian ARM ELF executables: loadable segments, the entry point,
+     * and the symbol table for symbolizing guest addresses.
+     */
+    class elf_image final {
+    public:
+        /**
+         * Reads the whole stream.
+         * @return False if the stream is not a 32 bit little endian ARM ELF file, or is truncated.
+         */
+        bool load(std::istream& in) noexcept;
+        bool load(std::vector<u8> data) noexcept;
+
+        [[nodiscard]] u32 entry() const noexcept { return _entry; }
+        [[nodiscard]] const std::vector<elf_segment>& segments() const noexcept { return _segments; }
+
+        /**
+         * Symbols sorted by address. Mapping symbols ($a, $t, $d) and undefined symbols are skipped.
+         */
+        [[nodiscard]] const std::vector<elf_symbol>& symbols() const noexcept { return _symbols; }
+
+        /**
+         * @return The symbol containing the address, or the closest one before it if it has no size.
+         * nullptr if the address is before the first symbol, or past the end of a sized one.
+         */
+        [[nodiscard]] const elf_symbol* find(u32 address) const noexcept;
+
+        /**
+         * Copies every loadable segment into memory, zero filling past the end of the file data.
+         * @return False if a segment does not fit in memory.
+         */
+        bool load_segments(memory_interface& memory) const noexcept;
+
+    private:
+        bool parse() noexcept;
+
+        std::vector<u8> _data;
+        u32 _entry = 0;
+        std::vector<elf_segment> _segments;
+        std::vector<elf_symbol> _symbols;
+    };
+
+}
@@ -0,0 +1,103 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/register.h>
+
+namespace arm7tdmi {
+
+    class cpu;
+    class basic_memory;
+
+    /**
+     * One independent guest program. Every job gets its own cpu and basic_memory, created on the worker
+     * which first runs it.
+     */
+    struct farm_job {
+        u64 memory_size = 0x10000;
+
+        // Loads the program and sets the initial register state
+        std::function<void(cpu&, basic_memory&)> setup;
+
+        // Checked after every instruction, returns true once the guest has finished. May be empty.
+        std::function<bool(const cpu&, const basic_memory&)> done;
+
+        // Optionally inspects the final machine, e.g. to read a result out of guest memory
+        std::function<void(const cpu&, const basic_memory&)> finish;
+
+        u64 max_cycles = std::numeric_limits<u64>::max();
+    };
+
+    enum class farm_status : u8 {
+        completed,
+        cycle_limit,
+        fault
+    };
+
+    struct farm_result {
+        farm_status status = farm_status::fault;
+        cpu_registers registers = {};
+        cpu_state state = cpu_state::arm;
+        u64 cycles = 0;
+
+        // Time slices executed, and how many of them ran on a different worker than the one before
+        u32 slices = 0;
+        u32 migrations = 0;
+
+        // Wall time spent executing this job
+        double seconds = 0.0;
+    };
+
+    struct farm_statistics {
+        u64 cycles = 0;
+        u64 slices = 0;
+        u64 steals = 0;
+        double seconds = 0.0;
+
+        // Cycles per second of wall time across all workers, in millions
+        [[nodiscard]] double mips() const noexcept { return seconds > 0.0 ? static_cast<double>(cycles) / seconds / 1e6 : 0.0; }
+    };
+
+    struct farm_config {
+        // Worker threads, 0 uses every host core
+        u32 threads = 0;
+
+        // Cycles a job runs before it is put back in its worker's queue, where it can be stolen
+        u64 slice = 100000;
+    };
+
+    /**
+     * Runs a batch of independent guest programs across host threads.
+     *
+     * Each worker owns a queue of jobs and runs them a time slice at a time, round robin. A worker
+     * whose queue runs dry steals from the back of another worker's queue, so the load stays balanced
+     * even when job run times differ by orders of magnitude.
+     */
+    class execution_farm final {
+    public:
+        explicit execution_farm(farm_config config = {}) noexcept;
+
+        /**
+         * Runs every job to completion.
+         * @return Per job results, in the same order as the jobs.
+         */
+        std::vector<farm_result> run(const std::vector<farm_job>& jobs) noexcept;
+
+        /**
+         * @return Statistics for the most recent run().
+         */
+        [[nodiscard]] const farm_statistics& statistics() const noexcept { return _statistics; }
+
+    private:
+        farm_config _config;
+        farm_statistics _statistics;
+    };
+
+}
@@ -0,0 +1,95 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+
+namespace arm7tdmi {
+
+    class cpu_registers;
+    class memory_interface;
+    class elf_image;
+
+    /**
+     * Host replacement for a guest function, called at the function's entry with the arguments in
+     * r0-r3. It leaves its results in the registers and returns true, and the cpu then returns through
+     * lr as BX LR would. Returning false runs the guest function instead, e.g. for arguments the
+     * replacement doesn't handle. Memory written by the replacement invalidates predecoded instructions
+     * as the cpu's own writes do.
+     */
+    using hle_function = std::function<bool(cpu_registers&, memory_interface&)>;
+
+    /**
+     * High level emulation hooks, keyed by entry address, or by a signature of the function's first
+     * bytes which resolve() turns into addresses.
+     *
+     * The cpu (cpu::set_hooks) only looks for a hook when a branch is taken, so functions are hooked
+     * when they are called, not when execution falls through into them. A bitmask of hooked address
+     * bits rejects most branch targets before the map is searched.
+     */
+    class hle_hooks final {
+    public:
+        /**
+         * Hooks the function at address. Bit 0, set on THUMB function pointers, is ignored.
+         */
+        void add(u32 address, hle_function function) noexcept;
+
+        /**
+         * Hooks every function whose first size bytes have the given signature(), once resolved.
+         */
+        void add_signature(u64 hash, u32 size, hle_function function) noexcept;
+
+        /**
+         * Hooks the halfword aligned addresses in [begin, end) matching a registered signature.
+         * @return Number of functions hooked.
+         */
+        u32 resolve(const memory_interface& memory, u32 begin, u32 end) noexcept;
+
+        /**
+         * Hooks the function symbols of the image matching a registered signature, the image already
+         * being loaded into memory.
+         * @return Number of functions hooked.
+         */
+        u32 resolve(const memory_interface& memory, const elf_image& image) noexcept;
+
+        /**
+         * 64 bit FNV-1a hash of the size bytes at address.
+         * @return False if any of them could not be read.
+         */
+        static bool signature(const memory_interface& memory, u32 address, u32 size, u64* out) noexcept;
+
+        void remove(u32 address) noexcept;
+        void clear() noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return _hooks.size(); }
+
+        [[nodiscard]] const hle_function* find(const u32 address) const noexcept {
+            if (((_filter >> ((address >> 1) & 63u)) & 1u) == 0) {
+                return nullptr;
+            }
+            const auto it = _hooks.find(address & ~1u);
+            return it != _hooks.end() ? &it->second : nullptr;
+        }
+
+    private:
+        struct pattern {
+            u64 hash;
+            u32 size;
+            hle_function function;
+        };
+
+        bool resolve_at(const memory_interface& memory, u32 address) noexcept;
+        void rebuild_filter() noexcept;
+
+        u64 _filter = 0;
+        std::unordered_map<u32, hle_function> _hooks;
+        std::vector<pattern> _signatures;
+    };
+
+}
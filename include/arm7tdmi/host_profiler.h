@@ -0,0 +1,94 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <ostream>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/decoder.h>
+
+namespace arm7tdmi {
+
+    class cpu;
+    class memory_interface;
+
+    enum class host_counter_source : u8 {
+        // Hardware counters through perf_event_open (Linux)
+        perf_event,
+        // Time stamp counter, or steady_clock where there is none. Only cycles are available.
+        timestamp
+    };
+
+    struct host_cost {
+        u64 count = 0;
+        u64 cycles = 0;
+        u64 branch_misses = 0;
+        u64 cache_misses = 0;
+    };
+
+    /**
+     * Host counters read as a group: cycles, branch misses and cache misses.
+     */
+    class host_counters final {
+    public:
+        host_counters() noexcept;
+        ~host_counters() noexcept;
+
+        host_counters(const host_counters&) = delete;
+        host_counters& operator=(const host_counters&) = delete;
+
+        [[nodiscard]] host_counter_source source() const noexcept { return _source; }
+
+        void read(host_cost* out) const noexcept;
+
+    private:
+        host_counter_source _source = host_counter_source::timestamp;
+        int _fds[3] = {-1, -1, -1};
+    };
+
+    /**
+     * Attributes host cost to guest instruction classes, by reading the host counters around the
+     * dispatch of every guest instruction.
+     *
+     * Each reading costs far more than most handlers, so the mean cost of an empty reading is measured
+     * up front and subtracted. Results are for comparing classes against each other, not absolute.
+     */
+    class host_profiler final {
+    public:
+        explicit host_profiler(memory_interface* memory) noexcept;
+
+        [[nodiscard]] host_counter_source source() const noexcept { return _counters.source(); }
+
+        /**
+         * Fetches and decodes the instruction at pc, and dispatches it between two counter readings.
+         * Steps that enter an exception are executed without being attributed.
+         * @return False if the instruction could not be fetched.
+         */
+        bool step(cpu& cpu) noexcept;
+
+        void clear() noexcept;
+
+        [[nodiscard]] const host_cost& cost(const arm::instruction instr) const noexcept { return _arm[static_cast<size_t>(instr)]; }
+        [[nodiscard]] const host_cost& cost(const thumb::instruction instr) const noexcept { return _thumb[static_cast<size_t>(instr)]; }
+
+        /**
+         * Writes a table of executed classes, with count and mean host cost per instruction.
+         */
+        void write_report(std::ostream& out) const noexcept;
+
+    private:
+        void calibrate() noexcept;
+        void accumulate(host_cost& cost, const host_cost& before, const host_cost& after) const noexcept;
+
+        memory_interface* _memory = nullptr;
+        host_counters _counters;
+        host_cost _overhead;
+
+        std::array<host_cost, static_cast<size_t>(arm::instruction::unknown) + 1> _arm = {};
+        std::array<host_cost, static_cast<size_t>(thumb::instruction::unknown) + 1> _thumb = {};
+    };
+
+}
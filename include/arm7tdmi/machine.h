@@ -0,0 +1,100 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    enum class machine_mode : u8 {
+        // Cores take turns running a quantum each on the calling thread
+        interleaved,
+        // Every core runs on its own host thread, synchronising at quantum boundaries
+        parallel
+    };
+
+    struct machine_config {
+        u32 cores = 2;
+        u64 quantum = 1000;
+        machine_mode mode = machine_mode::interleaved;
+    };
+
+    /**
+     * Several cpus sharing one memory bus.
+     *
+     * Each core sees its own writes immediately, but writes only become visible to the other cores at
+     * the end of the quantum they were made in, applied in core index order. Both modes therefore
+     * produce identical results, and the parallel mode needs no synchronisation inside a quantum.
+     * The shared memory must support concurrent reads.
+     */
+    class machine final {
+    public:
+        machine(memory_interface* memory, machine_config config) noexcept;
+        ~machine() noexcept;
+
+        machine(const machine&) = delete;
+        machine& operator=(const machine&) = delete;
+
+        [[nodiscard]] u32 core_count() const noexcept { return static_cast<u32>(_cores.size()); }
+        [[nodiscard]] cpu& core(const u32 index) noexcept { return _cores[index]->core; }
+        [[nodiscard]] const cpu& core(const u32 index) const noexcept { return _cores[index]->core; }
+
+        /**
+         * @return True if the core has stopped, because an instruction could not be fetched.
+         */
+        [[nodiscard]] bool halted(const u32 index) const noexcept { return _cores[index]->halted; }
+
+        /**
+         * Runs every core for the given number of quanta.
+         */
+        void run(u64 quanta) noexcept;
+
+        [[nodiscard]] u64 quanta() const noexcept { return _quanta; }
+        [[nodiscard]] const machine_config& config() const noexcept { return _config; }
+
+    private:
+        // Per core view of the shared memory, holding the writes made during the current quantum
+        class core_bus final : public memory_interface {
+        public:
+            explicit core_bus(memory_interface* memory) noexcept : _memory(memory) {}
+
+            [[nodiscard]] u64 size() const noexcept override { return _memory->size(); }
+
+            void commit() noexcept;
+
+        protected:
+            [[nodiscard]] bool read_byte(u32 address, u8* out) const noexcept override;
+            bool write_byte(size_t address, u8 value) noexcept override;
+
+        private:
+            memory_interface* _memory = nullptr;
+            std::unordered_map<u32, u8> _pending;
+            std::vector<u32> _order;
+        };
+
+        struct core_state {
+            explicit core_state(memory_interface* memory) noexcept : bus(memory), core(&bus) {}
+
+            core_bus bus;
+            cpu core;
+            bool halted = false;
+        };
+
+        void run_quantum(core_state& state) const noexcept;
+        void commit() noexcept;
+
+        memory_interface* _memory = nullptr;
+        machine_config _config;
+        std::vector<std::unique_ptr<core_state>> _cores;
+        u64 _quanta = 0;
+    };
+
+}
@@ -3,8 +3,10 @@
 //
 
 #pragma once
+#include <bit>
 #include <limits>
 #include <type_traits>
+#include <vector>
 
 #include <arm7tdmi/common.h>
 
@@ -45,6 +47,14 @@ namespace arm7tdmi {
          */
         [[nodiscard]] virtual u64 size() const noexcept = 0;
 
+        /**
+         * Host pointer to [address, address + size) for bulk accesses, or nullptr if any of it has to go
+         * through read/write (out of range, MMIO, or accesses being observed). The default is nullptr.
+         * direct_write counts the whole range as written.
+         */
+        [[nodiscard]] virtual const u8* direct_read(u32 /*address*/, u64 /*size*/) const noexcept { return nullptr; }
+        [[nodiscard]] virtual u8* direct_write(u32 /*address*/, u64 /*size*/) noexcept { return nullptr; }
+
     protected:
     	[[nodiscard]] virtual bool read_byte(u32 address, u8* out) const noexcept = 0;
     	virtual bool write_byte(size_t address, u8 value) noexcept = 0;
@@ -52,10 +62,48 @@ namespace arm7tdmi {
 
 	class basic_memory final : public memory_interface {
     public:
+		/** Granularity of dirty tracking, in bytes. */
+		static constexpr u32 page_size = 0x1000;
+
 		explicit basic_memory(u64 size) noexcept;
 		~basic_memory() noexcept override;
 
-		[[nodiscard]] u32 size() const noexcept override;
+		basic_memory(const basic_memory&) = delete;
+		basic_memory& operator=(const basic_memory&) = delete;
+
+		[[nodiscard]] u64 size() const noexcept override;
+
+		[[nodiscard]] const u8* direct_read(u32 address, u64 size) const noexcept override;
+		[[nodiscard]] u8* direct_write(u32 address, u64 size) noexcept override;
+
+		/**
+		 * Raw access to the backing store. Writes made through this pointer are not dirty tracked.
+		 */
+		[[nodiscard]] u8* data() noexcept { return _memory; }
+		[[nodiscard]] const u8* data() const noexcept { return _memory; }
+
+		[[nodiscard]] u32 page_count() const noexcept { return static_cast<u32>((_size + page_size - 1) / page_size); }
+
+		/**
+		 * @return True if the page has been written to since the last call to clear_dirty_pages().
+		 */
+		[[nodiscard]] bool page_dirty(u32 page) const noexcept {
+			return (_dirty_pages[page / 64] >> (page % 64)) & 1u;
+		}
+		void mark_page_dirty(u32 page) noexcept { _dirty_pages[page / 64] |= u64{1} << (page % 64); }
+		void clear_dirty_pages() noexcept;
+
+		/**
+		 * Calls visit(page) for every dirty page, skipping 64 clean pages at a time.
+		 */
+		template <typename Visit>
+		void for_each_dirty_page(Visit visit) const noexcept {
+			for (size_t word = 0; word < _dirty_pages.size(); ++word) {
+				for (u64 bits = _dirty_pages[word]; bits != 0; bits &= bits - 1) {
+					visit(static_cast<u32>(word * 64 + std::countr_zero(bits)));
+				}
+			}
+		}
 
 	protected:
 		[[nodiscard]] bool read_byte(u32 address, u8* out) const noexcept override;
@@ -64,6 +112,7 @@ namespace arm7tdmi {
 	private:
 		u8* _memory = nullptr;
 	    u64 _size = 0;
+		std::vector<u64> _dirty_pages;
     };
 
 	template <typename T, AlignmentType Alignment>
@@ -80,7 +129,7 @@ namespace arm7tdmi {
 
 		if constexpr (Alignment == AlignmentType::Force) {
 			// Force alignment by rounding down the address
-			aligned_address = address & ~3;  // Mask lower 2 bits to align to 4-byte boundary
+			aligned_address = address & ~(sizeof(T) - 1);  // Mask lower bits to align to the access size
 		}
 		else if constexpr (Alignment == AlignmentType::Rotate) {
 			// Calculate rotation based on misalignment
@@ -94,8 +143,10 @@ namespace arm7tdmi {
 			success &= read_byte(aligned_address + i, &byte_read);  // Read the byte from memory
 
 			// If rotating, apply the rotation on the first byte
-			if constexpr (Alignment == AlignmentType::Rotate && i == 0 && rotation != 0) {
-				byte_read = (byte_read << rotation) | (byte_read >> (8 - rotation));  // Rotate the byte
+			if constexpr (Alignment == AlignmentType::Rotate) {
+				if (i == 0 && rotation != 0) {
+					byte_read = (byte_read << rotation) | (byte_read >> (8 - rotation));  // Rotate the byte
+				}
 			}
 
 			// Combine the byte into the value
@@ -117,7 +168,7 @@ namespace arm7tdmi {
         // TODO(Thomas): I'm not sure this alignment works or not
 		if constexpr (Alignment == AlignmentType::Force) {
 			// Force alignment by rounding down the address
-			aligned_address = address & ~0x3;  // Mask lower 2 bits to align to 4-byte boundary
+			aligned_address = address & ~(sizeof(T) - 1);  // Mask lower bits to align to the access size
 		}
 		else if constexpr (Alignment == AlignmentType::Rotate) {
 			// Calculate rotation based on misalignment
@@ -130,8 +181,10 @@ namespace arm7tdmi {
 			u8 byte_to_write = static_cast<u8>((value >> (i * 8)) & 0xFF);
 
 			// If rotating, apply the rotation on the first byte
-			if constexpr (Alignment == AlignmentType::Rotate && i == 0 && rotation != 0) {
-				byte_to_write = (byte_to_write >> rotation) | (byte_to_write << (8 - rotation));
+			if constexpr (Alignment == AlignmentType::Rotate) {
+				if (i == 0 && rotation != 0) {
+					byte_to_write = (byte_to_write >> rotation) | (byte_to_write << (8 - rotation));
+				}
 			}
 
 			// Write the byte to memory at the aligned address
@@ -0,0 +1,149 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <fstream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    class cpu;
+
+    struct memory_log_access {
+        u64 cycle = 0;
+        u32 pc = 0;
+        u32 address = 0;
+        u32 value = 0;
+        u8 size = 0;
+        bool write = false;
+        // Read by the attached cpu to fetch the instruction at pc
+        bool fetch = false;
+    };
+
+    /**
+     * A chunk of the log, one array per field. Chunk headers carry the cycle and address ranges, so
+     * queries skip chunks which can't match without reading their columns.
+     */
+    struct memory_log_chunk {
+        u64 first_cycle = 0;
+        u64 last_cycle = 0;
+        u32 lowest_address = 0;
+        u32 highest_address = 0;
+
+        std::vector<u64> cycles;
+        std::vector<u32> pcs;
+        std::vector<u32> addresses;
+        std::vector<u32> values;
+        // Access width in bytes, with bit 7 set for writes and bit 6 for fetches
+        std::vector<u8> kinds;
+
+        [[nodiscard]] size_t size() const noexcept { return cycles.size(); }
+        [[nodiscard]] memory_log_access operator[](size_t row) const noexcept;
+
+        void push_back(const memory_log_access& access) noexcept;
+        void clear() noexcept;
+    };
+
+    /**
+     * Memory bus which logs every access through it, instruction fetches included, to a columnar file.
+     * Accesses are timestamped with the cycle and pc of the attached cpu. Multi-byte accesses arrive a
+     * byte at a time, and are merged back together, fetches only with fetches.
+     */
+    class memory_log_recorder final : public memory_interface {
+    public:
+        // Rows per chunk
+        static constexpr size_t chunk_rows = 64 * 1024;
+
+        memory_log_recorder(memory_interface* memory, std::ostream& out) noexcept;
+        ~memory_log_recorder() noexcept override;
+
+        memory_log_recorder(const memory_log_recorder&) = delete;
+        memory_log_recorder& operator=(const memory_log_recorder&) = delete;
+
+        void attach(const cpu* cpu) noexcept { _cpu = cpu; }
+
+        /**
+         * Writes every buffered access.
+         */
+        void flush() noexcept;
+
+        [[nodiscard]] u64 size() const noexcept override { return _memory->size(); }
+
+    protected:
+        [[nodiscard]] bool read_byte(u32 address, u8* out) const noexcept override;
+        bool write_byte(size_t address, u8 value) noexcept override;
+
+    private:
+        void log(u32 address, u8 value, bool write, bool fetch) const noexcept;
+        void close_access() const noexcept;
+        void write_chunk() const noexcept;
+
+        memory_interface* _memory = nullptr;
+        const cpu* _cpu = nullptr;
+        std::ostream& _out;
+
+        mutable memory_log_access _open;
+        mutable bool _has_open = false;
+        mutable memory_log_chunk _chunk;
+    };
+
+    /**
+     * Reads a memory log and answers queries by scanning its chunks in parallel, each worker thread
+     * with its own file handle.
+     */
+    class memory_log_reader final {
+    public:
+        /**
+         * Indexes the chunks in the file.
+         * @return False if the file can't be opened, or is not a memory log.
+         */
+        bool open(const std::string& path) noexcept;
+
+        [[nodiscard]] size_t chunks() const noexcept { return _chunks.size(); }
+        [[nodiscard]] u64 rows() const noexcept { return _rows; }
+
+        bool read_chunk(std::ifstream& in, size_t index, memory_log_chunk* out) const noexcept;
+
+        /**
+         * @return Every write overlapping [begin, end), in cycle order.
+         */
+        [[nodiscard]] std::vector<memory_log_access> writes_in_range(u32 begin, u32 end, u32 threads = 0) const noexcept;
+
+        /**
+         * @return The count most accessed 64 byte lines, as (line address, accesses), most accessed first.
+         */
+        [[nodiscard]] std::vector<std::pair<u32, u64>> hottest_lines(size_t count, u32 threads = 0) const noexcept;
+
+        /**
+         * @return The earliest write covering the address.
+         */
+        [[nodiscard]] std::optional<memory_log_access> first_writer(u32 address, u32 threads = 0) const noexcept;
+
+    private:
+        struct chunk_index {
+            std::streamoff offset;
+            u32 rows;
+            u64 first_cycle;
+            u64 last_cycle;
+            u32 lowest_address;
+            u32 highest_address;
+        };
+
+        template <typename Visit>
+        void scan(u32 threads, Visit visit) const noexcept;
+
+        std::string _path;
+        std::vector<chunk_index> _chunks;
+        u64 _rows = 0;
+    };
+
+}
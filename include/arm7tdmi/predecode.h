@@ -0,0 +1,144 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/decoder.h>
+
+namespace arm7tdmi {
+
+    class memory_interface;
+    class elf_image;
+
+    struct predecoded_arm {
+        u32 opcode = 0;
+        arm::instruction instr = arm::instruction::unknown;
+        bool valid = false;
+    };
+
+    /**
+     * THUMB instruction pairs common enough in compiled code to execute as one operation.
+     */
+    enum class fused_pair : u8 {
+        none,
+        // Long branch with link prefix, then its suffix
+        branch_with_link,
+        // CMP Rd, #imm, then a conditional branch
+        compare_branch,
+        // MOV Rd, #imm, then ADD Rd, #imm to the same register
+        move_add
+    };
+
+    struct predecoded_thumb {
+        u16 opcode = 0;
+        thumb::instruction instr = thumb::instruction::unknown;
+        bool valid = false;
+        // Set when this instruction and the next form a pair, next is the second opcode
+        fused_pair fusion = fused_pair::none;
+        u16 next = 0;
+    };
+
+    /**
+     * Decoded instructions for one contiguous region of guest code.
+     *
+     * fill() decodes the whole region up front on every host core, both as ARM and as THUMB since
+     * which state the code runs in is not known until it runs. A cpu with the cache attached
+     * (cpu::set_predecode) executes from it instead of fetching and decoding, so code is as fast on
+     * its first execution as in steady state. Entries missing from the cache are decoded on first
+     * execution and kept.
+     *
+     * Writes made by the cpu invalidate the entries they overlap. Anything else writing to the region
+     * (the host, another core) must call invalidate() or fill() afterwards. Fetches from the cache do
+     * not go through the memory interface, so memory wrappers which observe fetches will not see them.
+     *
+     * With fusion enabled, THUMB entries which start a fused_pair execute both instructions in a
+     * single step(). Entering the second instruction directly, by a branch or an exception return,
+     * executes it on its own. The host cannot change the IRQ line between the two instructions of a
+     * pair, so leave fusion off when interrupt timing has to be instruction exact.
+     */
+    class predecode_cache final {
+    public:
+        // Largest region covered, entries take about 9 bytes per byte of code
+        static constexpr u32 max_size = 32u << 20;
+
+        /**
+         * Regions larger than max_size are rejected, leaving the cache empty.
+         */
+        predecode_cache(u32 base, u32 size) noexcept;
+
+        /**
+         * Covers every executable segment of the image, or every loadable segment if none are marked
+         * executable. If they span more than max_size, covers the largest one alone, and if that is
+         * still larger, nothing.
+         */
+        explicit predecode_cache(const elf_image& image) noexcept;
+
+        [[nodiscard]] u32 base() const noexcept { return _base; }
+        [[nodiscard]] u32 size() const noexcept { return _size; }
+
+        /**
+         * Recognises fused pairs from the next fill() or store() on. Off by default.
+         */
+        void set_fusion(const bool enabled) noexcept { _fusion = enabled; }
+        [[nodiscard]] bool fusion() const noexcept { return _fusion; }
+
+        /**
+         * Decodes the whole region from memory, in chunks spread over the given number of threads
+         * (0 uses every host core). Memory must not be written while this runs.
+         */
+        void fill(const memory_interface& memory, u32 threads = 0) noexcept;
+
+        /**
+         * Drops the entries overlapping [address, address + size).
+         */
+        void invalidate(const u32 address, const u32 size) noexcept {
+            if (address < static_cast<u64>(_base) + _size && static_cast<u64>(address) + size > _base) {
+                invalidate_range(address, size);
+            }
+        }
+
+        void clear() noexcept;
+
+        /**
+         * @return The entry for the instruction at address, or nullptr if it is outside the region or not decoded.
+         */
+        [[nodiscard]] const predecoded_arm* find_arm(const u32 address) const noexcept {
+            const u32 offset = address - _base;
+            if (offset >= _size) {
+                return nullptr;
+            }
+            const auto& entry = _arm[offset / sizeof(u32)];
+            return entry.valid ? &entry : nullptr;
+        }
+
+        [[nodiscard]] const predecoded_thumb* find_thumb(const u32 address) const noexcept {
+            const u32 offset = address - _base;
+            if (offset >= _size) {
+                return nullptr;
+            }
+            const auto& entry = _thumb[offset / sizeof(u16)];
+            return entry.valid ? &entry : nullptr;
+        }
+
+        /**
+         * Keeps an instruction decoded outside the cache, ignored if the address is outside the region.
+         */
+        void store(u32 address, u32 opcode, arm::instruction instr) noexcept;
+        void store(u32 address, u16 opcode, thumb::instruction instr) noexcept;
+
+    private:
+        void reset(u32 base, u32 size) noexcept;
+        void invalidate_range(u32 address, u32 size) noexcept;
+
+        u32 _base = 0;
+        u32 _size = 0;
+        bool _fusion = false;
+        std::vector<predecoded_arm> _arm;
+        std::vector<predecoded_thumb> _thumb;
+    };
+
+}
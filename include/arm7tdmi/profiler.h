@@ -0,0 +1,74 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+
+namespace arm7tdmi {
+
+    class cpu;
+    class elf_image;
+
+    /**
+     * Samples the guest pc every period cycles, attributing each sample to a call stack.
+     *
+     * The call stack is a shadow stack kept alongside the guest's own. A taken branch which leaves LR
+     * pointing just past itself (BL, THUMB BL, or MOV LR, PC followed by BX) pushes a frame, even at the
+     * end of a fused pair or compiled block (cpu::get_instruction_end), and any other
+     * branch to the return address of a frame on the stack (BX LR, POP {PC}, LDM with PC, SUBS PC, LR, #4)
+     * pops back to it. IRQ entry pushes a frame which returns to the interrupted instruction.
+     */
+    class profiler final {
+    public:
+        explicit profiler(u64 period) noexcept;
+
+        /**
+         * Takes a sample if one is due, then steps the cpu and tracks calls and returns.
+         * @return The result of cpu::step().
+         */
+        bool step(cpu& cpu) noexcept;
+
+        /**
+         * Drops every sample and the shadow stack.
+         */
+        void clear() noexcept;
+
+        [[nodiscard]] u64 samples() const noexcept { return _samples; }
+
+        /**
+         * @return Entry addresses of the functions on the shadow stack, outermost first.
+         */
+        [[nodiscard]] std::vector<u32> call_stack() const noexcept;
+
+        /**
+         * Writes the samples in folded stack format ("outer;inner count" per line), the input of
+         * flamegraph.pl and speedscope. Frames are named after the symbols containing them when
+         * symbols are given, otherwise after their entry address.
+         */
+        void write_folded(std::ostream& out, const elf_image* symbols = nullptr) const noexcept;
+
+    private:
+        struct frame {
+            u32 entry;
+            u32 return_address;
+        };
+
+        void sample(u32 pc) noexcept;
+
+        u64 _period;
+        u64 _next_sample = 0;
+        u64 _samples = 0;
+        std::vector<frame> _stack;
+
+        // Keyed by the frame entries, then the sampled pc
+        std::vector<u32> _key;
+        std::map<std::vector<u32>, u64> _counts;
+    };
+
+}
@@ -0,0 +1,185 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    class cpu;
+
+    enum class input_event : u8 {
+        irq_line = 0,
+        mmio_read = 1
+    };
+
+    /**
+     * A single nondeterministic input to the core, and the cycle at which it happened.
+     */
+    struct input_record {
+        input_event event = input_event::irq_line;
+        u64 cycle = 0;
+        u32 address = 0;
+        u8 value = 0;
+    };
+
+    /**
+     * Appends input records to a stream. Records are varint and delta encoded against the previous
+     * record, and buffered so recording costs little more than a few stores per input.
+     */
+    class input_log_writer final {
+    public:
+        explicit input_log_writer(std::ostream& out) noexcept;
+        ~input_log_writer() noexcept;
+
+        input_log_writer(const input_log_writer&) = delete;
+        input_log_writer& operator=(const input_log_writer&) = delete;
+
+        void write(const input_record& record) noexcept;
+        void flush() noexcept;
+
+    private:
+        std::ostream& _out;
+        std::vector<u8> _buffer;
+        u64 _last_cycle = 0;
+        u32 _last_address = 0;
+    };
+
+    class input_log_reader final {
+    public:
+        explicit input_log_reader(std::istream& in) noexcept;
+
+        /**
+         * @return False if the stream does not start with a valid input log header.
+         */
+        [[nodiscard]] bool valid() const noexcept { return _valid; }
+
+        /**
+         * Reads the next record.
+         * @return False at the end of the log.
+         */
+        bool next(input_record* out) noexcept;
+
+    private:
+        bool read_varint(u64* out) noexcept;
+
+        std::istream& _in;
+        bool _valid = false;
+        u64 _last_cycle = 0;
+        u32 _last_address = 0;
+    };
+
+    /**
+     * Set of MMIO address ranges, merged and sorted for lookup on the bus path. A bitmap of the 64 KiB
+     * pages the ranges touch rejects most addresses, fetches from code included, with one bit test.
+     */
+    class mmio_ranges final {
+    public:
+        void add(u32 begin, u32 end) noexcept;
+
+        [[nodiscard]] bool contains(const u32 address) const noexcept {
+            return ((_pages[address >> (page_bits + 6)] >> ((address >> page_bits) & 63)) & 1u) && find(address);
+        }
+
+    private:
+        static constexpr u32 page_bits = 16;
+
+        struct range { u32 begin; u32 end; };
+
+        [[nodiscard]] bool find(u32 address) const noexcept;
+
+        std::vector<range> _ranges;
+        std::array<u64, (1ull << (32 - page_bits)) / 64> _pages = {};
+    };
+
+    /**
+     * Memory bus which forwards to another memory interface, recording every byte read from the
+     * registered MMIO ranges and every change made to the IRQ line through it.
+     */
+    class input_recorder final : public memory_interface {
+    public:
+        input_recorder(memory_interface* memory, std::ostream& out) noexcept;
+
+        /**
+         * Sets the cpu whose cycle counter timestamps the log.
+         */
+        void attach(const cpu* cpu) noexcept { _cpu = cpu; }
+
+        /**
+         * Registers [begin, end) as host-backed device memory, whose reads are logged. Instruction
+         * fetches by the attached cpu are not inputs, and are never logged.
+         */
+        void add_mmio_range(const u32 begin, const u32 end) noexcept { _mmio.add(begin, end); }
+
+        void set_irq_line(cpu& cpu, bool asserted) noexcept;
+
+        void flush() noexcept { _log.flush(); }
+
+        [[nodiscard]] u64 size() const noexcept override { return _memory->size(); }
+
+    protected:
+        [[nodiscard]] bool read_byte(u32 address, u8* out) const noexcept override;
+        bool write_byte(size_t address, u8 value) noexcept override;
+
+    private:
+        memory_interface* _memory = nullptr;
+        const cpu* _cpu = nullptr;
+        mmio_ranges _mmio;
+        mutable input_log_writer _log;
+    };
+
+    /**
+     * Memory bus which replays a recorded input log. Reads from the registered MMIO ranges return the
+     * logged values without touching the underlying memory, and sync() drives the IRQ line, so a run
+     * is reproduced bit-exactly without the host devices that produced it.
+     */
+    class input_replayer final : public memory_interface {
+    public:
+        input_replayer(memory_interface* memory, std::istream& in) noexcept;
+
+        [[nodiscard]] bool valid() const noexcept { return _log.valid(); }
+
+        void add_mmio_range(const u32 begin, const u32 end) noexcept { _mmio.add(begin, end); }
+
+        /**
+         * Applies logged IRQ line changes which are due. Call before every cpu::step().
+         */
+        void sync(cpu& cpu) noexcept;
+
+        /**
+         * @return True once the run has stopped matching the log, e.g. an MMIO read at an address or cycle that was never recorded.
+         */
+        [[nodiscard]] bool diverged() const noexcept { return _diverged; }
+
+        /**
+         * @return True once every record in the log has been consumed.
+         */
+        [[nodiscard]] bool finished() const noexcept { return !_has_next; }
+
+        [[nodiscard]] u64 size() const noexcept override { return _memory->size(); }
+
+    protected:
+        [[nodiscard]] bool read_byte(u32 address, u8* out) const noexcept override;
+        bool write_byte(size_t address, u8 value) noexcept override;
+
+    private:
+        void advance() const noexcept;
+
+        memory_interface* _memory = nullptr;
+        const cpu* _cpu = nullptr;
+        mmio_ranges _mmio;
+        mutable input_log_reader _log;
+        mutable input_record _next;
+        mutable bool _has_next = false;
+        mutable bool _diverged = false;
+    };
+
+}
@@ -0,0 +1,106 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/cpu.h>
+
+namespace arm7tdmi {
+
+    class basic_memory;
+
+    struct rewind_config {
+        // Cycles between snapshots. May be raised at runtime to keep within max_overhead.
+        u64 interval = 100000;
+
+        // Upper bound, in bytes, for the snapshot ring. The oldest snapshots are dropped first.
+        u64 budget = 32 * 1024 * 1024;
+
+        // Largest fraction of wall time that may be spent taking snapshots.
+        double max_overhead = 0.05;
+    };
+
+    /**
+     * Bounded ring of periodic machine snapshots, used to step execution backwards.
+     *
+     * Registers, the IRQ line and the scheduled IRQ are stored in full. Memory is stored as the XOR of
+     * each page dirtied since the previous snapshot against its previous contents, run-length encoded,
+     * so unchanged bytes cost almost nothing. Restoring walks the deltas back from the newest snapshot, then replays
+     * forward to the requested cycle.
+     */
+    class rewind_buffer final {
+    public:
+        explicit rewind_buffer(basic_memory* memory, rewind_config config = {}) noexcept;
+
+        /**
+         * Takes a snapshot if the snapshot interval has elapsed. Intended to be called after every cpu::step().
+         */
+        void tick(const cpu& cpu) noexcept {
+            if (cpu.get_cycles() >= _next_capture) {
+                capture(cpu);
+            }
+        }
+
+        void capture(const cpu& cpu) noexcept;
+
+        /**
+         * Restores the newest snapshot taken at or before the given cycle, discarding any newer ones,
+         * then steps the cpu forward until it reaches the cycle. The IRQ line and scheduled IRQ are
+         * restored with the snapshot, the line is held while stepping, and host handlers attached to
+         * the cpu (hooks, semihosting) run again for the instructions stepped.
+         * @return False if no snapshot is old enough.
+         */
+        bool restore(cpu& cpu, u64 cycle) noexcept;
+
+        /**
+         * Steps the cpu backwards by the given number of cycles.
+         */
+        bool step_back(cpu& cpu, u64 cycles = 1) noexcept;
+
+        void clear() noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return _snapshots.size(); }
+        [[nodiscard]] u64 memory_usage() const noexcept { return _usage; }
+        [[nodiscard]] u64 interval() const noexcept { return _interval; }
+        [[nodiscard]] u64 oldest_cycle() const noexcept;
+
+    private:
+        struct snapshot {
+            cpu_registers registers;
+            cpu_state state;
+            bool irq_line;
+            u64 irq_cycle;
+            u64 cycles;
+
+            // Per dirtied page: page index, then (zero run, literal length, literals...) until the page is covered.
+            std::vector<u8> delta;
+        };
+
+        static u64 snapshot_cost(const snapshot& snap) noexcept { return sizeof(snapshot) + snap.delta.capacity(); }
+
+        void encode_page(u32 page, std::vector<u8>& out) noexcept;
+        void apply_delta(const std::vector<u8>& delta) noexcept;
+        void revert_uncaptured() noexcept;
+        void enforce_budget() noexcept;
+
+        basic_memory* _memory = nullptr;
+        rewind_config _config;
+        u64 _interval = 0;
+        u64 _next_capture = 0;
+        u64 _usage = 0;
+
+        // Memory contents as of the newest snapshot
+        std::vector<u8> _base;
+        std::deque<snapshot> _snapshots;
+
+        // End of the previous capture, used to measure capture cost against run time
+        std::chrono::steady_clock::time_point _last_capture_end = {};
+    };
+
+}
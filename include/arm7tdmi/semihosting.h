@@ -0,0 +1,91 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+
+namespace arm7tdmi {
+
+    class cpu_registers;
+    class memory_interface;
+
+    /**
+     * ARM semihosting, SWI 0x123456 in ARM state and SWI 0xAB in THUMB state, executed on the host
+     * (cpu::set_semihosting) instead of entering the guest's SWI handler.
+     *
+     * The operation number is in r0 and its parameter block at r1, the result is returned in r0.
+     * Console operations and files opened as ":tt" use the given streams. Other files are opened
+     * relative to the root directory, and paths which would leave it fail. SYS_SYSTEM, SYS_TMPNAM and
+     * unknown operations return -1.
+     *
+     * SYS_EXIT sets exited(), the host should stop stepping the cpu once it is set.
+     */
+    class semihosting final {
+    public:
+        static constexpr u32 arm_swi = 0x123456;
+        static constexpr u32 thumb_swi = 0xab;
+
+        explicit semihosting(std::filesystem::path root, std::ostream& out = std::cout, std::istream& in = std::cin) noexcept;
+        ~semihosting() noexcept;
+
+        semihosting(const semihosting&) = delete;
+        semihosting& operator=(const semihosting&) = delete;
+
+        /**
+         * Executes the operation in r0.
+         */
+        void call(cpu_registers& registers, memory_interface& memory) noexcept;
+
+        /**
+         * Returned to the guest by SYS_GET_CMDLINE.
+         */
+        void set_command_line(std::string command_line) noexcept { _command_line = std::move(command_line); }
+
+        [[nodiscard]] bool exited() const noexcept { return _exited; }
+
+        /**
+         * 0 after SYS_EXIT with ADP_Stopped_ApplicationExit, the code given to SYS_EXIT_EXTENDED, or
+         * otherwise the reason code.
+         */
+        [[nodiscard]] u32 exit_code() const noexcept { return _exit_code; }
+
+    private:
+        enum class stream : u8 {
+            none,
+            input,
+            output
+        };
+
+        // Handles are indices into _files plus one. Console files have no host handle.
+        struct file {
+            std::FILE* handle = nullptr;
+            stream console = stream::none;
+            bool open = false;
+        };
+
+        u32 open(const std::string& name, u32 mode) noexcept;
+        u32 close(u32 handle) noexcept;
+        u32 write(u32 handle, u32 buffer, u32 length, const memory_interface& memory) noexcept;
+        u32 read(u32 handle, u32 buffer, u32 length, memory_interface& memory) noexcept;
+        file* find(u32 handle) noexcept;
+        bool host_path(const std::string& name, std::filesystem::path* out) const noexcept;
+
+        std::filesystem::path _root;
+        std::ostream& _out;
+        std::istream& _in;
+        std::vector<file> _files;
+        std::string _command_line;
+        u32 _errno = 0;
+        bool _exited = false;
+        u32 _exit_code = 0;
+    };
+
+}
@@ -0,0 +1,50 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/decoder.h>
+
+// Counters are only compiled in when the library is built with ARM7TDMI_STATISTICS (CMake option of the
+// same name). Otherwise every ARM7TDMI_STATISTIC expands to nothing, and cpu has no statistics member.
+#ifdef ARM7TDMI_STATISTICS
+#define ARM7TDMI_STATISTIC(counter) (++(counter))
+#else
+#define ARM7TDMI_STATISTIC(counter) ((void)0)
+#endif
+
+namespace arm7tdmi {
+
+    struct cpu_statistics {
+        // Executions per instruction class, including ones whose condition failed
+        std::array<u64, static_cast<size_t>(arm::instruction::unknown) + 1> arm = {};
+        std::array<u64, static_cast<size_t>(thumb::instruction::unknown) + 1> thumb = {};
+
+        // ARM instructions, and THUMB conditional branches, skipped because their condition failed
+        u64 condition_failed = 0;
+
+        // Switches between ARM and THUMB state, by BX or exception entry
+        u64 state_switches = 0;
+
+        // Guest functions and SWIs run by host functions (hle_hooks, semihosting, bios_calls)
+        u64 hooks = 0;
+
+        // Data accesses by width, indexed by access_width<T>(). Instruction fetches are not counted.
+        std::array<u64, 3> reads = {};
+        std::array<u64, 3> writes = {};
+
+        template <typename T>
+        static constexpr size_t access_width() noexcept {
+            static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4);
+            return sizeof(T) >> 1;
+        }
+
+        [[nodiscard]] u64 arm_count(const arm::instruction instr) const noexcept { return arm[static_cast<size_t>(instr)]; }
+        [[nodiscard]] u64 thumb_count(const thumb::instruction instr) const noexcept { return thumb[static_cast<size_t>(instr)]; }
+    };
+
+}
@@ -0,0 +1,210 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/aot.h>
+#include <arm7tdmi/predecode.h>
+
+namespace arm7tdmi {
+
+    class memory_interface;
+
+    enum class execution_tier : u8 {
+        // Fetched and decoded on every execution
+        interpreted,
+        // Decoded once into the block cache
+        predecoded,
+        // Compiled by the tier_backend
+        optimized
+    };
+
+    constexpr size_t execution_tier_count = 3;
+
+    struct tier_config {
+        // Entries into a block before it is predecoded, and before it is offered to the backend
+        u64 predecode_threshold = 4;
+        u64 optimize_threshold = 1024;
+
+        // Predecoded instructions kept across all blocks. When a block would not fit, every block is
+        // dropped from the cache and predecoded again on its next entry.
+        u32 cache_instructions = 1u << 16;
+
+        // Longest block predecoded, longer straight-line code continues as another block
+        u32 max_block_instructions = 64;
+
+        // Reads the host clock on every block entry to time each tier
+        bool timing = true;
+    };
+
+    struct tier_statistics {
+        // Indexed by execution_tier
+        std::array<u64, execution_tier_count> entries = {};
+        std::array<u64, execution_tier_count> instructions = {};
+        std::array<u64, execution_tier_count> nanoseconds = {};
+
+        // Blocks predecoded and compiled, and blocks the backend declined to compile
+        u64 predecoded = 0;
+        u64 optimized = 0;
+        u64 declined = 0;
+
+        // Times the whole cache was dropped to make room, and blocks dropped because their code was written
+        u64 evictions = 0;
+        u64 invalidations = 0;
+
+        [[nodiscard]] u64 entry_count(const execution_tier tier) const noexcept { return entries[static_cast<size_t>(tier)]; }
+        [[nodiscard]] u64 instruction_count(const execution_tier tier) const noexcept { return instructions[static_cast<size_t>(tier)]; }
+        [[nodiscard]] u64 time(const execution_tier tier) const noexcept { return nanoseconds[static_cast<size_t>(tier)]; }
+    };
+
+    /**
+     * Optimizing backend for the hottest blocks.
+     */
+    class tier_backend {
+    public:
+        virtual ~tier_backend() noexcept = default;
+
+        /**
+         * Compiles the block at address, whose code is the size bytes from address up to and including
+         * its first branch. The function may execute fewer instructions than the block, but no more,
+         * since writes outside [address, address + size) do not invalidate it.
+         * @return The compiled block, as aot_function does it, or nullptr to keep the block predecoded.
+         */
+        virtual aot_function compile(const memory_interface& memory, u32 address, bool thumb, u32 size) noexcept = 0;
+    };
+
+    struct tiered_block {
+        u64 entries = 0;
+
+        // Bytes of code the predecoded instructions or compiled function were made from, and the
+        // opcode of the first
+        u32 size = 0;
+        u32 opcode = 0;
+        bool offered = false;
+        aot_function function = nullptr;
+
+        // Instructions of the block while it is predecoded, only the vector for its state is used
+        std::vector<predecoded_arm> arm;
+        std::vector<predecoded_thumb> thumb;
+
+        [[nodiscard]] execution_tier tier() const noexcept {
+            if (function) {
+                return execution_tier::optimized;
+            }
+            return arm.empty() && thumb.empty() ? execution_tier::interpreted : execution_tier::predecoded;
+        }
+    };
+
+    /**
+     * Runs each block of guest code (the instructions from a branch target up to the next branch) in
+     * a tier chosen by how often it has been entered. A cpu with the tiers attached (cpu::set_tiers)
+     * counts an entry whenever a branch lands, and so interprets cold code straight from decode with
+     * no setup cost, keeps warm blocks predecoded in a bounded cache, and offers the hottest ones to
+     * a pluggable backend to compile.
+     *
+     * Writes made by the cpu, hooks and SWI handlers drop the blocks they overlap, which then start
+     * cold again. Anything else writing code must call invalidate().
+     *
+     * With timing on, the host time between one block entry and the next is added to the tier of the
+     * first, so a run's last block is only counted once stop_timing() is called.
+     */
+    class tiered_execution final {
+    public:
+        explicit tiered_execution(const tier_config& config = {}) noexcept;
+
+        [[nodiscard]] const tier_config& config() const noexcept { return _config; }
+
+        /**
+         * Backend offered blocks reaching optimize_threshold, nullptr to stop at predecoded.
+         */
+        void set_backend(tier_backend* backend) noexcept { _backend = backend; }
+        [[nodiscard]] tier_backend* backend() const noexcept { return _backend; }
+
+        /**
+         * Counts an entry into the block at address, and promotes it once it passes a threshold.
+         */
+        tiered_block& enter(u32 address, bool thumb, const memory_interface& memory) noexcept;
+
+        void retired(const execution_tier tier, const u64 instructions) noexcept {
+            _statistics.instructions[static_cast<size_t>(tier)] += instructions;
+        }
+
+        /**
+         * Drops the blocks overlapping [address, address + size).
+         */
+        void invalidate(const u32 address, const u32 size) noexcept {
+            if (code_pages(first_page(address), last_page(address, size))) {
+                invalidate_range(address, size);
+            }
+        }
+
+        /**
+         * Drops every block and its entry count.
+         */
+        void clear() noexcept;
+
+        [[nodiscard]] execution_tier tier(u32 address, bool thumb) const noexcept;
+
+        /**
+         * Adds the time since the last block entry to its tier, and pauses timing until the next one.
+         */
+        void stop_timing() noexcept;
+
+        [[nodiscard]] const tier_statistics& statistics() const noexcept { return _statistics; }
+        void reset_statistics() noexcept { _statistics = {}; }
+
+    private:
+        // Invalidation tracks which 4 KiB pages hold cached code
+        static constexpr u32 page_bits = 12;
+
+        [[nodiscard]] static u32 first_page(const u32 address) noexcept { return address >> page_bits; }
+        [[nodiscard]] static u32 last_page(const u32 address, const u32 size) noexcept {
+            return static_cast<u32>((static_cast<u64>(address) + size - 1) >> page_bits);
+        }
+
+        // Whether any page in [first, last] holds cached code, testing a word of the bitmap at a time
+        [[nodiscard]] bool code_pages(const u32 first, const u32 last) const noexcept {
+            for (u32 word = first / 64; word <= last / 64; ++word) {
+                u64 mask = ~0ull;
+                if (word == first / 64) {
+                    mask &= ~0ull << (first % 64);
+                }
+                if (word == last / 64) {
+                    mask &= ~0ull >> (63 - last % 64);
+                }
+                if (_code_pages[word] & mask) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void invalidate_range(u32 address, u32 size) noexcept;
+        void predecode(tiered_block& block, u32 key, const memory_interface& memory) noexcept;
+        void drop(u32 key, tiered_block& block) noexcept;
+
+        tier_config _config;
+        tier_backend* _backend = nullptr;
+
+        // Keyed by address, with bit 0 set for THUMB blocks
+        std::unordered_map<u32, tiered_block> _blocks;
+        u64 _cached_instructions = 0;
+
+        // Keys of the blocks holding code in each page, and a bit per page for the pages with any
+        std::unordered_map<u32, std::vector<u32>> _page_blocks;
+        std::vector<u64> _code_pages;
+
+        tier_statistics _statistics;
+        execution_tier _timed_tier = execution_tier::interpreted;
+        bool _timing = false;
+        std::chrono::steady_clock::time_point _last_entry = {};
+    };
+
+}
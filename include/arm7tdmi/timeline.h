@@ -0,0 +1,196 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+#include <arm7tdmi/tiers.h>
+
+namespace arm7tdmi {
+
+    /**
+     * Full machine state at a point in a run.
+     */
+    struct checkpoint {
+        cpu_registers registers = {};
+        cpu_state state = cpu_state::arm;
+        u64 cycles = 0;
+        bool irq_line = false;
+        u64 irq_cycle = ~0ull;
+        std::vector<u8> memory;
+
+        void save(const cpu& cpu, const basic_memory& memory) noexcept;
+        void restore(cpu& cpu, basic_memory& memory) const noexcept;
+
+        /**
+         * Restores the registers, and only the memory pages written since the memory's dirty pages
+         * were last cleared, then clears them. Much cheaper than restore() for short runs, as long as
+         * the dirty pages were cleared when the checkpoint was saved and nothing wrote through data().
+         * @return Number of pages copied back.
+         */
+        u32 restore_dirty(cpu& cpu, basic_memory& memory) const noexcept;
+    };
+
+    /**
+     * Time-parallel execution of a long deterministic run.
+     *
+     * record() makes a fast first pass, keeping a full checkpoint at a fixed interval. analyze() then
+     * replays every interval between consecutive checkpoints on its own host thread, each with its own
+     * cpu and memory, so expensive instrumentation scales with the number of cores. The run must not
+     * depend on external inputs, or those inputs must be replayed as part of the analysis.
+     *
+     * Each worker cpu is set up like the recorded one, so it steps the same instructions at a time:
+     * it gets its own predecode cache and tiers, with the same region, fusion and tier_config, and
+     * shares the compiled blocks, tier backend, hooks, semihosting and bios calls, which are then
+     * called from several workers at once.
+     */
+    class checkpoint_timeline final {
+    public:
+        /**
+         * Runs the cpu until end_cycle, or until an instruction cannot be fetched, checkpointing every interval cycles.
+         */
+        void record(cpu& cpu, basic_memory& memory, u64 interval, u64 end_cycle) noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return _checkpoints.size(); }
+        [[nodiscard]] const checkpoint& operator[](const size_t index) const noexcept { return _checkpoints[index]; }
+
+        /**
+         * @return The cycle at which the recorded run stopped.
+         */
+        [[nodiscard]] u64 end_cycle() const noexcept { return _end_cycle; }
+
+        /**
+         * Runs an analysis over every interval in parallel.
+         *
+         * @param make Called once per interval with the interval index, returns the analysis for it.
+         * If the analysis has configure(cpu&, basic_memory&), it is called once the worker is at the
+         * interval's checkpoint, to attach coverage, a profiler or a trace_recorder (set_memory), or
+         * to replace shared handlers. Analysis::step(cpu&, basic_memory&) is then called before every
+         * step, or in place of it if it returns bool, for analyses which step the cpu themselves
+         * (e.g. return profiler.step(cpu)) and return the result of cpu::step().
+         * @param threads Worker threads, 0 uses every host core.
+         * @return One analysis per interval, in order, ready to be stitched together.
+         */
+        template <typename Factory>
+        auto analyze(Factory make, u32 threads = 0) const noexcept;
+
+    private:
+        // Configuration of the recorded cpu, see the class description
+        struct worker_config {
+            bool predecode = false;
+            u32 predecode_base = 0;
+            u32 predecode_size = 0;
+            bool fusion = false;
+            std::optional<tier_config> tiers;
+            tier_backend* backend = nullptr;
+            const aot_module* aot = nullptr;
+            hle_hooks* hooks = nullptr;
+            semihosting* semihosting_calls = nullptr;
+            bios_calls* bios = nullptr;
+            bool block_loops = false;
+        };
+
+        std::vector<checkpoint> _checkpoints;
+        u64 _end_cycle = 0;
+        worker_config _config;
+    };
+
+    template <typename Factory>
+    auto checkpoint_timeline::analyze(Factory make, u32 threads) const noexcept {
+        using analysis = decltype(make(size_t{}));
+        std::vector<analysis> results;
+        results.reserve(_checkpoints.size());
+        for (size_t i = 0; i < _checkpoints.size(); ++i) {
+            results.push_back(make(i));
+        }
+        if (_checkpoints.empty()) {
+            return results;
+        }
+
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<u32>(std::min<size_t>(threads, _checkpoints.size()));
+
+        std::atomic<size_t> next = 0;
+        auto work = [&]() noexcept {
+            basic_memory memory(_checkpoints.front().memory.size());
+            cpu core(&memory);
+
+            std::optional<predecode_cache> predecode;
+            if (_config.predecode) {
+                predecode.emplace(_config.predecode_base, _config.predecode_size);
+                predecode->set_fusion(_config.fusion);
+            }
+            std::optional<tiered_execution> tiers;
+            if (_config.tiers) {
+                tiers.emplace(*_config.tiers);
+                tiers->set_backend(_config.backend);
+            }
+
+            for (size_t i = next++; i < _checkpoints.size(); i = next++) {
+                const u64 end = i + 1 < _checkpoints.size() ? _checkpoints[i + 1].cycles : _end_cycle;
+                _checkpoints[i].restore(core, memory);
+
+                // Undoes whatever the previous interval's analysis attached
+                core.set_memory(&memory);
+                core.set_coverage(nullptr);
+                core.set_aot(_config.aot);
+                core.set_hooks(_config.hooks);
+                core.set_semihosting(_config.semihosting_calls);
+                core.set_bios(_config.bios);
+                core.set_block_loops(_config.block_loops);
+                if (predecode) {
+                    predecode->fill(memory, 1);
+                    core.set_predecode(&*predecode);
+                }
+                if (tiers) {
+                    tiers->clear();
+                    core.set_tiers(&*tiers);
+                }
+
+                auto& analysis = results[i];
+                if constexpr (requires { analysis.configure(core, memory); }) {
+                    analysis.configure(core, memory);
+                }
+
+                while (core.get_cycles() < end) {
+                    if constexpr (std::is_same_v<decltype(analysis.step(core, memory)), bool>) {
+                        if (!analysis.step(core, memory)) {
+                            break;
+                        }
+                    } else {
+                        analysis.step(core, memory);
+                        if (!core.step()) {
+                            break;
+                        }
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (u32 t = 1; t < threads; ++t) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        return results;
+    }
+
+}
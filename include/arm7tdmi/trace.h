@@ -0,0 +1,146 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include <arm7tdmi/common.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    class cpu;
+
+    struct trace_access {
+        u32 address = 0;
+        u32 value = 0;
+        u8 size = 0;
+        bool write = false;
+    };
+
+    /**
+     * One executed instruction. Registers hold r0-r14 and the CPSR (index 15) after the instruction, as seen
+     * from the mode it left the cpu in, and changed has a bit set for each one it modified.
+     */
+    struct trace_record {
+        u32 pc = 0;
+        u32 opcode = 0;
+        cpu_state state = cpu_state::arm;
+        bool exception = false;
+        u16 changed = 0;
+        std::array<u32, 16> registers = {};
+        std::vector<trace_access> accesses;
+    };
+
+    struct trace_config {
+        // Bytes of encoded records per chunk, a chunk is handed to the writer thread when full
+        size_t chunk_size = 1024 * 1024;
+    };
+
+    /**
+     * Memory bus which records every executed instruction, with its register changes and data accesses,
+     * to a compact binary trace.
+     *
+     * Records are delta encoded into chunks. A full chunk is handed to a writer thread, which flushes
+     * it to the stream while the next chunk fills, so the emulation thread only waits on I/O when the
+     * writer falls a whole chunk behind. Each chunk starts with a full register snapshot, so chunks
+     * decode independently.
+     */
+    class trace_recorder final : public memory_interface {
+    public:
+        trace_recorder(memory_interface* memory, std::ostream& out, trace_config config = {}) noexcept;
+        ~trace_recorder() noexcept override;
+
+        trace_recorder(const trace_recorder&) = delete;
+        trace_recorder& operator=(const trace_recorder&) = delete;
+
+        /**
+         * Steps the cpu by one instruction and records it. The cpu must use this recorder as its memory.
+         * Fused pairs, bulk block loops, compiled blocks and tiers attached to the cpu are bypassed
+         * (cpu::step_instruction), so every instruction gets its own record.
+         * @return The result of cpu::step_instruction().
+         */
+        bool step(cpu& cpu) noexcept;
+
+        /**
+         * Hands the current chunk to the writer, and waits until everything recorded is written.
+         */
+        void flush() noexcept;
+
+        [[nodiscard]] u64 records() const noexcept { return _records; }
+
+        [[nodiscard]] u64 size() const noexcept override { return _memory->size(); }
+
+    protected:
+        [[nodiscard]] bool read_byte(u32 address, u8* out) const noexcept override;
+        bool write_byte(size_t address, u8 value) noexcept override;
+
+    private:
+        void capture(u32 address, u8 value, bool write) const noexcept;
+        void begin_chunk() noexcept;
+        void submit() noexcept;
+        void writer() noexcept;
+
+        memory_interface* _memory = nullptr;
+        std::ostream& _out;
+        trace_config _config;
+
+        // The cpu being stepped, accesses are only captured during step()
+        const cpu* _cpu = nullptr;
+        mutable std::vector<trace_access> _accesses;
+
+        // Encoder state, reset at the start of every chunk
+        std::vector<u8> _chunk;
+        u32 _chunk_records = 0;
+        u32 _expected_pc = 0;
+        u32 _last_address = 0;
+        std::array<u32, 16> _registers = {};
+        bool _started = false;
+        u64 _records = 0;
+
+        std::thread _thread;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::vector<u8> _pending;
+        bool _has_pending = false;
+        bool _stop = false;
+    };
+
+    class trace_reader final {
+    public:
+        explicit trace_reader(std::istream& in) noexcept;
+
+        /**
+         * @return False if the stream does not start with a valid trace header.
+         */
+        [[nodiscard]] bool valid() const noexcept { return _valid; }
+
+        /**
+         * Reads the next record.
+         * @return False at the end of the trace, or if it is truncated.
+         */
+        bool next(trace_record* out) noexcept;
+
+    private:
+        bool next_chunk() noexcept;
+
+        std::istream& _in;
+        bool _valid = false;
+
+        std::vector<u8> _chunk;
+        size_t _position = 0;
+        u32 _remaining = 0;
+        u32 _expected_pc = 0;
+        u32 _last_address = 0;
+        std::array<u32, 16> _registers = {};
+    };
+
+}
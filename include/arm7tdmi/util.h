@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <climits>
+#include <vector>
 
 namespace arm7tdmi::util
 {
@@ -136,6 +137,68 @@ namespace arm7tdmi::util
         return t - (t >> 23 << 24);
     }
 
+    /**
+     * Appends value as an LEB128 style variable length integer, 7 bits per byte.
+     */
+    inline void write_varint(std::vector<u8>& out, u64 value) noexcept {
+        while (value >= 0x80) {
+            out.push_back(static_cast<u8>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<u8>(value));
+    }
+
+    inline u64 read_varint(const u8* data, const size_t size, size_t& pos) noexcept {
+        u64 value = 0;
+        u32 shift = 0;
+        while (pos < size) {
+            const u8 b = data[pos++];
+            value |= static_cast<u64>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) {
+                break;
+            }
+            shift += 7;
+        }
+        return value;
+    }
+
+    constexpr u64 zigzag_encode(const i64 value) noexcept {
+        return (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63);
+    }
+
+    constexpr i64 zigzag_decode(const u64 value) noexcept {
+        return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+    }
+
+    /**
+     * @return True if a condition code (bits 31-28 of an ARM instruction) passes with the flags of cpsr.
+     */
+    constexpr bool condition_passed(const u32 cpsr, const u32 cond) noexcept {
+        const bool n = (cpsr >> 31) & 1u;
+        const bool z = (cpsr >> 30) & 1u;
+        const bool c = (cpsr >> 29) & 1u;
+        const bool v = (cpsr >> 28) & 1u;
+
+        switch (static_cast<condition_code>(cond & 0xf)) {
+            case condition_code::equal: return z;
+            case condition_code::nequal: return !z;
+            case condition_code::unsigned_higher_or_same: return c;
+            case condition_code::unsigned_lower: return !c;
+            case condition_code::negative: return n;
+            case condition_code::positive_or_zero: return !n;
+            case condition_code::overflow: return v;
+            case condition_code::no_overflow: return !v;
+            case condition_code::unsigned_higher: return c && !z;
+            case condition_code::unsigned_lower_or_same: return !c || z;
+            case condition_code::greater_or_equal: return n == v;
+            case condition_code::less_than: return n != v;
+            case condition_code::greater_than: return !z && n == v;
+            case condition_code::less_than_or_equal: return z || n != v;
+            case condition_code::never: return false;
+            default: return true;
+        }
+    }
+
 }
 
 namespace arm7tdmi {
@@ -0,0 +1,330 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#endif
+
+#include <fmt/format.h>
+
+#include <arm7tdmi/aot.h>
+#include <arm7tdmi/decoder.h>
+#include <arm7tdmi/disassembler.h>
+#include <arm7tdmi/hle.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        // Longer straight-line runs are split, the next block starting where the last one stopped
+        constexpr u32 max_block_instructions = 256;
+
+        constexpr i32 sign_extend(const u32 value, const u32 bits) noexcept {
+            const u32 shift = 32 - bits;
+            return static_cast<i32>(value << shift) >> shift;
+        }
+
+        std::string block_name(const aot_seed& seed) {
+            return fmt::format("block_{}_{:08x}", seed.thumb ? "thumb" : "arm", seed.address);
+        }
+
+        std::string taken(const u32 target, const u32 end, const u32 count) {
+            return fmt::format("c.r[15] = 0x{:08x}u; c.branched = true; c.branch_end = 0x{:08x}u; return {};", target, end, count);
+        }
+
+        // Code for one block, and the blocks it leads to
+        struct translation {
+            std::string code;
+            u32 instructions = 0;
+            u32 size = 0;
+            std::vector<aot_seed> successors;
+        };
+
+        // Appends the instruction at pc, @return false once the block has ended
+        bool translate_thumb(const memory_interface& memory, const u32 pc, translation& t) {
+            u16 opcode = 0;
+            if (!memory.read<u16>(pc, &opcode)) {
+                t.code += fmt::format("    c.r[15] = 0x{:08x}u; return {};\n", pc, t.instructions);
+                return false;
+            }
+
+            const u32 rd = (opcode >> 8) & 7u;
+            const u32 n = t.instructions + 1;
+            std::string code;
+            bool ends = false;
+
+            switch (thumb::decode(opcode)) {
+                case thumb::instruction::move_compare_add_subtract_immediate: {
+                    const u32 immediate = opcode & 0xffu;
+                    switch ((opcode >> 11) & 3u) {
+                        case 0:
+                            code = fmt::format("c.r[{}] = {}u; c.cpsr = (c.cpsr & 0x3fffffffu) | {}u;", rd, immediate, immediate == 0 ? 0x40000000u : 0u);
+                            break;
+                        case 1:
+                            code = fmt::format("arm7tdmi::aot_subtract(c, c.r[{}], {}u);", rd, immediate);
+                            break;
+                        case 2:
+                            code = fmt::format("c.r[{0}] = arm7tdmi::aot_add(c, c.r[{0}], {1}u);", rd, immediate);
+                            break;
+                        default:
+                            code = fmt::format("c.r[{0}] = arm7tdmi::aot_subtract(c, c.r[{0}], {1}u);", rd, immediate);
+                            break;
+                    }
+                    break;
+                }
+                case thumb::instruction::multiple_load_store: {
+                    const bool load = (opcode & 0x800u) != 0;
+                    const u32 list = opcode & 0xffu;
+                    if (list == 0) {
+                        // Transfers r15, left to the interpreter
+                        break;
+                    }
+                    code = fmt::format("u32 address = c.r[{}]; const u32 write_back = address + {}u; do {{", rd, std::popcount(list) * 4);
+                    for (u32 i = 0; i < 8; ++i) {
+                        if (((list >> i) & 1u) == 0) {
+                            continue;
+                        }
+                        if (load) {
+                            code += fmt::format(" {{ u32 value = 0; if (!c.read32(c.cpu, address, &value)) break; c.r[{}] = value; }}", i);
+                        }
+                        else {
+                            const bool first = (list & ((1u << i) - 1u)) == 0;
+                            code += fmt::format(" if (!c.write32(c.cpu, address, {})) break;", i == rd && !first ? "write_back" : fmt::format("c.r[{}]", i));
+                        }
+                        code += " address += 4u;";
+                    }
+                    if (!load || ((list >> rd) & 1u) == 0) {
+                        code += fmt::format(" c.r[{}] = write_back;", rd);
+                    }
+                    code += " } while (false);";
+                    break;
+                }
+                case thumb::instruction::load_store_with_immediate_offset: {
+                    const bool byte = (opcode & 0x1000u) != 0;
+                    const bool load = (opcode & 0x800u) != 0;
+                    const u32 offset = ((opcode >> 6) & 0x1fu) << (byte ? 0 : 2);
+                    const u32 rb = (opcode >> 3) & 7u;
+                    const u32 rt = opcode & 7u;
+                    code = fmt::format("const u32 address = c.r[{}] + {}u;", rb, offset);
+                    if (byte && load) {
+                        code += fmt::format(" u8 value = 0; if (c.read8(c.cpu, address, &value)) c.r[{}] = value;", rt);
+                    }
+                    else if (byte) {
+                        code += fmt::format(" c.write8(c.cpu, address, static_cast<u8>(c.r[{}]));", rt);
+                    }
+                    else if (load) {
+                        code += fmt::format(" u32 value = 0; if (c.read32(c.cpu, address, &value)) c.r[{}] = std::rotr(value, static_cast<int>((address & 3u) * 8));", rt);
+                    }
+                    else {
+                        code += fmt::format(" c.write32(c.cpu, address, c.r[{}]);", rt);
+                    }
+                    break;
+                }
+                case thumb::instruction::long_branch_with_link: {
+                    const u32 offset = opcode & 0x7ffu;
+                    if ((opcode & 0x800u) == 0) {
+                        code = fmt::format("c.r[14] = 0x{:08x}u;", pc + 4u + (static_cast<u32>(sign_extend(offset, 11)) << 12));
+                        break;
+                    }
+                    code = fmt::format("c.r[15] = c.r[14] + {}u; c.r[14] = 0x{:08x}u; c.branched = true; c.branch_end = 0x{:08x}u; return {};",
+                        offset << 1, (pc + 2u) | 1u, pc + 2u, n);
+                    ends = true;
+
+                    // The target is only known when the prefix is right before
+                    u16 prefix = 0;
+                    if (t.instructions > 0 && memory.read<u16>(pc - 2u, &prefix) && (prefix & 0xf800u) == 0xf000u) {
+                        const u32 target = pc + 2u + (static_cast<u32>(sign_extend(prefix & 0x7ffu, 11)) << 12) + (offset << 1);
+                        t.successors.push_back({target, true});
+                    }
+                    t.successors.push_back({pc + 2u, true});
+                    break;
+                }
+                case thumb::instruction::unconditional_branch: {
+                    const u32 target = pc + 4u + static_cast<u32>(sign_extend(opcode & 0x7ffu, 11)) * 2u;
+                    code = taken(target, pc + 2u, n);
+                    ends = true;
+                    t.successors.push_back({target, true});
+                    break;
+                }
+                case thumb::instruction::conditional_branch: {
+                    const u32 cond = (opcode >> 8) & 0xfu;
+                    if (cond >= 14) {
+                        break;
+                    }
+                    const u32 target = pc + 4u + static_cast<u32>(sign_extend(opcode & 0xffu, 8)) * 2u;
+                    code = fmt::format("if (arm7tdmi::util::condition_passed(c.cpsr, {}u)) {{ {} }} c.r[15] = 0x{:08x}u; return {};",
+                        cond, taken(target, pc + 2u, n), pc + 2u, n);
+                    ends = true;
+                    t.successors.push_back({target, true});
+                    t.successors.push_back({pc + 2u, true});
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            if (code.empty()) {
+                t.code += fmt::format("    c.r[15] = 0x{:08x}u; return {};\n", pc, t.instructions);
+                return false;
+            }
+
+            char text[disassembly_line_size];
+            thumb::disassemble(opcode, pc, text, sizeof(text));
+            t.code += fmt::format("    // 0x{:08x}: {}\n    {{ {} }}\n", pc, text, code);
+            t.instructions = n;
+            t.size += sizeof(u16);
+            return !ends;
+        }
+
+        bool translate_arm(const memory_interface& memory, const u32 pc, translation& t) {
+            u32 opcode = 0;
+            if (!memory.read<u32>(pc, &opcode) || arm::decode(opcode) != arm::instruction::branch) {
+                t.code += fmt::format("    c.r[15] = 0x{:08x}u; return {};\n", pc, t.instructions);
+                return false;
+            }
+
+            const u32 n = t.instructions + 1;
+            const u32 cond = opcode >> 28;
+            const bool link = (opcode >> 24) & 1u;
+            const u32 target = pc + 8u + static_cast<u32>(util::twos_compliment(opcode, 24)) * 4u;
+
+            std::string branch = link ? fmt::format("c.r[14] = 0x{:08x}u; ", pc + 4u) : std::string();
+            branch += taken(target, pc + 4u, n);
+            std::string code = cond == 14 ? branch : fmt::format("if (arm7tdmi::util::condition_passed(c.cpsr, {}u)) {{ {} }} c.r[15] = 0x{:08x}u; return {};", cond, branch, pc + 4u, n);
+
+            char text[disassembly_line_size];
+            arm::disassemble(opcode, pc, text, sizeof(text));
+            t.code += fmt::format("    // 0x{:08x}: {}\n    {{ {} }}\n", pc, text, code);
+            t.instructions = n;
+            t.size += sizeof(u32);
+
+            t.successors.push_back({target, false});
+            if (cond != 14 || link) {
+                t.successors.push_back({pc + 4u, false});
+            }
+            return false;
+        }
+    }
+
+    u32 write_aot_source(const memory_interface& memory, const std::span<const aot_seed> seeds, std::ostream& out) noexcept {
+        out << "// Generated by write_aot_source, compile as a shared object against the arm7tdmi headers.\n\n"
+               "#include <bit>\n\n"
+               "#include <arm7tdmi/aot.h>\n\n"
+               "namespace {\n";
+
+        std::vector<aot_seed> pending(seeds.begin(), seeds.end());
+        std::set<std::pair<bool, u32>> seen;
+        std::vector<std::pair<aot_seed, translation>> blocks;
+
+        while (!pending.empty()) {
+            const auto seed = pending.back();
+            pending.pop_back();
+            if (!seen.insert({seed.thumb, seed.address}).second) {
+                continue;
+            }
+
+            translation t;
+            u32 pc = seed.address;
+            bool open = true;
+            while (open && t.instructions < max_block_instructions) {
+                open = seed.thumb ? translate_thumb(memory, pc, t) : translate_arm(memory, pc, t);
+                pc += seed.thumb ? sizeof(u16) : sizeof(u32);
+            }
+            if (open) {
+                // Split, the rest is another block
+                t.code += fmt::format("    c.r[15] = 0x{:08x}u; return {};\n", pc, t.instructions);
+                t.successors.push_back({pc, seed.thumb});
+            }
+
+            pending.insert(pending.end(), t.successors.begin(), t.successors.end());
+            if (t.instructions > 0) {
+                out << "    u32 " << block_name(seed) << "(arm7tdmi::aot_context& c) noexcept {\n" << t.code << "    }\n\n";
+                blocks.emplace_back(seed, std::move(t));
+            }
+        }
+
+        out << "}\n\n"
+            << "extern \"C\" const u32 arm7tdmi_aot_abi_version = " << aot_abi_version << ";\n"
+            << "extern \"C\" const u32 arm7tdmi_aot_block_count = " << blocks.size() << ";\n"
+            << "extern \"C\" const arm7tdmi::aot_block arm7tdmi_aot_blocks[] = {\n";
+        for (const auto& [seed, t] : blocks) {
+            u64 hash = 0;
+            hle_hooks::signature(memory, seed.address, t.size, &hash);
+            u32 opcode = 0;
+            if (seed.thumb) {
+                u16 halfword = 0;
+                memory.read<u16>(seed.address, &halfword);
+                opcode = halfword;
+            }
+            else {
+                memory.read<u32>(seed.address, &opcode);
+            }
+            out << fmt::format("    {{0x{:08x}u, {}, {}u, 0x{:016x}ull, 0x{:08x}u, {}}},\n", seed.address, seed.thumb, t.size, hash, opcode, block_name(seed));
+        }
+        if (blocks.empty()) {
+            out << "    {0, false, 0, 0, 0, nullptr}\n";
+        }
+        out << "};\n";
+
+        return static_cast<u32>(blocks.size());
+    }
+
+    aot_module::~aot_module() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        for (void* library : _libraries) {
+            dlclose(library);
+        }
+#endif
+    }
+
+    bool aot_module::load(const std::string& path) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!library) {
+            return false;
+        }
+        const auto* version = static_cast<const u32*>(dlsym(library, "arm7tdmi_aot_abi_version"));
+        const auto* count = static_cast<const u32*>(dlsym(library, "arm7tdmi_aot_block_count"));
+        const auto* blocks = static_cast<const aot_block*>(dlsym(library, "arm7tdmi_aot_blocks"));
+        if (!version || *version != aot_abi_version || !count || !blocks) {
+            dlclose(library);
+            return false;
+        }
+        _libraries.push_back(library);
+        add({blocks, *count});
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void aot_module::add(const std::span<const aot_block> blocks) noexcept {
+        for (const auto& block : blocks) {
+            _blocks.push_back(block);
+            (block.thumb ? _thumb : _arm)[block.address] = block;
+        }
+    }
+
+    u32 aot_module::verify(const memory_interface& memory) noexcept {
+        const auto stale = std::remove_if(_blocks.begin(), _blocks.end(), [&](const aot_block& block) {
+            u64 hash = 0;
+            return !hle_hooks::signature(memory, block.address, block.size, &hash) || hash != block.hash;
+        });
+        const auto dropped = static_cast<u32>(_blocks.end() - stale);
+        _blocks.erase(stale, _blocks.end());
+
+        _arm.clear();
+        _thumb.clear();
+        for (const auto& block : _blocks) {
+            (block.thumb ? _thumb : _arm)[block.address] = block;
+        }
+        return dropped;
+    }
+
+}
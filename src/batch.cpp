@@ -0,0 +1,138 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <utility>
+
+#include <arm7tdmi/batch.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    cpu_batch::cpu_batch(const std::vector<memory_interface*>& memories) noexcept : _memories(memories) {
+        const size_t n = memories.size();
+        _lanes.reserve(n);
+        for (auto* memory : memories) {
+            _lanes.push_back(std::make_unique<cpu>(memory));
+        }
+        _halted.assign(n, 0);
+        _together.reserve(n);
+
+        // Every lane starts in one group, step() sorts them out by their actual pc
+        if (n != 0) {
+            _groups.push_back({group_key(*_lanes[0]), {}});
+            for (u32 i = 0; i < n; ++i) {
+                _groups[0].lanes.push_back(i);
+            }
+            _group_count = 1;
+        }
+    }
+
+    void cpu_batch::run(const u64 steps) noexcept {
+        for (u64 i = 0; i < steps; ++i) {
+            step();
+        }
+    }
+
+    void cpu_batch::step() noexcept {
+        _next_count = 0;
+        _next_index.clear();
+        _last_key = ~0ull;
+
+        for (size_t g = 0; g < _group_count; ++g) {
+            const auto& lanes = _groups[g].lanes;
+            if (lanes.empty()) {
+                continue;
+            }
+
+            // The host may have moved a lane since the last step, so only lanes still at the group's pc
+            // run together. A lane entering an IRQ, or executing from its own code caches, doesn't fetch
+            // what the group does.
+            const u64 key = _groups[g].key;
+            _together.clear();
+            for (const u32 i : lanes) {
+                const cpu& lane = *_lanes[i];
+                if (group_key(lane) != key || lane.irq_pending() || lane.uses_code_caches()) {
+                    step_scalar(i);
+                }
+                else {
+                    _together.push_back(i);
+                }
+            }
+
+            if (_together.size() == 1) {
+                step_scalar(_together[0]);
+            }
+            else if (!_together.empty()) {
+                step_group(_together.data(), static_cast<u32>(_together.size()));
+            }
+
+            for (const u32 i : lanes) {
+                if (!_halted[i]) {
+                    place(i);
+                }
+            }
+        }
+
+        std::swap(_groups, _next);
+        _group_count = _next_count;
+    }
+
+    void cpu_batch::place(const u32 lane) noexcept {
+        // Lanes of a group mostly land together, so the last group found is tried before the index
+        const u64 key = group_key(*_lanes[lane]);
+        if (key != _last_key) {
+            const auto [it, inserted] = _next_index.try_emplace(key, static_cast<u32>(_next_count));
+            if (inserted) {
+                if (_next_count == _next.size()) {
+                    _next.emplace_back();
+                }
+                _next[_next_count].key = key;
+                _next[_next_count].lanes.clear();
+                ++_next_count;
+            }
+            _last_key = key;
+            _last_group = it->second;
+        }
+        _next[_last_group].lanes.push_back(lane);
+    }
+
+    void cpu_batch::step_scalar(const u32 lane) noexcept {
+        _halted[lane] = !_lanes[lane]->step();
+        _statistics.scalar_steps++;
+    }
+
+    void cpu_batch::step_group(const u32* group, const u32 size) noexcept {
+        const u32 leader = group[0];
+        const u32 pc = _lanes[leader]->registers.pc();
+
+        // Every lane goes through dispatch, so conditions, coverage, hooks and statistics are as for step()
+        if (_lanes[leader]->get_state() == cpu_state::thumb) {
+            u16 opcode = 0;
+            if (!_memories[leader]->read<u16>(pc, &opcode)) {
+                for (u32 k = 0; k < size; ++k) step_scalar(group[k]);
+                return;
+            }
+
+            const auto instr = thumb::decode(opcode);
+            for (u32 k = 0; k < size; ++k) {
+                _lanes[group[k]]->dispatch(instr, opcode);
+            }
+        }
+        else {
+            u32 opcode = 0;
+            if (!_memories[leader]->read<u32>(pc, &opcode)) {
+                for (u32 k = 0; k < size; ++k) step_scalar(group[k]);
+                return;
+            }
+
+            const auto instr = arm::decode(opcode);
+            for (u32 k = 0; k < size; ++k) {
+                _lanes[group[k]]->dispatch(instr, opcode);
+            }
+        }
+
+        _statistics.lockstep_steps++;
+        _statistics.lockstep_lanes += size;
+    }
+}
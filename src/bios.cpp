@@ -0,0 +1,88 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <limits>
+
+#include <arm7tdmi/bios.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/register.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        bool divide(cpu_registers& registers, const i32 numerator, const i32 denominator) noexcept {
+            if (denominator == 0) {
+                return false;
+            }
+            // INT_MIN / -1 wraps rather than trapping
+            const i64 quotient = static_cast<i64>(numerator) / denominator;
+            const i64 remainder = static_cast<i64>(numerator) % denominator;
+            registers.r0(static_cast<u32>(quotient));
+            registers.r1(static_cast<u32>(remainder));
+            registers.r3(static_cast<u32>(quotient < 0 ? -quotient : quotient));
+            return true;
+        }
+
+        u32 square_root(const u32 value) noexcept {
+            u32 result = 0;
+            u32 remainder = value;
+            for (u32 bit = 1u << 30; bit != 0; bit >>= 2) {
+                if (remainder >= result + bit) {
+                    remainder -= result + bit;
+                    result = (result >> 1) + bit;
+                }
+                else {
+                    result >>= 1;
+                }
+            }
+            return result;
+        }
+
+        template <typename T>
+        void copy(memory_interface& memory, u32 source, u32 destination, const u32 count, const bool fill) noexcept {
+            source &= ~(sizeof(T) - 1);
+            destination &= ~(sizeof(T) - 1);
+            T value = 0;
+            for (u32 i = 0; i < count; ++i) {
+                if (!fill || i == 0) {
+                    memory.read<T>(source, &value);
+                }
+                memory.write<T>(destination, value);
+                source += fill ? 0 : sizeof(T);
+                destination += sizeof(T);
+            }
+        }
+    }
+
+    void bios_calls::add_standard() noexcept {
+        add(div, [](cpu_registers& registers, memory_interface&) {
+            return divide(registers, static_cast<i32>(registers.r0()), static_cast<i32>(registers.r1()));
+        });
+        add(div_arm, [](cpu_registers& registers, memory_interface&) {
+            return divide(registers, static_cast<i32>(registers.r1()), static_cast<i32>(registers.r0()));
+        });
+        add(sqrt, [](cpu_registers& registers, memory_interface&) {
+            registers.r0(square_root(registers.r0()));
+            return true;
+        });
+        add(cpu_set, [](cpu_registers& registers, memory_interface& memory) {
+            const u32 control = registers.r2();
+            const u32 count = control & 0x1fffff;
+            const bool fill = (control >> 24) & 1u;
+            if ((control >> 26) & 1u) {
+                copy<u32>(memory, registers.r0(), registers.r1(), count, fill);
+            }
+            else {
+                copy<u16>(memory, registers.r0(), registers.r1(), count, fill);
+            }
+            return true;
+        });
+        add(cpu_fast_set, [](cpu_registers& registers, memory_interface& memory) {
+            const u32 control = registers.r2();
+            copy<u32>(memory, registers.r0(), registers.r1(), ((control & 0x1fffff) + 7u) & ~7u, (control >> 24) & 1u);
+            return true;
+        });
+    }
+
+}
@@ -0,0 +1,114 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/shm.h>
+#endif
+
+#include <arm7tdmi/coverage.h>
+
+namespace arm7tdmi {
+
+    coverage::coverage(const u32 code_begin, const u32 code_end) noexcept
+        : _code_begin(code_begin), _code_end(std::max(code_begin, code_end)), _seen(seen_blocks), _own_edges(edge_map_size) {
+        _executed.assign(((_code_end - _code_begin) / 2 + 63) / 64, 0);
+        _edges = _own_edges.data();
+        _block_start = code_begin;
+    }
+
+    coverage::~coverage() noexcept {
+        detach_shared_memory();
+    }
+
+    void coverage::mark(const u32 begin, u32 end) noexcept {
+        if (end <= begin) {
+            return;
+        }
+        if (end - begin > max_block_size) {
+            ++_truncated;
+            end = begin + max_block_size;
+        }
+
+        const u32 first = std::max(begin, _code_begin) & ~1u;
+        const u32 last = std::min(end, _code_end);
+        if (first >= last) {
+            return;
+        }
+
+        // Halfword indices [from, to), set a bitmap word at a time
+        const u32 from = (first - _code_begin) / 2;
+        const u32 to = (last - _code_begin + 1) / 2;
+        for (u32 word = from / 64; word <= (to - 1) / 64; ++word) {
+            u64 mask = ~0ull;
+            if (word == from / 64) {
+                mask &= ~0ull << (from % 64);
+            }
+            if (word == (to - 1) / 64) {
+                mask &= ~0ull >> (63 - (to - 1) % 64);
+            }
+            _executed[word] |= mask;
+        }
+    }
+
+    void coverage::reset() noexcept {
+        std::fill(_executed.begin(), _executed.end(), 0);
+        std::fill(_edges, _edges + edge_map_size, 0);
+        std::fill(_seen.begin(), _seen.end(), 0);
+        _truncated = 0;
+        _previous = 0;
+    }
+
+    bool coverage::executed(const u32 address) const noexcept {
+        if (address < _code_begin || address >= _code_end) {
+            return false;
+        }
+        const u32 index = (address - _code_begin) / 2;
+        return (_executed[index / 64] >> (index % 64)) & 1u;
+    }
+
+    u32 coverage::executed_halfwords() const noexcept {
+        u32 count = 0;
+        for (const u64 word : _executed) {
+            count += static_cast<u32>(std::popcount(word));
+        }
+        return count;
+    }
+
+    void coverage::attach(u8* map) noexcept {
+        detach_shared_memory();
+        _edges = map ? map : _own_edges.data();
+    }
+
+    bool coverage::attach_afl_shared_memory() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        const char* id = std::getenv("__AFL_SHM_ID");
+        if (!id) {
+            return false;
+        }
+
+        void* memory = shmat(std::atoi(id), nullptr, 0);
+        if (memory == reinterpret_cast<void*>(-1)) {
+            return false;
+        }
+        attach(static_cast<u8*>(memory));
+        _shared = memory;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void coverage::detach_shared_memory() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        if (_shared) {
+            shmdt(_shared);
+        }
+#endif
+        _shared = nullptr;
+    }
+}
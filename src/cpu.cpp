@@ -1,16 +1,658 @@
 //
 // Created by talexander on 9/9/2024.
 //
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstring>
 #include <utility>
 #include <arm7tdmi/cpu.h>
+#include <arm7tdmi/aot.h>
+#include <arm7tdmi/bios.h>
+#include <arm7tdmi/coverage.h>
+#include <arm7tdmi/hle.h>
 #include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+#include <arm7tdmi/semihosting.h>
+#include <arm7tdmi/tiers.h>
 
 namespace arm7tdmi {
+    namespace {
+        u32 load_word(const u8* bytes) noexcept {
+            return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<u32>(bytes[3]) << 24);
+        }
+
+        void store_word(u8* bytes, const u32 value) noexcept {
+            for (u32 i = 0; i < sizeof(u32); ++i) {
+                bytes[i] = static_cast<u8>(value >> (i * 8));
+            }
+        }
+
+        // Memory given to host functions, whose writes invalidate predecoded instructions like the cpu's own
+        class hle_memory final : public memory_interface {
+        public:
+            hle_memory(memory_interface& memory, predecode_cache* predecode, tiered_execution* tiers) noexcept
+                : _memory(memory), _predecode(predecode), _tiers(tiers) {
+            }
+
+            [[nodiscard]] u64 size() const noexcept override { return _memory.size(); }
+
+            [[nodiscard]] const u8* direct_read(const u32 address, const u64 size) const noexcept override {
+                return _memory.direct_read(address, size);
+            }
+
+            [[nodiscard]] u8* direct_write(const u32 address, const u64 size) noexcept override {
+                if (_predecode) {
+                    _predecode->invalidate(address, static_cast<u32>(std::min<u64>(size, 0xffffffff)));
+                }
+                if (_tiers && size != 0) {
+                    _tiers->invalidate(address, static_cast<u32>(std::min<u64>(size, 0xffffffff)));
+                }
+                return _memory.direct_write(address, size);
+            }
+
+        protected:
+            [[nodiscard]] bool read_byte(const u32 address, u8* out) const noexcept override {
+                return _memory.read<u8>(address, out);
+            }
+
+            bool write_byte(const size_t address, const u8 value) noexcept override {
+                if (_predecode) {
+                    _predecode->invalidate(static_cast<u32>(address), 1);
+                }
+                if (_tiers) {
+                    _tiers->invalidate(static_cast<u32>(address), 1);
+                }
+                return _memory.write<u8>(static_cast<u32>(address), value);
+            }
+
+        private:
+            memory_interface& _memory;
+            predecode_cache* _predecode;
+            tiered_execution* _tiers;
+        };
+    }
+
     cpu::cpu(memory_interface *memory) noexcept : _memory(memory) {
     }
 
+    void cpu::set_coverage(coverage* coverage) noexcept {
+        _coverage = coverage;
+        if (_coverage) {
+            _coverage->start(registers.pc());
+        }
+    }
+
+    bool cpu::step() noexcept {
+        if (!_memory) {
+            return false;
+        }
+
+        take_irq();
+
+        if (_tiers) {
+            return step_tiered();
+        }
+
+        if (_aot) {
+            if (const auto* block = _aot->find_block(registers.pc(), _state == cpu_state::thumb)) {
+                run_aot(block->function, block->opcode);
+                return true;
+            }
+        }
+
+        if (_state == cpu_state::arm) {
+            if (_predecode) {
+                if (const auto* entry = _predecode->find_arm(registers.pc())) {
+                    dispatch(entry->instr, entry->opcode);
+                    return true;
+                }
+            }
+
+            u32 opcode = 0;
+            if (!_memory->read<u32>(registers.pc(), &opcode)) {
+                return false;
+            }
+            const auto instr = arm::decode(opcode);
+            if (_predecode) {
+                _predecode->store(registers.pc(), opcode, instr);
+            }
+            dispatch(instr, opcode);
+        }
+        else {
+            if (_predecode) {
+                if (const auto* entry = _predecode->find_thumb(registers.pc())) {
+                    if (_block_loops && (entry->instr == thumb::instruction::multiple_load_store ||
+                        entry->instr == thumb::instruction::load_store_with_immediate_offset) && execute_block_loop(*entry)) {
+                        return true;
+                    }
+                    if (entry->fusion != fused_pair::none) {
+                        dispatch_fused(*entry);
+                    }
+                    else {
+                        dispatch(entry->instr, entry->opcode);
+                    }
+                    return true;
+                }
+            }
+
+            u16 opcode = 0;
+            if (!_memory->read<u16>(registers.pc(), &opcode)) {
+                return false;
+            }
+            const auto instr = thumb::decode(opcode);
+            if (_predecode) {
+                _predecode->store(registers.pc(), opcode, instr);
+            }
+            dispatch(instr, opcode);
+        }
+
+        return true;
+    }
+
+    bool cpu::step_instruction() noexcept {
+        if (!_memory) {
+            return false;
+        }
+
+        take_irq();
+
+        // A tiered step after this one starts a new block
+        _tier_block = nullptr;
+        _tier_next = 1;
+
+        if (_state == cpu_state::arm) {
+            u32 opcode = 0;
+            if (!_memory->read<u32>(registers.pc(), &opcode)) {
+                return false;
+            }
+            dispatch(arm::decode(opcode), opcode);
+        }
+        else {
+            u16 opcode = 0;
+            if (!_memory->read<u16>(registers.pc(), &opcode)) {
+                return false;
+            }
+            dispatch(thumb::decode(opcode), opcode);
+        }
+        return true;
+    }
+
+    void cpu::take_irq() noexcept {
+        if (_cycles >= _irq_cycle) {
+            _irq_line = true;
+            _irq_cycle = ~0ull;
+        }
+        if (_irq_line && !registers.cpsr_get_i()) {
+            const u32 pc = registers.pc();
+            // Return with SUBS PC, R14, #4, back to the instruction that was about to execute
+            enter_exception(cpu_mode::irq, 0x18, pc + 4u);
+            if (_coverage) {
+                _coverage->edge(pc, 0x18);
+            }
+        }
+    }
+
+    bool cpu::step_tiered() noexcept {
+        const u32 pc = registers.pc();
+        const bool thumb = _state == cpu_state::thumb;
+
+        // A new block starts where a branch lands, and where a predecoded block runs out
+        const bool block_end = _tier_block && _tier_index >= (thumb ? _tier_block->thumb.size() : _tier_block->arm.size());
+        if (pc != _tier_next || block_end) {
+            const auto& block = _tiers->enter(pc, thumb, *_memory);
+            _tier_block = nullptr;
+            if (block.function) {
+                const u64 cycles = _cycles;
+                run_aot(block.function, block.opcode);
+                _tiers->retired(execution_tier::optimized, _cycles - cycles);
+                _tier_next = 1;
+                return true;
+            }
+            if (block.tier() == execution_tier::predecoded) {
+                _tier_block = &block;
+                _tier_index = 0;
+            }
+        }
+
+        if (_tier_block) {
+            // Copied out, the instruction may overwrite its own block
+            if (thumb) {
+                const auto entry = _tier_block->thumb[_tier_index++];
+                dispatch(entry.instr, entry.opcode);
+            }
+            else {
+                const auto entry = _tier_block->arm[_tier_index++];
+                dispatch(entry.instr, entry.opcode);
+            }
+            _tiers->retired(execution_tier::predecoded, 1);
+        }
+        else if (thumb) {
+            u16 opcode = 0;
+            if (!_memory->read<u16>(pc, &opcode)) {
+                return false;
+            }
+            dispatch(thumb::decode(opcode), opcode);
+            _tiers->retired(execution_tier::interpreted, 1);
+        }
+        else {
+            u32 opcode = 0;
+            if (!_memory->read<u32>(pc, &opcode)) {
+                return false;
+            }
+            dispatch(arm::decode(opcode), opcode);
+            _tiers->retired(execution_tier::interpreted, 1);
+        }
+
+        _tier_next = pc + (thumb ? sizeof(u16) : sizeof(u32));
+        return true;
+    }
+
+    void cpu::dispatch(const arm::instruction instr, const u32 opcode) noexcept {
+        const u32 pc = registers.pc();
+        _opcode = opcode;
+        _instruction_end = pc + sizeof(u32);
+        _branched = false;
+        execute(instr, opcode);
+        if (!_branched) {
+            registers.pc(pc + sizeof(u32));
+        }
+        else if (_coverage) {
+            _coverage->edge(pc + sizeof(u32), registers.pc());
+        }
+        ++_cycles;
+
+        if (_branched && _hooks) {
+            call_hook();
+        }
+    }
+
+    void cpu::dispatch(const thumb::instruction instr, const u16 opcode) noexcept {
+        const u32 pc = registers.pc();
+        _opcode = opcode;
+        _instruction_end = pc + sizeof(u16);
+        _branched = false;
+        execute(instr, opcode);
+        if (!_branched) {
+            registers.pc(pc + sizeof(u16));
+        }
+        else if (_coverage) {
+            _coverage->edge(pc + sizeof(u16), registers.pc());
+        }
+        ++_cycles;
+
+        if (_branched && _hooks) {
+            call_hook();
+        }
+    }
+
+    void cpu::dispatch_fused(const predecoded_thumb& entry) noexcept {
+        // The second instruction would start a cycle later, an IRQ pending by then is taken before it
+        if (_cycles + 1 >= _irq_cycle) {
+            _irq_line = true;
+            _irq_cycle = ~0ull;
+        }
+        if (_irq_line && !registers.cpsr_get_i()) {
+            dispatch(entry.instr, entry.opcode);
+            return;
+        }
+
+        const u32 pc = registers.pc();
+        const u32 rd = (entry.opcode >> 8) & 7u;
+        _opcode = entry.opcode;
+        _instruction_end = pc + 4u;
+        ARM7TDMI_STATISTIC(_statistics.thumb[static_cast<size_t>(entry.instr)]);
+
+        bool branched = false;
+        switch (entry.fusion) {
+            case fused_pair::branch_with_link: {
+                ARM7TDMI_STATISTIC(_statistics.thumb[static_cast<size_t>(thumb::instruction::long_branch_with_link)]);
+                const u32 high = static_cast<u32>(static_cast<i32>(static_cast<u32>(entry.opcode) << 21) >> 21) << 12;
+                registers.lr((pc + 4u) | 1u);
+                registers.pc(pc + 4u + high + ((entry.next & 0x7ffu) << 1));
+                if (_coverage) {
+                    _coverage->edge(pc + 4u, registers.pc());
+                }
+                branched = true;
+                break;
+            }
+            case fused_pair::compare_branch:
+                ARM7TDMI_STATISTIC(_statistics.thumb[static_cast<size_t>(thumb::instruction::conditional_branch)]);
+                subtract_with_flags(registers.get(rd), entry.opcode & 0xffu);
+                if (condition_passed(static_cast<u32>(entry.next) << 20)) {
+                    registers.pc(pc + 6u + static_cast<u32>(static_cast<i8>(entry.next & 0xffu)) * 2u);
+                    if (_coverage) {
+                        _coverage->edge(pc + 4u, registers.pc());
+                    }
+                    branched = true;
+                }
+                else {
+                    registers.pc(pc + 4u);
+                }
+                break;
+            case fused_pair::move_add:
+                ARM7TDMI_STATISTIC(_statistics.thumb[static_cast<size_t>(thumb::instruction::move_compare_add_subtract_immediate)]);
+                registers.set(rd, add_with_flags(entry.opcode & 0xffu, entry.next & 0xffu));
+                registers.pc(pc + 4u);
+                break;
+            default:
+                break;
+        }
+        _cycles += 2;
+
+        if (_hooks && branched) {
+            call_hook();
+        }
+    }
+
+    void cpu::call_hook() noexcept {
+        const u32 entry = registers.pc();
+        const auto* function = _hooks->find(entry);
+        if (!function) {
+            return;
+        }
+        hle_memory memory(*_memory, _predecode, _tiers);
+        if (!(*function)(registers, memory)) {
+            return;
+        }
+        ARM7TDMI_STATISTIC(_statistics.hooks);
+
+        // Return as BX LR would
+        const u32 lr = registers.lr();
+        const cpu_state state = (lr & 1u) ? cpu_state::thumb : cpu_state::arm;
+        if (_state != state) {
+            ARM7TDMI_STATISTIC(_statistics.state_switches);
+        }
+        _state = state;
+        registers.pc(lr & ~1u);
+        if (_coverage) {
+            _coverage->edge(entry, registers.pc());
+        }
+    }
+
+    bool cpu::execute_block_loop(const predecoded_thumb& head) noexcept {
+        const u32 pc = registers.pc();
+
+        // The head, one more instruction for copies and STR fills, SUB Rn, #imm, then a branch back to the head
+        u16 body[4] = {head.opcode};
+        [[maybe_unused]] thumb::instruction instrs[4] = {head.instr};
+        u32 length = 1;
+        for (; length < 4; ++length) {
+            const auto* entry = _predecode->find_thumb(pc + length * sizeof(u16));
+            if (!entry) {
+                return false;
+            }
+            body[length] = entry->opcode;
+            instrs[length] = entry->instr;
+            if (entry->instr == thumb::instruction::conditional_branch) {
+                break;
+            }
+        }
+        if (length != 2 && length != 3) {
+            return false;
+        }
+
+        const u16 branch = body[length];
+        const u16 counter = body[length - 1];
+        const u32 end = pc + (length + 1) * sizeof(u16);
+        if (end + 2u + static_cast<u32>(static_cast<i8>(branch & 0xffu)) * 2u != pc) {
+            return false;
+        }
+        if ((counter & 0xf800u) != 0x3800u || (counter & 0xffu) == 0) {
+            return false;
+        }
+        const u32 rn = (counter >> 8) & 7u;
+        const u32 decrement = counter & 0xffu;
+
+        // Registers transferred each iteration, the source base for copies and the destination base
+        u32 list = 0;
+        u32 source = 8;
+        u32 destination = 0;
+        if (length == 3 && (head.opcode & 0xf800u) == 0xc800u && (body[1] & 0xf800u) == 0xc000u && (head.opcode & 0xffu) == (body[1] & 0xffu)) {
+            // LDMIA Rs!, {list}; STMIA Rd!, {list}
+            list = head.opcode & 0xffu;
+            source = (head.opcode >> 8) & 7u;
+            destination = (body[1] >> 8) & 7u;
+        }
+        else if (length == 2 && (head.opcode & 0xf800u) == 0xc000u) {
+            // STMIA Rd!, {list}
+            list = head.opcode & 0xffu;
+            destination = (head.opcode >> 8) & 7u;
+        }
+        else if (length == 3 && (head.opcode & 0xffc0u) == 0x6000u && body[1] == (0x3004u | ((head.opcode & 0x38u) << 5))) {
+            // STR Rs, [Rd]; ADD Rd, #4
+            list = 1u << (head.opcode & 7u);
+            destination = (head.opcode >> 3) & 7u;
+        }
+        else {
+            return false;
+        }
+
+        const bool copy = source < 8;
+        const u32 bases = (1u << destination) | (1u << rn) | (copy ? 1u << source : 0u);
+        if (list == 0 || (list & bases) != 0 || std::popcount(bases) != (copy ? 3 : 2)) {
+            return false;
+        }
+
+        const u32 block = std::popcount(list) * sizeof(u32);
+        const u32 from = copy ? registers.get(source) : 0;
+        const u32 to = registers.get(destination);
+        if (((from | to) & 3u) != 0) {
+            return false;
+        }
+
+        // A scheduled IRQ is taken on the cycle it is due, so only the iterations which finish before
+        // it run in bulk, and the one it falls in is stepped
+        u64 deadline = ~0ull;
+        if (_irq_cycle != ~0ull) {
+            deadline = (_irq_cycle - _cycles) / (length + 1);
+            if (deadline == 0) {
+                return false;
+            }
+        }
+
+        // Count iterations by running the counter alone, which leaves the flags as the last SUB sets them
+        const u32 cpsr = registers.cpsr();
+        const u64 limit = _memory->size() / block;
+        u64 iterations = 1;
+        bool exited = true;
+        u32 count = subtract_with_flags(registers.get(rn), decrement);
+        while (check_condition(static_cast<u32>(branch) << 20)) {
+            if (iterations == deadline) {
+                exited = false;
+                break;
+            }
+            if (iterations == limit) {
+                registers.cpsr(cpsr);
+                return false;
+            }
+            count = subtract_with_flags(count, decrement);
+            ++iterations;
+        }
+
+        const u64 bytes = iterations * block;
+        const u8* src = copy ? _memory->direct_read(from, bytes) : nullptr;
+        // Stores ahead of the source, or into the loop, change what later iterations read
+        const bool overlaps_source = copy && to > from && to < from + bytes;
+        const bool overlaps_code = to < end && to + bytes > pc;
+        u8* dst = (copy && !src) || overlaps_source || overlaps_code ? nullptr : _memory->direct_write(to, bytes);
+        if (!dst) {
+            registers.cpsr(cpsr);
+            return false;
+        }
+
+        if (copy) {
+            // The registers hold the last block, read before the copy can overwrite it
+            const u8* last = src + bytes - block;
+            for (u32 i = 0; i < 8; ++i) {
+                if ((list >> i) & 1u) {
+                    registers.set(i, load_word(last));
+                    last += sizeof(u32);
+                }
+            }
+            std::memmove(dst, src, bytes);
+            registers.set(source, static_cast<u32>(from + bytes));
+        }
+        else {
+            u8* out = dst;
+            for (u32 i = 0; i < 8; ++i) {
+                if ((list >> i) & 1u) {
+                    store_word(out, registers.get(i));
+                    out += sizeof(u32);
+                }
+            }
+            // Double the filled prefix, it is always a whole number of blocks
+            for (u64 filled = block; filled < bytes;) {
+                const u64 n = std::min(filled, bytes - filled);
+                std::memcpy(dst + filled, dst, n);
+                filled += n;
+            }
+        }
+
+        registers.set(destination, static_cast<u32>(to + bytes));
+        registers.set(rn, count);
+        // Stopped for an IRQ, the branch back was taken by the last iteration too
+        registers.pc(exited ? end : pc);
+        if (_predecode) {
+            _predecode->invalidate(to, static_cast<u32>(bytes));
+        }
+        if (_coverage) {
+            for (u64 i = exited; i < iterations; ++i) {
+                _coverage->edge(end, pc);
+            }
+        }
+        _opcode = head.opcode;
+        _instruction_end = end;
+        _cycles += iterations * (length + 1);
+
+#ifdef ARM7TDMI_STATISTICS
+        for (u32 i = 0; i <= length; ++i) {
+            _statistics.thumb[static_cast<size_t>(instrs[i])] += iterations;
+        }
+        if (copy) {
+            _statistics.reads[cpu_statistics::access_width<u32>()] += bytes / sizeof(u32);
+        }
+        _statistics.writes[cpu_statistics::access_width<u32>()] += bytes / sizeof(u32);
+        // The branch back falls through once, unless an IRQ stopped the loop
+        _statistics.condition_failed += exited;
+#endif
+        return true;
+    }
+
+    void cpu::run_aot(const aot_function function, const u32 opcode) noexcept {
+        _opcode = opcode;
+        aot_context context = {};
+        for (u32 i = 0; i < 16; ++i) {
+            context.r[i] = registers.get(i);
+        }
+        context.cpsr = registers.cpsr();
+        context.cpu = this;
+        context.read8 = &cpu::aot_read<u8>;
+        context.read32 = &cpu::aot_read<u32>;
+        context.write8 = &cpu::aot_write<u8>;
+        context.write32 = &cpu::aot_write<u32>;
+
+        _cycles += function(context);
+
+        for (u32 i = 0; i < 16; ++i) {
+            registers.set(i, context.r[i]);
+        }
+        registers.cpsr(context.cpsr);
+
+        // A block which doesn't branch leaves pc just past its last instruction
+        _instruction_end = context.branched ? context.branch_end : registers.pc();
+        if (context.branched) {
+            if (_coverage) {
+                _coverage->edge(context.branch_end, registers.pc());
+            }
+            if (_hooks) {
+                call_hook();
+            }
+        }
+    }
+
+    template <typename T>
+    bool cpu::aot_read(void* cpu, const u32 address, T* out) noexcept {
+        return static_cast<arm7tdmi::cpu*>(cpu)->read<T>(address, out);
+    }
+
+    template <typename T>
+    bool cpu::aot_write(void* cpu, const u32 address, const T value) noexcept {
+        return static_cast<arm7tdmi::cpu*>(cpu)->write<T>(address, value);
+    }
+
+    void cpu::software_interrupt(const u32 comment, const u32 function, const u32 size) noexcept {
+        hle_memory memory(*_memory, _predecode, _tiers);
+        if (_semihosting && comment == (_state == cpu_state::arm ? semihosting::arm_swi : semihosting::thumb_swi)) {
+            ARM7TDMI_STATISTIC(_statistics.hooks);
+            _semihosting->call(registers, memory);
+            return;
+        }
+        if (_bios && _bios->call(static_cast<u8>(function), registers, memory)) {
+            ARM7TDMI_STATISTIC(_statistics.hooks);
+            return;
+        }
+
+        // Return with MOVS PC, R14, to the instruction after the SWI
+        enter_exception(cpu_mode::supervisor, 0x08, registers.pc() + size);
+        _branched = true;
+    }
+
+    u32 cpu::add_with_flags(const u32 a, const u32 b) noexcept {
+        const u32 result = a + b;
+        registers.cpsr_set_n(result >> 31);
+        registers.cpsr_set_z(result == 0);
+        registers.cpsr_set_c(result < a);
+        registers.cpsr_set_v(((a ^ result) & (b ^ result)) >> 31);
+        return result;
+    }
+
+    u32 cpu::subtract_with_flags(const u32 a, const u32 b) noexcept {
+        const u32 result = a - b;
+        registers.cpsr_set_n(result >> 31);
+        registers.cpsr_set_z(result == 0);
+        registers.cpsr_set_c(a >= b);
+        registers.cpsr_set_v(((a ^ b) & (a ^ result)) >> 31);
+        return result;
+    }
+
+    template <typename T>
+    bool cpu::read(const u32 address, T* out) noexcept {
+        ARM7TDMI_STATISTIC(_statistics.reads[cpu_statistics::access_width<T>()]);
+        return _memory->read<T>(address, out);
+    }
+
+    template <typename T>
+    bool cpu::write(const u32 address, const T value) noexcept {
+        ARM7TDMI_STATISTIC(_statistics.writes[cpu_statistics::access_width<T>()]);
+        if (_predecode) {
+            _predecode->invalidate(address & ~(sizeof(T) - 1), sizeof(T));
+        }
+        if (_tiers) {
+            _tiers->invalidate(address & ~(sizeof(T) - 1), sizeof(T));
+        }
+        return _memory->write<T>(address, value);
+    }
+
+    void cpu::enter_exception(const cpu_mode mode, const u32 vector, const u32 return_address) noexcept {
+        const u32 cpsr = registers.cpsr();
+        if (_state != cpu_state::arm) {
+            ARM7TDMI_STATISTIC(_statistics.state_switches);
+        }
+
+        registers.cpsr_set_mode(mode);
+        registers.spsr(cpsr);
+        registers.lr(return_address);
+        registers.cpsr_set_i(true);
+        registers.cpsr_set_t(false);
+        registers.pc(vector);
+
+        // Exceptions are always handled in ARM state
+        _state = cpu_state::arm;
+    }
+
     void cpu::execute(const arm::instruction instr, const u32 opcode) noexcept {
+        ARM7TDMI_STATISTIC(_statistics.arm[static_cast<size_t>(instr)]);
         switch(instr) {
             case arm::instruction::branch_and_exchange: execute_arm_branch_and_exchange(opcode); break;
             case arm::instruction::block_data_transfer: execute_arm_block_data_transfer(opcode); break;
@@ -31,6 +673,7 @@ namespace arm7tdmi {
         }
     }
         void cpu::execute(const thumb::instruction instr, const u16 opcode) noexcept {
+        ARM7TDMI_STATISTIC(_statistics.thumb[static_cast<size_t>(instr)]);
         switch(instr) {
             case thumb::instruction::software_interrupt: execute_thumb_software_interrupt(opcode); break;
             case thumb::instruction::unconditional_branch: execute_thumb_unconditional_branch(opcode); break;
@@ -59,7 +702,7 @@ namespace arm7tdmi {
 
     void cpu::execute_arm_branch_and_exchange(const u32 instr) noexcept {
 
-        if (!check_condition(instr))
+        if (!condition_passed(instr))
             return;
 
         // register number
@@ -78,11 +721,15 @@ namespace arm7tdmi {
         }
 
         // if bit 0 of RN == 1 subsequent instructions are THUMB, else ARM
+        if (_state != exchange_mode) {
+            ARM7TDMI_STATISTIC(_statistics.state_switches);
+        }
         _state = exchange_mode;
+        _branched = true;
     }
 
     void cpu::execute_arm_block_data_transfer(const u32 instr) noexcept {
-        if (!check_condition(instr))
+        if (!condition_passed(instr))
             return;
 
         const bool load = util::bit_check(instr, 20u);
@@ -134,7 +781,7 @@ namespace arm7tdmi {
             }
             if (load) {
                 u32 result;
-                if (_memory->read<u32>(addr, &result)) {
+                if (read<u32>(addr, &result)) {
                     registers.set(register_list[i], result);
                 }
                 else {
@@ -143,7 +790,7 @@ namespace arm7tdmi {
                 }
             }
             else {
-                if (!_memory->write<u32>(addr, registers.get(register_list[i]))) {
+                if (!write<u32>(addr, registers.get(register_list[i]))) {
                     // TODO(Thomas): Address invalid, raise data abort signal
                     return;
                 }
@@ -154,6 +801,10 @@ namespace arm7tdmi {
         }
 
 
+        if (load && r15_in_list) {
+            _branched = true;
+        }
+
         if (psr && r15_in_list) {
             // Instruction is LDM and R15 in list, mode changes
             registers.cpsr(registers.spsr());
@@ -171,7 +822,7 @@ namespace arm7tdmi {
 
     void cpu::execute_arm_branch(const u32 instr) noexcept {
 
-        if (!check_condition(instr))
+        if (!condition_passed(instr))
             return;
 
         const u32 opcode = util::bit_check(instr, 24);
@@ -179,6 +830,7 @@ namespace arm7tdmi {
         const i32 offset = util::twos_compliment(instr, 24);
         const u32 calling_pc = registers.pc();
         registers.pc(calling_pc + 8u + offset * 4u);
+        _branched = true;
 
         if (opcode == 1u) // branch with link - return address in REG_LR
         {
@@ -187,6 +839,11 @@ namespace arm7tdmi {
     }
 
     void cpu::execute_arm_software_interrupt(const u32 instr) noexcept {
+        if (!condition_passed(instr))
+            return;
+
+        // 24 bit comment field, BIOS function numbers are its top byte
+        software_interrupt(instr & 0xffffffu, (instr >> 16) & 0xffu, sizeof(u32));
     }
 
     void cpu::execute_arm_undefined(const u32 instr) noexcept {
@@ -222,65 +879,101 @@ namespace arm7tdmi {
     void cpu::execute_arm_unknown(const u32 instr) noexcept {
     }
 
-    bool cpu::check_condition(const u32 instr) const noexcept {
-
-        u32 cond = (instr >> 28) & 0xf;
-
-        const u8 N = registers.cpsr_get_n();
-        const u8 Z = registers.cpsr_get_z();
-        const u8 C = registers.cpsr_get_c();
-        const u8 V = registers.cpsr_get_v();
-
-        switch(static_cast<condition_code>(cond))
-        {
-            case condition_code::equal:
-                return Z == 1;
-            case condition_code::nequal:
-                return Z == 0;
-            case condition_code::unsigned_higher_or_same:
-                return C == 1;
-            case condition_code::unsigned_lower:
-                return C == 0;
-            case condition_code::negative:
-                return N == 1;
-            case condition_code::positive_or_zero:
-                return N == 0;
-            case condition_code::overflow:
-                return V == 1;
-            case condition_code::unsigned_higher:
-                return C == 1 && Z == 0;
-            case condition_code::unsigned_lower_or_same:
-                return C == 0 || Z == 1;
-            case condition_code::greater_or_equal:
-                return N == V;
-            case condition_code::less_than:
-                return N != V;
-            case condition_code::greater_than:
-                return Z == 0 && N == V;
-            case condition_code::less_than_or_equal:
-                return Z == 1 || N != V;
-            case condition_code::always:
-                return true;
-            case condition_code::never:
-                return false;
-            default:
-                return true;
+    bool cpu::condition_passed(const u32 instr) noexcept {
+        if (check_condition(instr)) {
+            return true;
         }
+        ARM7TDMI_STATISTIC(_statistics.condition_failed);
+        return false;
     }
 
-    void cpu::execute_thumb_software_interrupt(u16 instr) noexcept {
+    bool cpu::check_condition(const u32 instr) const noexcept {
+        return util::condition_passed(registers.cpsr(), instr >> 28);
     }
 
-    void cpu::execute_thumb_unconditional_branch(u16 instr) noexcept {
+    void cpu::execute_thumb_software_interrupt(const u16 instr) noexcept {
+        software_interrupt(instr & 0xffu, instr & 0xffu, sizeof(u16));
     }
 
-    void cpu::execute_thumb_conditional_branch(u16 instr) noexcept {
+    void cpu::execute_thumb_unconditional_branch(const u16 instr) noexcept {
+        const i32 offset = static_cast<i32>(static_cast<u32>(instr) << 21) >> 21;
+        registers.pc(registers.pc() + 4u + static_cast<u32>(offset) * 2u);
+        _branched = true;
     }
 
-    void cpu::execute_thumb_multiple_load_store(u16 instr) noexcept {
+    void cpu::execute_thumb_conditional_branch(const u16 instr) noexcept {
+        // Condition in bits 11-8, moved to where check_condition expects it
+        if (!condition_passed(static_cast<u32>(instr) << 20))
+            return;
+
+        registers.pc(registers.pc() + 4u + static_cast<u32>(static_cast<i8>(instr & 0xffu)) * 2u);
+        _branched = true;
     }
 
-    void cpu::execute_thumb_long_branch_with_link(u16 instr) noexcept {
+    void cpu::execute_thumb_multiple_load_store(const u16 instr) noexcept {
+        const bool load = (instr & 0x800u) != 0;
+        const u32 rb = (instr >> 8) & 7u;
+        const u32 list = instr & 0xffu;
+        u32 address = registers.get(rb);
+
+        if (list == 0) {
+            // An empty list transfers r15 and moves the base by 16 words
+            if (load) {
+                u32 value = 0;
+                if (read<u32>(address, &value)) {
+                    registers.pc(value & ~1u);
+                    _branched = true;
+                }
+            }
+            else {
+                write<u32>(address, registers.pc() + 6u);
+            }
+            registers.set(rb, address + 0x40u);
+            return;
+        }
+
+        const u32 write_back_addr = address + std::popcount(list) * sizeof(u32);
+        for (u32 i = 0; i < 8; ++i) {
+            if (((list >> i) & 1u) == 0) {
+                continue;
+            }
+            if (load) {
+                u32 value = 0;
+                if (!read<u32>(address, &value)) {
+                    return;
+                }
+                registers.set(i, value);
+            }
+            else {
+                // The base is stored as written back unless it is the first register in the list
+                const bool first = (list & ((1u << i) - 1u)) == 0;
+                if (!write<u32>(address, i == rb && !first ? write_back_addr : registers.get(i))) {
+                    return;
+                }
+            }
+            address += sizeof(u32);
+        }
+
+        // A loaded base keeps the loaded value
+        if (!load || ((list >> rb) & 1u) == 0) {
+            registers.set(rb, write_back_addr);
+        }
+    }
+
+    void cpu::execute_thumb_long_branch_with_link(const u16 instr) noexcept {
+        const u32 offset = instr & 0x7ffu;
+        if ((instr & 0x800u) == 0) {
+            // First half: LR = PC + 4 + (sign extended offset << 12)
+            const i32 high = static_cast<i32>(offset << 21) >> 21;
+            registers.lr(registers.pc() + 4u + (static_cast<u32>(high) << 12));
+            return;
+        }
+
+        // Second half: branch to LR + (offset << 1), LR = address of the next instruction | 1
+        const u32 next = registers.pc() + 2u;
+        registers.pc(registers.lr() + (offset << 1));
+        registers.lr(next | 1u);
+        _branched = true;
     }
 
     void cpu::execute_thumb_add_offset_to_stack_pointer(u16 instr) noexcept {
@@ -298,7 +991,38 @@ namespace arm7tdmi {
     void cpu::execute_thumb_load_address(u16 instr) noexcept {
     }
 
-    void cpu::execute_thumb_load_store_with_immediate_offset(u16 instr) noexcept {
+    void cpu::execute_thumb_load_store_with_immediate_offset(const u16 instr) noexcept {
+        const bool byte = (instr & 0x1000u) != 0;
+        const bool load = (instr & 0x800u) != 0;
+        const u32 offset = (instr >> 6) & 0x1fu;
+        const u32 rb = (instr >> 3) & 7u;
+        const u32 rd = instr & 7u;
+
+        if (byte) {
+            const u32 address = registers.get(rb) + offset;
+            if (load) {
+                u8 value = 0;
+                if (read<u8>(address, &value)) {
+                    registers.set(rd, value);
+                }
+            }
+            else {
+                write<u8>(address, static_cast<u8>(registers.get(rd)));
+            }
+            return;
+        }
+
+        const u32 address = registers.get(rb) + (offset << 2);
+        if (load) {
+            // Misaligned word loads rotate the aligned word
+            u32 value = 0;
+            if (read<u32>(address, &value)) {
+                registers.set(rd, std::rotr(value, static_cast<int>((address & 3u) * 8)));
+            }
+        }
+        else {
+            write<u32>(address, registers.get(rd));
+        }
     }
 
     void cpu::execute_thumb_load_store_with_register_offset(u16 instr) noexcept {
@@ -316,7 +1040,26 @@ namespace arm7tdmi {
     void cpu::execute_thumb_alu_operations(u16 instr) noexcept {
     }
 
-    void cpu::execute_thumb_move_compare_add_subtract_immediate(u16 instr) noexcept {
+    void cpu::execute_thumb_move_compare_add_subtract_immediate(const u16 instr) noexcept {
+        const u32 rd = (instr >> 8) & 7u;
+        const u32 immediate = instr & 0xffu;
+
+        switch ((instr >> 11) & 3u) {
+            case 0: // MOV, C and V unaffected
+                registers.set(rd, immediate);
+                registers.cpsr_set_n(false);
+                registers.cpsr_set_z(immediate == 0);
+                break;
+            case 1: // CMP
+                subtract_with_flags(registers.get(rd), immediate);
+                break;
+            case 2: // ADD
+                registers.set(rd, add_with_flags(registers.get(rd), immediate));
+                break;
+            default: // SUB
+                registers.set(rd, subtract_with_flags(registers.get(rd), immediate));
+                break;
+        }
     }
 
     void cpu::execute_thumb_add_subtract(u16 instr) noexcept {
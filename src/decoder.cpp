@@ -2,6 +2,9 @@
 // Created by talexander on 9/3/2024.
 //
 
+#include <algorithm>
+#include <array>
+
 #include <arm7tdmi/decoder.h>
 
 namespace arm7tdmi {
@@ -114,6 +117,61 @@ namespace arm7tdmi {
             return instruction::unknown;
         }
 
+        namespace {
+            constexpr pattern pattern_table[] = {
+                {instruction::branch_and_exchange, 0x0ffffff0, 0x012fff10},
+                {instruction::block_data_transfer, 0x0e000000, 0x08000000},
+                {instruction::branch, 0x0e000000, 0x0a000000},
+                {instruction::software_interrupt, 0x0f000000, 0x0f000000},
+                {instruction::undefined, 0x0e000010, 0x06000010},
+                {instruction::single_data_transfer, 0x0c000000, 0x04000000},
+                {instruction::single_data_swap, 0x0f800ff0, 0x01000090},
+                {instruction::multiply, 0x0f8000f0, 0x00000090},
+                {instruction::multiply_long, 0x0f8000f0, 0x00800090},
+                {instruction::halfword_data_transfer_register, 0x0e400f90, 0x00000090},
+                {instruction::halfword_data_transfer_immediate, 0x0e400090, 0x00400090},
+                {instruction::psr_transfer_mrs, 0x0fbf0000, 0x010f0000},
+                {instruction::psr_transfer_msr, 0x0db0f000, 0x0120f000},
+                {instruction::data_processing, 0x0c000000, 0x00000000},
+            };
+
+            // Marks a decode_table entry whose instruction also depends on bits outside the index
+            constexpr u8 decode_table_fallback = 0xff;
+
+            // Indexed by bits 27-20 and 7-4, which every pattern but BX, PSR transfer, swap and
+            // halfword register transfer decodes from alone
+            constexpr std::array<u8, 4096> make_decode_table() noexcept {
+                constexpr u32 index_mask = 0x0ff000f0;
+                std::array<u8, 4096> table = {};
+                for (u32 index = 0; index < table.size(); ++index) {
+                    const u32 bits = (index & 0xff0) << 16 | (index & 0xf) << 4;
+                    table[index] = static_cast<u8>(instruction::unknown);
+                    for (const auto& p : pattern_table) {
+                        if ((bits & p.mask & index_mask) == (p.format & index_mask)) {
+                            table[index] = (p.mask & ~index_mask) ? decode_table_fallback : static_cast<u8>(p.instr);
+                            break;
+                        }
+                    }
+                }
+                return table;
+            }
+
+            constexpr auto decode_table = make_decode_table();
+        }
+
+        std::span<const pattern> patterns() noexcept {
+            return pattern_table;
+        }
+
+        void decode_batch(const std::span<const u32> opcodes, const std::span<instruction> out) noexcept {
+            const size_t size = std::min(opcodes.size(), out.size());
+            for (size_t i = 0; i < size; ++i) {
+                const u32 opcode = opcodes[i];
+                const u8 entry = decode_table[(opcode >> 16 & 0xff0) | (opcode >> 4 & 0xf)];
+                out[i] = entry == decode_table_fallback ? decode(opcode) : static_cast<instruction>(entry);
+            }
+        }
+
         
         const char * instruction_to_string(const instruction instr) noexcept {
             switch(instr) {
@@ -279,6 +337,60 @@ namespace arm7tdmi {
             return instruction::unknown;
         }
 
+        namespace {
+            constexpr pattern pattern_table[] = {
+                {instruction::software_interrupt, 0xff00, 0xdf00},
+                {instruction::unconditional_branch, 0xf800, 0xe000},
+                {instruction::conditional_branch, 0xf000, 0xd000},
+                {instruction::multiple_load_store, 0xf000, 0xc000},
+                {instruction::long_branch_with_link, 0xf000, 0xf000},
+                {instruction::add_offset_to_stack_pointer, 0xff00, 0xb000},
+                {instruction::push_pop_registers, 0xf600, 0xb400},
+                {instruction::load_store_halfword, 0xf000, 0x8000},
+                {instruction::sp_relative_load_store, 0xf000, 0x9000},
+                {instruction::load_address, 0xf000, 0xa000},
+                {instruction::load_store_with_immediate_offset, 0xe000, 0x6000},
+                {instruction::load_store_with_register_offset, 0xf200, 0x5000},
+                {instruction::load_store_sign_extended_byte_halfword, 0xf200, 0x5200},
+                {instruction::pc_relative_load, 0xf800, 0x4800},
+                {instruction::hi_register_operations_branch_exchange, 0xfc00, 0x4400},
+                {instruction::alu_operations, 0xfc00, 0x4000},
+                {instruction::move_compare_add_subtract_immediate, 0xe000, 0x2000},
+                {instruction::add_subtract, 0xf800, 0x1800},
+                {instruction::move_shifted_register, 0xe000, 0x0000},
+            };
+
+            // Every pattern decodes from the top byte alone
+            static_assert(std::all_of(std::begin(pattern_table), std::end(pattern_table), [](const pattern& p) { return (p.mask & 0xff) == 0; }));
+
+            constexpr std::array<instruction, 256> make_decode_table() noexcept {
+                std::array<instruction, 256> table = {};
+                for (u32 index = 0; index < table.size(); ++index) {
+                    table[index] = instruction::unknown;
+                    for (const auto& p : pattern_table) {
+                        if (((index << 8) & p.mask) == p.format) {
+                            table[index] = p.instr;
+                            break;
+                        }
+                    }
+                }
+                return table;
+            }
+
+            constexpr auto decode_table = make_decode_table();
+        }
+
+        std::span<const pattern> patterns() noexcept {
+            return pattern_table;
+        }
+
+        void decode_batch(const std::span<const u16> opcodes, const std::span<instruction> out) noexcept {
+            const size_t size = std::min(opcodes.size(), out.size());
+            for (size_t i = 0; i < size; ++i) {
+                out[i] = decode_table[opcodes[i] >> 8];
+            }
+        }
+
         const char * instruction_to_string(const instruction instr) noexcept {
             switch(instr) {
                 case instruction::software_interrupt: return "software_interrupt";
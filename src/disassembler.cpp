@@ -0,0 +1,653 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include <arm7tdmi/decoder.h>
+#include <arm7tdmi/disassembler.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        constexpr const char* register_names[16] = {
+            "r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", "r11", "r12", "sp", "lr", "pc"
+        };
+        constexpr const char* condition_names[16] = {
+            "eq", "ne", "cs", "cc", "mi", "pl", "vs", "vc", "hi", "ls", "ge", "lt", "gt", "le", "", "nv"
+        };
+        constexpr const char* shift_names[4] = {"lsl", "lsr", "asr", "ror"};
+
+        constexpr i32 sign_extend(const u32 value, const u32 bits) noexcept {
+            const u32 shift = 32 - bits;
+            return static_cast<i32>(value << shift) >> shift;
+        }
+
+        // Appends to a caller's buffer, silently dropping whatever does not fit
+        class line_writer {
+        public:
+            line_writer(char* buffer, const size_t size) noexcept
+                : _begin(buffer), _pos(buffer), _end(size ? buffer + size - 1 : buffer), _terminate(size != 0) {}
+
+            void put(const char c) noexcept {
+                if (_pos < _end) {
+                    *_pos++ = c;
+                }
+            }
+
+            void put(const char* text) noexcept {
+                while (*text) {
+                    put(*text++);
+                }
+            }
+
+            void reg(const u32 r) noexcept { put(register_names[r & 15u]); }
+            void cond(const u32 opcode) noexcept { put(condition_names[opcode >> 28]); }
+
+            void hex(const u32 value, const u32 min_digits = 1) noexcept {
+                constexpr char digits[] = "0123456789abcdef";
+                put("0x");
+                u32 count = 8;
+                while (count > min_digits && (value >> ((count - 1) * 4)) == 0) {
+                    --count;
+                }
+                while (count--) {
+                    put(digits[(value >> (count * 4)) & 0xfu]);
+                }
+            }
+
+            void dec(const u32 value) noexcept {
+                char digits[10];
+                u32 count = 0;
+                u32 rest = value;
+                do {
+                    digits[count++] = static_cast<char>('0' + rest % 10);
+                    rest /= 10;
+                } while (rest);
+                while (count) {
+                    put(digits[--count]);
+                }
+            }
+
+            // Immediates are decimal unless they are large enough to read better as hex
+            void imm(const u32 value, const bool negative = false) noexcept {
+                put('#');
+                if (negative) {
+                    put('-');
+                }
+                value < 0x10000 ? dec(value) : hex(value);
+            }
+
+            void address(const u32 value) noexcept { hex(value, 8); }
+
+            void register_list(const u32 list) noexcept {
+                put('{');
+                bool first = true;
+                for (u32 r = 0; r < 16;) {
+                    if (!((list >> r) & 1u)) {
+                        ++r;
+                        continue;
+                    }
+                    u32 last = r;
+                    while (last + 1 < 16 && ((list >> (last + 1)) & 1u)) {
+                        ++last;
+                    }
+                    if (!first) {
+                        put(", ");
+                    }
+                    first = false;
+
+                    reg(r);
+                    if (last - r >= 2) {
+                        put('-');
+                        reg(last);
+                    }
+                    else if (last == r + 1) {
+                        put(", ");
+                        reg(last);
+                    }
+                    r = last + 1;
+                }
+                put('}');
+            }
+
+            size_t finish() noexcept {
+                if (_terminate) {
+                    *_pos = '\0';
+                }
+                return static_cast<size_t>(_pos - _begin);
+            }
+
+        private:
+            char* _begin;
+            char* _pos;
+            char* _end;
+            bool _terminate;
+        };
+    }
+
+    namespace arm {
+
+        namespace {
+            // Register operand with an immediate or register shift, as used by data processing and single data transfer
+            void shifted_register(line_writer& w, const u32 opcode) noexcept {
+                const u32 type = (opcode >> 5) & 3u;
+                w.reg(opcode);
+                if (opcode & 0x10u) {
+                    w.put(", ");
+                    w.put(shift_names[type]);
+                    w.put(' ');
+                    w.reg(opcode >> 8);
+                    return;
+                }
+
+                const u32 amount = (opcode >> 7) & 31u;
+                if (type == 0 && amount == 0) {
+                    return;
+                }
+                if (type == 3 && amount == 0) {
+                    w.put(", rrx");
+                    return;
+                }
+                w.put(", ");
+                w.put(shift_names[type]);
+                w.put(" #");
+                w.dec(amount == 0 ? 32 : amount);
+            }
+
+            // [rn, offset]{!} or [rn], offset, with the offset written by write_offset
+            template <typename Offset>
+            void transfer_address(line_writer& w, const u32 opcode, const bool zero_offset, Offset write_offset) noexcept {
+                const bool pre = opcode & (1u << 24);
+                w.put('[');
+                w.reg(opcode >> 16);
+                if (pre) {
+                    if (!zero_offset) {
+                        w.put(", ");
+                        write_offset();
+                    }
+                    w.put(']');
+                    if (opcode & (1u << 21)) {
+                        w.put('!');
+                    }
+                }
+                else {
+                    w.put("], ");
+                    write_offset();
+                }
+            }
+
+            void data_processing(line_writer& w, const u32 opcode) noexcept {
+                constexpr const char* names[16] = {
+                    "and", "eor", "sub", "rsb", "add", "adc", "sbc", "rsc", "tst", "teq", "cmp", "cmn", "orr", "mov", "bic", "mvn"
+                };
+                const u32 op = (opcode >> 21) & 15u;
+                const bool compare = op >= 8 && op <= 11;
+                const bool move = op == 13 || op == 15;
+
+                w.put(names[op]);
+                w.cond(opcode);
+                if ((opcode & (1u << 20)) && !compare) {
+                    w.put('s');
+                }
+                w.put(' ');
+                if (!compare) {
+                    w.reg(opcode >> 12);
+                    w.put(", ");
+                }
+                if (!move) {
+                    w.reg(opcode >> 16);
+                    w.put(", ");
+                }
+
+                if (opcode & (1u << 25)) {
+                    w.imm(std::rotr(opcode & 0xffu, static_cast<int>((opcode >> 8) & 15u) * 2));
+                }
+                else {
+                    shifted_register(w, opcode);
+                }
+            }
+
+            void psr_transfer_mrs(line_writer& w, const u32 opcode) noexcept {
+                w.put("mrs");
+                w.cond(opcode);
+                w.put(' ');
+                w.reg(opcode >> 12);
+                w.put(opcode & (1u << 22) ? ", spsr" : ", cpsr");
+            }
+
+            void psr_transfer_msr(line_writer& w, const u32 opcode) noexcept {
+                w.put("msr");
+                w.cond(opcode);
+                w.put(opcode & (1u << 22) ? " spsr" : " cpsr");
+                if (const u32 fields = (opcode >> 16) & 15u; fields != 0) {
+                    w.put('_');
+                    if (fields & 8u) w.put('f');
+                    if (fields & 4u) w.put('s');
+                    if (fields & 2u) w.put('x');
+                    if (fields & 1u) w.put('c');
+                }
+                w.put(", ");
+                if (opcode & (1u << 25)) {
+                    w.imm(std::rotr(opcode & 0xffu, static_cast<int>((opcode >> 8) & 15u) * 2));
+                }
+                else {
+                    w.reg(opcode);
+                }
+            }
+
+            void multiply(line_writer& w, const u32 opcode) noexcept {
+                const bool accumulate = opcode & (1u << 21);
+                w.put(accumulate ? "mla" : "mul");
+                w.cond(opcode);
+                if (opcode & (1u << 20)) {
+                    w.put('s');
+                }
+                w.put(' ');
+                w.reg(opcode >> 16);
+                w.put(", ");
+                w.reg(opcode);
+                w.put(", ");
+                w.reg(opcode >> 8);
+                if (accumulate) {
+                    w.put(", ");
+                    w.reg(opcode >> 12);
+                }
+            }
+
+            void multiply_long(line_writer& w, const u32 opcode) noexcept {
+                constexpr const char* names[4] = {"umull", "umlal", "smull", "smlal"};
+                w.put(names[(opcode >> 21) & 3u]);
+                w.cond(opcode);
+                if (opcode & (1u << 20)) {
+                    w.put('s');
+                }
+                w.put(' ');
+                w.reg(opcode >> 12);
+                w.put(", ");
+                w.reg(opcode >> 16);
+                w.put(", ");
+                w.reg(opcode);
+                w.put(", ");
+                w.reg(opcode >> 8);
+            }
+
+            void single_data_swap(line_writer& w, const u32 opcode) noexcept {
+                w.put("swp");
+                w.cond(opcode);
+                if (opcode & (1u << 22)) {
+                    w.put('b');
+                }
+                w.put(' ');
+                w.reg(opcode >> 12);
+                w.put(", ");
+                w.reg(opcode);
+                w.put(", [");
+                w.reg(opcode >> 16);
+                w.put(']');
+            }
+
+            void single_data_transfer(line_writer& w, const u32 opcode, const u32 address) noexcept {
+                const bool reg_offset = opcode & (1u << 25);
+                const bool up = opcode & (1u << 23);
+                const u32 offset = opcode & 0xfffu;
+
+                w.put(opcode & (1u << 20) ? "ldr" : "str");
+                w.cond(opcode);
+                if (opcode & (1u << 22)) {
+                    w.put('b');
+                }
+                if (!(opcode & (1u << 24)) && (opcode & (1u << 21))) {
+                    w.put('t');
+                }
+                w.put(' ');
+                w.reg(opcode >> 12);
+                w.put(", ");
+
+                transfer_address(w, opcode, !reg_offset && offset == 0, [&]() noexcept {
+                    if (reg_offset) {
+                        if (!up) w.put('-');
+                        shifted_register(w, opcode);
+                    }
+                    else {
+                        w.imm(offset, !up);
+                    }
+                });
+
+                // Literal loads: show the address they read
+                if (!reg_offset && ((opcode >> 16) & 15u) == 15 && (opcode & (1u << 24))) {
+                    w.put(" ; ");
+                    w.address(up ? address + 8 + offset : address + 8 - offset);
+                }
+            }
+
+            void halfword_data_transfer(line_writer& w, const u32 opcode, const bool immediate) noexcept {
+                constexpr const char* suffixes[4] = {"", "h", "sb", "sh"};
+                const u32 sh = (opcode >> 5) & 3u;
+                const bool up = opcode & (1u << 23);
+                const u32 offset = ((opcode >> 4) & 0xf0u) | (opcode & 0xfu);
+
+                w.put(opcode & (1u << 20) ? "ldr" : "str");
+                w.cond(opcode);
+                w.put(suffixes[sh]);
+                w.put(' ');
+                w.reg(opcode >> 12);
+                w.put(", ");
+
+                transfer_address(w, opcode, immediate && offset == 0, [&]() noexcept {
+                    if (immediate) {
+                        w.imm(offset, !up);
+                    }
+                    else {
+                        if (!up) w.put('-');
+                        w.reg(opcode);
+                    }
+                });
+            }
+
+            void block_data_transfer(line_writer& w, const u32 opcode) noexcept {
+                constexpr const char* modes[4] = {"da", "ia", "db", "ib"};
+                w.put(opcode & (1u << 20) ? "ldm" : "stm");
+                w.cond(opcode);
+                w.put(modes[(opcode >> 23) & 3u]);
+                w.put(' ');
+                w.reg(opcode >> 16);
+                if (opcode & (1u << 21)) {
+                    w.put('!');
+                }
+                w.put(", ");
+                w.register_list(opcode & 0xffffu);
+                if (opcode & (1u << 22)) {
+                    w.put('^');
+                }
+            }
+
+            void format(line_writer& w, const instruction instr, const u32 opcode, const u32 address) noexcept {
+                switch (instr) {
+                    case instruction::branch_and_exchange:
+                        w.put("bx");
+                        w.cond(opcode);
+                        w.put(' ');
+                        w.reg(opcode);
+                        break;
+                    case instruction::block_data_transfer: block_data_transfer(w, opcode); break;
+                    case instruction::branch:
+                        w.put(opcode & (1u << 24) ? "bl" : "b");
+                        w.cond(opcode);
+                        w.put(' ');
+                        w.address(address + 8 + static_cast<u32>(sign_extend(opcode & 0xffffffu, 24)) * 4);
+                        break;
+                    case instruction::software_interrupt:
+                        w.put("swi");
+                        w.cond(opcode);
+                        w.put(' ');
+                        w.hex(opcode & 0xffffffu);
+                        break;
+                    case instruction::undefined: w.put("undefined"); break;
+                    case instruction::single_data_transfer: single_data_transfer(w, opcode, address); break;
+                    case instruction::single_data_swap: single_data_swap(w, opcode); break;
+                    case instruction::multiply: multiply(w, opcode); break;
+                    case instruction::multiply_long: multiply_long(w, opcode); break;
+                    case instruction::halfword_data_transfer_register:
+                    case instruction::halfword_data_transfer_immediate:
+                        if (((opcode >> 5) & 3u) == 0) {
+                            // Reserved encoding the decoder is lenient about
+                            w.put(".word ");
+                            w.hex(opcode, 8);
+                            break;
+                        }
+                        halfword_data_transfer(w, opcode, instr == instruction::halfword_data_transfer_immediate);
+                        break;
+                    case instruction::psr_transfer_mrs: psr_transfer_mrs(w, opcode); break;
+                    case instruction::psr_transfer_msr: psr_transfer_msr(w, opcode); break;
+                    case instruction::data_processing: data_processing(w, opcode); break;
+                    default:
+                        w.put(".word ");
+                        w.hex(opcode, 8);
+                        break;
+                }
+            }
+        }
+
+        size_t disassemble(const u32 opcode, const u32 address, char* buffer, const size_t size) noexcept {
+            line_writer w(buffer, size);
+            format(w, decode(opcode), opcode, address);
+            return w.finish();
+        }
+
+        size_t disassemble_batch(const std::span<const u32> opcodes, const u32 address, const std::span<char> out) noexcept {
+            const size_t lines = std::min(opcodes.size(), out.size() / disassembly_line_size);
+            std::array<instruction, 256> instrs;
+            for (size_t begin = 0; begin < lines; begin += instrs.size()) {
+                const size_t count = std::min(instrs.size(), lines - begin);
+                decode_batch(opcodes.subspan(begin, count), std::span(instrs.data(), count));
+                for (size_t i = 0; i < count; ++i) {
+                    const size_t line = begin + i;
+                    line_writer w(out.data() + line * disassembly_line_size, disassembly_line_size);
+                    format(w, instrs[i], opcodes[line], address + static_cast<u32>(line * sizeof(u32)));
+                    w.finish();
+                }
+            }
+            return lines;
+        }
+
+    }
+
+    namespace thumb {
+
+        namespace {
+            void low_register_pair(line_writer& w, const u16 opcode) noexcept {
+                w.reg(opcode & 7u);
+                w.put(", ");
+                w.reg((opcode >> 3) & 7u);
+            }
+
+            // [rb, #offset]
+            void immediate_address(line_writer& w, const u32 base, const u32 offset) noexcept {
+                w.put(" [");
+                w.reg(base);
+                w.put(", ");
+                w.imm(offset);
+                w.put(']');
+            }
+
+            void format(line_writer& w, const instruction instr, const u16 opcode, const u32 address) noexcept {
+                const u32 rd_high = (opcode >> 8) & 7u;
+
+                switch (instr) {
+                    case instruction::move_shifted_register: {
+                        const u32 type = (opcode >> 11) & 3u;
+                        const u32 amount = (opcode >> 6) & 31u;
+                        w.put(shift_names[type]);
+                        w.put(' ');
+                        low_register_pair(w, opcode);
+                        w.put(", #");
+                        w.dec(amount == 0 && type != 0 ? 32 : amount);
+                        break;
+                    }
+                    case instruction::add_subtract:
+                        w.put(opcode & (1u << 9) ? "sub " : "add ");
+                        low_register_pair(w, opcode);
+                        w.put(", ");
+                        if (opcode & (1u << 10)) {
+                            w.imm((opcode >> 6) & 7u);
+                        }
+                        else {
+                            w.reg((opcode >> 6) & 7u);
+                        }
+                        break;
+                    case instruction::move_compare_add_subtract_immediate: {
+                        constexpr const char* names[4] = {"mov ", "cmp ", "add ", "sub "};
+                        w.put(names[(opcode >> 11) & 3u]);
+                        w.reg(rd_high);
+                        w.put(", ");
+                        w.imm(opcode & 0xffu);
+                        break;
+                    }
+                    case instruction::alu_operations: {
+                        constexpr const char* names[16] = {
+                            "and ", "eor ", "lsl ", "lsr ", "asr ", "adc ", "sbc ", "ror ",
+                            "tst ", "neg ", "cmp ", "cmn ", "orr ", "mul ", "bic ", "mvn "
+                        };
+                        w.put(names[(opcode >> 6) & 15u]);
+                        low_register_pair(w, opcode);
+                        break;
+                    }
+                    case instruction::hi_register_operations_branch_exchange: {
+                        constexpr const char* names[4] = {"add ", "cmp ", "mov ", "bx "};
+                        const u32 op = (opcode >> 8) & 3u;
+                        const u32 rd = (opcode & 7u) | ((opcode >> 4) & 8u);
+                        const u32 rs = (opcode >> 3) & 15u;
+                        w.put(names[op]);
+                        if (op != 3) {
+                            w.reg(rd);
+                            w.put(", ");
+                        }
+                        w.reg(rs);
+                        break;
+                    }
+                    case instruction::pc_relative_load: {
+                        const u32 offset = (opcode & 0xffu) * 4;
+                        w.put("ldr ");
+                        w.reg(rd_high);
+                        w.put(",");
+                        immediate_address(w, 15, offset);
+                        w.put(" ; ");
+                        w.address(((address + 4) & ~3u) + offset);
+                        break;
+                    }
+                    case instruction::load_store_with_register_offset:
+                    case instruction::load_store_sign_extended_byte_halfword: {
+                        constexpr const char* names[4] = {"str ", "strb ", "ldr ", "ldrb "};
+                        constexpr const char* sign_extended[4] = {"strh ", "ldrsb ", "ldrh ", "ldrsh "};
+                        const u32 op = (opcode >> 10) & 3u;
+                        w.put(instr == instruction::load_store_with_register_offset ? names[op] : sign_extended[op]);
+                        w.reg(opcode & 7u);
+                        w.put(", [");
+                        w.reg((opcode >> 3) & 7u);
+                        w.put(", ");
+                        w.reg((opcode >> 6) & 7u);
+                        w.put(']');
+                        break;
+                    }
+                    case instruction::load_store_with_immediate_offset: {
+                        constexpr const char* names[4] = {"str ", "ldr ", "strb ", "ldrb "};
+                        const u32 op = (opcode >> 11) & 3u;
+                        const u32 offset = (opcode >> 6) & 31u;
+                        w.put(names[op]);
+                        w.reg(opcode & 7u);
+                        w.put(",");
+                        immediate_address(w, (opcode >> 3) & 7u, op & 2u ? offset : offset * 4);
+                        break;
+                    }
+                    case instruction::load_store_halfword:
+                        w.put(opcode & (1u << 11) ? "ldrh " : "strh ");
+                        w.reg(opcode & 7u);
+                        w.put(",");
+                        immediate_address(w, (opcode >> 3) & 7u, ((opcode >> 6) & 31u) * 2);
+                        break;
+                    case instruction::sp_relative_load_store:
+                        w.put(opcode & (1u << 11) ? "ldr " : "str ");
+                        w.reg(rd_high);
+                        w.put(",");
+                        immediate_address(w, 13, (opcode & 0xffu) * 4);
+                        break;
+                    case instruction::load_address:
+                        w.put("add ");
+                        w.reg(rd_high);
+                        w.put(opcode & (1u << 11) ? ", sp, " : ", pc, ");
+                        w.imm((opcode & 0xffu) * 4);
+                        break;
+                    case instruction::add_offset_to_stack_pointer:
+                        w.put(opcode & (1u << 7) ? "sub sp, " : "add sp, ");
+                        w.imm((opcode & 0x7fu) * 4);
+                        break;
+                    case instruction::push_pop_registers: {
+                        const bool pop = opcode & (1u << 11);
+                        const u32 extra = (opcode & (1u << 8)) ? (pop ? 1u << 15 : 1u << 14) : 0;
+                        w.put(pop ? "pop " : "push ");
+                        w.register_list((opcode & 0xffu) | extra);
+                        break;
+                    }
+                    case instruction::multiple_load_store:
+                        w.put(opcode & (1u << 11) ? "ldmia " : "stmia ");
+                        w.reg(rd_high);
+                        w.put("!, ");
+                        w.register_list(opcode & 0xffu);
+                        break;
+                    case instruction::conditional_branch: {
+                        const u32 cond = (opcode >> 8) & 15u;
+                        if (cond == 14) {
+                            w.put("undefined");
+                            break;
+                        }
+                        w.put('b');
+                        w.put(condition_names[cond]);
+                        w.put(' ');
+                        w.address(address + 4 + static_cast<u32>(sign_extend(opcode & 0xffu, 8)) * 2);
+                        break;
+                    }
+                    case instruction::software_interrupt:
+                        w.put("swi ");
+                        w.hex(opcode & 0xffu);
+                        break;
+                    case instruction::unconditional_branch:
+                        w.put("b ");
+                        w.address(address + 4 + static_cast<u32>(sign_extend(opcode & 0x7ffu, 11)) * 2);
+                        break;
+                    case instruction::long_branch_with_link:
+                        if (opcode & (1u << 11)) {
+                            w.put("bl.lo ");
+                            w.imm((opcode & 0x7ffu) * 2);
+                        }
+                        else {
+                            w.put("bl.hi ");
+                            w.address(address + 4 + (static_cast<u32>(sign_extend(opcode & 0x7ffu, 11)) << 12));
+                        }
+                        break;
+                    default:
+                        w.put(".hword ");
+                        w.hex(opcode, 4);
+                        break;
+                }
+            }
+        }
+
+        size_t disassemble(const u16 opcode, const u32 address, char* buffer, const size_t size) noexcept {
+            line_writer w(buffer, size);
+            format(w, decode(opcode), opcode, address);
+            return w.finish();
+        }
+
+        size_t disassemble_batch(const std::span<const u16> opcodes, const u32 address, const std::span<char> out) noexcept {
+            const size_t lines = std::min(opcodes.size(), out.size() / disassembly_line_size);
+            std::array<instruction, 256> instrs;
+            for (size_t begin = 0; begin < lines; begin += instrs.size()) {
+                const size_t count = std::min(instrs.size(), lines - begin);
+                decode_batch(opcodes.subspan(begin, count), std::span(instrs.data(), count));
+                for (size_t i = 0; i < count; ++i) {
+                    const size_t line = begin + i;
+                    const u16 opcode = opcodes[line];
+                    const u32 pc = address + static_cast<u32>(line * sizeof(u16));
+                    line_writer w(out.data() + line * disassembly_line_size, disassembly_line_size);
+
+                    // A prefix followed by its suffix is one instruction as far as the reader is concerned
+                    constexpr u16 prefix_mask = 0xf800, prefix = 0xf000, suffix = 0xf800;
+                    if ((opcode & prefix_mask) == prefix && line + 1 < opcodes.size() && (opcodes[line + 1] & prefix_mask) == suffix) {
+                        const u32 target = pc + 4 + (static_cast<u32>(sign_extend(opcode & 0x7ffu, 11)) << 12) + (opcodes[line + 1] & 0x7ffu) * 2;
+                        w.put("bl ");
+                        w.address(target);
+                    }
+                    else {
+                        format(w, instrs[i], opcode, pc);
+                    }
+                    w.finish();
+                }
+            }
+            return lines;
+        }
+
+    }
+}
@@ -0,0 +1,201 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        constexpr u16 machine_arm = 40;
+        constexpr u32 segment_load = 1;
+        constexpr u32 segment_executable = 1;
+        constexpr u32 section_symtab = 2;
+        constexpr u8 symbol_notype = 0;
+        constexpr u8 symbol_func = 2;
+
+        constexpr size_t header_size = 52;
+        constexpr size_t program_header_size = 32;
+        constexpr size_t section_header_size = 40;
+        constexpr size_t symbol_size = 16;
+
+        template <typename T>
+        bool read_at(const std::vector<u8>& data, const size_t offset, T* out) noexcept {
+            if (offset > data.size() || data.size() - offset < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(out, data.data() + offset, sizeof(T));
+            return true;
+        }
+    }
+
+    bool elf_image::load(std::istream& in) noexcept {
+        return load(std::vector<u8>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+    }
+
+    bool elf_image::load(std::vector<u8> data) noexcept {
+        _data = std::move(data);
+        _entry = 0;
+        _segments.clear();
+        _symbols.clear();
+        return parse();
+    }
+
+    bool elf_image::parse() noexcept {
+        constexpr u8 magic[4] = {0x7f, 'E', 'L', 'F'};
+        if (_data.size() < header_size || !std::equal(std::begin(magic), std::end(magic), _data.begin())) {
+            return false;
+        }
+        // 32 bit, little endian
+        if (_data[4] != 1 || _data[5] != 1) {
+            return false;
+        }
+
+        u16 machine = 0, phentsize = 0, phnum = 0, shentsize = 0, shnum = 0;
+        u32 phoff = 0, shoff = 0;
+        read_at(_data, 18, &machine);
+        read_at(_data, 24, &_entry);
+        read_at(_data, 28, &phoff);
+        read_at(_data, 32, &shoff);
+        read_at(_data, 42, &phentsize);
+        read_at(_data, 44, &phnum);
+        read_at(_data, 46, &shentsize);
+        read_at(_data, 48, &shnum);
+        if (machine != machine_arm) {
+            return false;
+        }
+
+        if (phnum != 0 && phentsize < program_header_size) {
+            return false;
+        }
+        for (u32 i = 0; i < phnum; ++i) {
+            const size_t at = phoff + static_cast<size_t>(i) * phentsize;
+            u32 type = 0;
+            u32 flags = 0;
+            elf_segment segment;
+            if (!read_at(_data, at, &type)
+                || !read_at(_data, at + 4, &segment.offset)
+                || !read_at(_data, at + 8, &segment.address)
+                || !read_at(_data, at + 16, &segment.file_size)
+                || !read_at(_data, at + 20, &segment.memory_size)
+                || !read_at(_data, at + 24, &flags)) {
+                return false;
+            }
+            segment.executable = flags & segment_executable;
+            if (type != segment_load) {
+                continue;
+            }
+            if (static_cast<size_t>(segment.offset) + segment.file_size > _data.size()) {
+                return false;
+            }
+            _segments.push_back(segment);
+        }
+
+        if (shnum != 0 && shentsize < section_header_size) {
+            return false;
+        }
+        for (u32 i = 0; i < shnum; ++i) {
+            const size_t at = shoff + static_cast<size_t>(i) * shentsize;
+            u32 type = 0, offset = 0, size = 0, link = 0;
+            if (!read_at(_data, at + 4, &type)
+                || !read_at(_data, at + 16, &offset)
+                || !read_at(_data, at + 20, &size)
+                || !read_at(_data, at + 24, &link)) {
+                return false;
+            }
+            if (type != section_symtab) {
+                continue;
+            }
+
+            // The linked section holds the symbol names
+            u32 strings = 0, strings_size = 0;
+            if (link >= shnum
+                || !read_at(_data, shoff + static_cast<size_t>(link) * shentsize + 16, &strings)
+                || !read_at(_data, shoff + static_cast<size_t>(link) * shentsize + 20, &strings_size)
+                || static_cast<size_t>(strings) + strings_size > _data.size()) {
+                return false;
+            }
+
+            for (size_t s = offset; s + symbol_size <= static_cast<size_t>(offset) + size; s += symbol_size) {
+                u32 name = 0, value = 0, symbol_bytes = 0;
+                u8 info = 0;
+                u16 section = 0;
+                if (!read_at(_data, s, &name)
+                    || !read_at(_data, s + 4, &value)
+                    || !read_at(_data, s + 8, &symbol_bytes)
+                    || !read_at(_data, s + 12, &info)
+                    || !read_at(_data, s + 14, &section)) {
+                    return false;
+                }
+
+                const u8 kind = info & 0xf;
+                if (section == 0 || name >= strings_size || (kind != symbol_notype && kind != symbol_func)) {
+                    continue;
+                }
+
+                const char* begin = reinterpret_cast<const char*>(_data.data() + strings + name);
+                const size_t length = strnlen(begin, strings_size - name);
+                if (length == 0 || begin[0] == '$') {
+                    continue;
+                }
+
+                elf_symbol symbol;
+                symbol.name.assign(begin, length);
+                symbol.thumb = kind == symbol_func && (value & 1u);
+                symbol.address = symbol.thumb ? value & ~1u : value;
+                symbol.size = symbol_bytes;
+                _symbols.push_back(std::move(symbol));
+            }
+        }
+
+        std::stable_sort(_symbols.begin(), _symbols.end(), [](const elf_symbol& a, const elf_symbol& b) {
+            return a.address < b.address;
+        });
+        return true;
+    }
+
+    const elf_symbol* elf_image::find(const u32 address) const noexcept {
+        auto it = std::upper_bound(_symbols.begin(), _symbols.end(), address, [](const u32 value, const elf_symbol& symbol) {
+            return value < symbol.address;
+        });
+        if (it == _symbols.begin()) {
+            return nullptr;
+        }
+        --it;
+
+        // Prefer a sized symbol at the same address over a label
+        const u32 start = it->address;
+        for (auto candidate = it; candidate->address == start; --candidate) {
+            if (candidate->size != 0) {
+                it = candidate;
+                break;
+            }
+            if (candidate == _symbols.begin()) {
+                break;
+            }
+        }
+
+        if (it->size != 0 && address - it->address >= it->size) {
+            return nullptr;
+        }
+        return &*it;
+    }
+
+    bool elf_image::load_segments(memory_interface& memory) const noexcept {
+        for (const auto& segment : _segments) {
+            if (static_cast<u64>(segment.address) + segment.memory_size > memory.size()) {
+                return false;
+            }
+            for (u32 i = 0; i < segment.memory_size; ++i) {
+                const u8 value = i < segment.file_size ? _data[segment.offset + i] : 0;
+                memory.write<u8>(segment.address + i, value);
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,188 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <arm7tdmi/farm.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        struct instance {
+            size_t job = 0;
+            u32 last_worker = 0;
+            std::unique_ptr<basic_memory> memory;
+            std::unique_ptr<cpu> core;
+        };
+
+        struct worker_queue {
+            std::mutex mutex;
+            std::deque<instance*> jobs;
+
+            instance* pop_front() noexcept {
+                std::lock_guard lock(mutex);
+                if (jobs.empty()) return nullptr;
+                instance* job = jobs.front();
+                jobs.pop_front();
+                return job;
+            }
+
+            instance* steal() noexcept {
+                std::lock_guard lock(mutex);
+                if (jobs.empty()) return nullptr;
+                instance* job = jobs.back();
+                jobs.pop_back();
+                return job;
+            }
+
+            void push_back(instance* job) noexcept {
+                std::lock_guard lock(mutex);
+                jobs.push_back(job);
+            }
+        };
+
+        struct worker_statistics {
+            u64 cycles = 0;
+            u64 slices = 0;
+            u64 steals = 0;
+        };
+    }
+
+    execution_farm::execution_farm(const farm_config config) noexcept : _config(config) {
+        if (_config.threads == 0) {
+            _config.threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        _config.slice = std::max<u64>(_config.slice, 1);
+    }
+
+    std::vector<farm_result> execution_farm::run(const std::vector<farm_job>& jobs) noexcept {
+        _statistics = {};
+        std::vector<farm_result> results(jobs.size());
+        if (jobs.empty()) {
+            return results;
+        }
+
+        const u32 worker_count = static_cast<u32>(std::min<size_t>(_config.threads, jobs.size()));
+        std::vector<instance> instances(jobs.size());
+        std::vector<worker_queue> queues(worker_count);
+        std::vector<worker_statistics> worker_stats(worker_count);
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            instances[i].job = i;
+            instances[i].last_worker = static_cast<u32>(i % worker_count);
+            queues[i % worker_count].jobs.push_back(&instances[i]);
+        }
+
+        std::atomic<size_t> remaining = jobs.size();
+
+        // Runs one slice of the job, returns true once it has finished
+        auto run_slice = [&](instance& inst, const u32 worker) noexcept {
+            const farm_job& job = jobs[inst.job];
+            farm_result& result = results[inst.job];
+
+            const auto start = std::chrono::steady_clock::now();
+
+            if (!inst.core) {
+                inst.memory = std::make_unique<basic_memory>(job.memory_size);
+                inst.core = std::make_unique<cpu>(inst.memory.get());
+                if (job.setup) {
+                    job.setup(*inst.core, *inst.memory);
+                }
+            }
+
+            cpu& core = *inst.core;
+            const u64 slice_start = core.get_cycles();
+            const u64 slice_end = std::min(job.max_cycles, slice_start + std::min(_config.slice, job.max_cycles - slice_start));
+
+            bool finished = false;
+            result.status = farm_status::cycle_limit;
+            while (core.get_cycles() < slice_end) {
+                if (!core.step()) {
+                    result.status = farm_status::fault;
+                    finished = true;
+                    break;
+                }
+                if (job.done && job.done(core, *inst.memory)) {
+                    result.status = farm_status::completed;
+                    finished = true;
+                    break;
+                }
+            }
+            finished |= core.get_cycles() >= job.max_cycles;
+
+            result.slices++;
+            result.migrations += inst.last_worker != worker;
+            inst.last_worker = worker;
+            result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            worker_stats[worker].cycles += core.get_cycles() - slice_start;
+            worker_stats[worker].slices++;
+
+            if (finished) {
+                result.registers = core.registers;
+                result.state = core.get_state();
+                result.cycles = core.get_cycles();
+                if (job.finish) {
+                    job.finish(core, *inst.memory);
+                }
+                inst.core.reset();
+                inst.memory.reset();
+            }
+            return finished;
+        };
+
+        auto work = [&](const u32 worker) noexcept {
+            while (remaining.load(std::memory_order_acquire) > 0) {
+                instance* inst = queues[worker].pop_front();
+
+                for (u32 i = 1; inst == nullptr && i < worker_count; ++i) {
+                    inst = queues[(worker + i) % worker_count].steal();
+                    worker_stats[worker].steals += inst != nullptr;
+                }
+
+                if (inst == nullptr) {
+                    // Everything left is mid-slice on another worker
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if (run_slice(*inst, worker)) {
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                }
+                else {
+                    queues[worker].push_back(inst);
+                }
+            }
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        threads.reserve(worker_count - 1);
+        for (u32 worker = 1; worker < worker_count; ++worker) {
+            threads.emplace_back(work, worker);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        _statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (const auto& stats : worker_stats) {
+            _statistics.cycles += stats.cycles;
+            _statistics.slices += stats.slices;
+            _statistics.steals += stats.steals;
+        }
+
+        return results;
+    }
+}
@@ -0,0 +1,77 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/hle.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    void hle_hooks::add(const u32 address, hle_function function) noexcept {
+        _hooks[address & ~1u] = std::move(function);
+        _filter |= u64{1} << ((address >> 1) & 63u);
+    }
+
+    void hle_hooks::add_signature(const u64 hash, const u32 size, hle_function function) noexcept {
+        _signatures.push_back({hash, size, std::move(function)});
+    }
+
+    bool hle_hooks::signature(const memory_interface& memory, const u32 address, const u32 size, u64* out) noexcept {
+        u64 hash = 0xcbf29ce484222325;
+        for (u32 i = 0; i < size; ++i) {
+            u8 byte = 0;
+            if (!memory.read<u8>(address + i, &byte)) {
+                return false;
+            }
+            hash = (hash ^ byte) * 0x100000001b3;
+        }
+        *out = hash;
+        return true;
+    }
+
+    bool hle_hooks::resolve_at(const memory_interface& memory, const u32 address) noexcept {
+        for (const auto& pattern : _signatures) {
+            u64 hash = 0;
+            if (signature(memory, address, pattern.size, &hash) && hash == pattern.hash) {
+                add(address, pattern.function);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    u32 hle_hooks::resolve(const memory_interface& memory, const u32 begin, const u32 end) noexcept {
+        u32 hooked = 0;
+        for (u64 address = begin & ~1u; address < end; address += sizeof(u16)) {
+            hooked += resolve_at(memory, static_cast<u32>(address));
+        }
+        return hooked;
+    }
+
+    u32 hle_hooks::resolve(const memory_interface& memory, const elf_image& image) noexcept {
+        u32 hooked = 0;
+        for (const auto& symbol : image.symbols()) {
+            hooked += resolve_at(memory, symbol.address);
+        }
+        return hooked;
+    }
+
+    void hle_hooks::remove(const u32 address) noexcept {
+        _hooks.erase(address & ~1u);
+        rebuild_filter();
+    }
+
+    void hle_hooks::clear() noexcept {
+        _hooks.clear();
+        _signatures.clear();
+        _filter = 0;
+    }
+
+    void hle_hooks::rebuild_filter() noexcept {
+        _filter = 0;
+        for (const auto& [address, function] : _hooks) {
+            _filter |= u64{1} << ((address >> 1) & 63u);
+        }
+    }
+}
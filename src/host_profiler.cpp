@@ -0,0 +1,184 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <chrono>
+
+#include <fmt/format.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/host_profiler.h>
+#include <arm7tdmi/memory.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        constexpr u32 calibration_readings = 1000;
+
+        u64 timestamp() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return static_cast<u64>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+#if defined(__linux__)
+        int open_counter(const u64 config, const int group) noexcept {
+            perf_event_attr attr = {};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config;
+            attr.disabled = group == -1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+        }
+#endif
+
+        u64 difference(const u64 before, const u64 after) noexcept {
+            return after > before ? after - before : 0;
+        }
+    }
+
+    host_counters::host_counters() noexcept {
+#if defined(__linux__)
+        _fds[0] = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (_fds[0] == -1) {
+            return;
+        }
+        // Either of these may be missing, e.g. in a virtual machine, and just reads as zero
+        _fds[1] = open_counter(PERF_COUNT_HW_BRANCH_MISSES, _fds[0]);
+        _fds[2] = open_counter(PERF_COUNT_HW_CACHE_MISSES, _fds[0]);
+
+        ioctl(_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        _source = host_counter_source::perf_event;
+#endif
+    }
+
+    host_counters::~host_counters() noexcept {
+#if defined(__linux__)
+        for (const int fd : _fds) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    void host_counters::read(host_cost* out) const noexcept {
+#if defined(__linux__)
+        if (_source == host_counter_source::perf_event) {
+            // [number of counters][value]..., in the order they were opened
+            u64 values[4] = {};
+            if (::read(_fds[0], values, sizeof(values)) > 0) {
+                u64 index = 1;
+                out->cycles = values[index++];
+                out->branch_misses = _fds[1] != -1 && index <= values[0] ? values[index++] : 0;
+                out->cache_misses = _fds[2] != -1 && index <= values[0] ? values[index] : 0;
+            }
+            return;
+        }
+#endif
+        out->cycles = timestamp();
+    }
+
+    host_profiler::host_profiler(memory_interface* memory) noexcept : _memory(memory) {
+        calibrate();
+    }
+
+    void host_profiler::calibrate() noexcept {
+        host_cost before, after, total;
+        for (u32 i = 0; i < calibration_readings; ++i) {
+            _counters.read(&before);
+            _counters.read(&after);
+            total.cycles += difference(before.cycles, after.cycles);
+            total.branch_misses += difference(before.branch_misses, after.branch_misses);
+            total.cache_misses += difference(before.cache_misses, after.cache_misses);
+        }
+        _overhead.cycles = total.cycles / calibration_readings;
+        _overhead.branch_misses = total.branch_misses / calibration_readings;
+        _overhead.cache_misses = total.cache_misses / calibration_readings;
+    }
+
+    void host_profiler::clear() noexcept {
+        _arm = {};
+        _thumb = {};
+    }
+
+    void host_profiler::accumulate(host_cost& cost, const host_cost& before, const host_cost& after) const noexcept {
+        cost.count++;
+        cost.cycles += difference(before.cycles + _overhead.cycles, after.cycles);
+        cost.branch_misses += difference(before.branch_misses + _overhead.branch_misses, after.branch_misses);
+        cost.cache_misses += difference(before.cache_misses + _overhead.cache_misses, after.cache_misses);
+    }
+
+    bool host_profiler::step(cpu& cpu) noexcept {
+        if (!_memory) {
+            return false;
+        }
+        if (cpu.irq_pending()) {
+            return cpu.step();
+        }
+
+        host_cost before, after;
+        if (cpu.get_state() == cpu_state::arm) {
+            u32 opcode = 0;
+            if (!_memory->read<u32>(cpu.registers.pc(), &opcode)) {
+                return false;
+            }
+            const auto instr = arm::decode(opcode);
+            _counters.read(&before);
+            cpu.dispatch(instr, opcode);
+            _counters.read(&after);
+            accumulate(_arm[static_cast<size_t>(instr)], before, after);
+        }
+        else {
+            u16 opcode = 0;
+            if (!_memory->read<u16>(cpu.registers.pc(), &opcode)) {
+                return false;
+            }
+            const auto instr = thumb::decode(opcode);
+            _counters.read(&before);
+            cpu.dispatch(instr, opcode);
+            _counters.read(&after);
+            accumulate(_thumb[static_cast<size_t>(instr)], before, after);
+        }
+        return true;
+    }
+
+    void host_profiler::write_report(std::ostream& out) const noexcept {
+        const bool perf = source() == host_counter_source::perf_event;
+        out << fmt::format("{:<48}{:>12}{:>14}{:>16}{:>16}\n", "class", "count",
+            perf ? "cycles" : "ticks", "branch misses", "cache misses");
+
+        auto row = [&](const char* state, const char* name, const host_cost& cost) {
+            if (cost.count == 0) {
+                return;
+            }
+            const auto n = static_cast<double>(cost.count);
+            out << fmt::format("{:<48}{:>12}{:>14.1f}{:>16.3f}{:>16.3f}\n", fmt::format("{} {}", state, name), cost.count,
+                cost.cycles / n, cost.branch_misses / n, cost.cache_misses / n);
+        };
+
+        for (size_t i = 0; i < _arm.size(); ++i) {
+            row("arm", arm::instruction_to_string(static_cast<arm::instruction>(i)), _arm[i]);
+        }
+        for (size_t i = 0; i < _thumb.size(); ++i) {
+            row("thumb", thumb::instruction_to_string(static_cast<thumb::instruction>(i)), _thumb[i]);
+        }
+    }
+}
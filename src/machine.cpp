@@ -0,0 +1,104 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <barrier>
+#include <thread>
+
+#include <arm7tdmi/machine.h>
+
+namespace arm7tdmi {
+
+    void machine::core_bus::commit() noexcept {
+        for (const u32 address : _order) {
+            _memory->write<u8>(address, _pending[address]);
+        }
+        _pending.clear();
+        _order.clear();
+    }
+
+    bool machine::core_bus::read_byte(const u32 address, u8* out) const noexcept {
+        if (_pending.empty()) {
+            return _memory->read<u8>(address, out);
+        }
+        if (const auto it = _pending.find(address); it != _pending.end()) {
+            *out = it->second;
+            return true;
+        }
+        return _memory->read<u8>(address, out);
+    }
+
+    bool machine::core_bus::write_byte(const size_t address, const u8 value) noexcept {
+        if (address >= _memory->size()) {
+            return false;
+        }
+
+        const auto addr = static_cast<u32>(address);
+        if (_pending.insert_or_assign(addr, value).second) {
+            _order.push_back(addr);
+        }
+        return true;
+    }
+
+    machine::machine(memory_interface* memory, const machine_config config) noexcept
+        : _memory(memory), _config(config) {
+        _config.quantum = std::max<u64>(_config.quantum, 1);
+        _cores.reserve(_config.cores);
+        for (u32 i = 0; i < _config.cores; ++i) {
+            _cores.push_back(std::make_unique<core_state>(memory));
+        }
+    }
+
+    machine::~machine() noexcept = default;
+
+    void machine::run_quantum(core_state& state) const noexcept {
+        const u64 end = state.core.get_cycles() + _config.quantum;
+        while (!state.halted && state.core.get_cycles() < end) {
+            state.halted = !state.core.step();
+        }
+    }
+
+    void machine::commit() noexcept {
+        for (const auto& state : _cores) {
+            state->bus.commit();
+        }
+        ++_quanta;
+    }
+
+    void machine::run(const u64 quanta) noexcept {
+        if (_cores.empty() || quanta == 0) {
+            return;
+        }
+
+        if (_config.mode == machine_mode::interleaved || _cores.size() == 1) {
+            for (u64 q = 0; q < quanta; ++q) {
+                for (const auto& state : _cores) {
+                    run_quantum(*state);
+                }
+                commit();
+            }
+            return;
+        }
+
+        // The barrier's completion step runs on exactly one thread once every core has finished its quantum
+        std::barrier boundary(static_cast<std::ptrdiff_t>(_cores.size()), [this]() noexcept { commit(); });
+
+        auto work = [&](core_state& state) noexcept {
+            for (u64 q = 0; q < quanta; ++q) {
+                run_quantum(state);
+                boundary.arrive_and_wait();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(_cores.size() - 1);
+        for (size_t i = 1; i < _cores.size(); ++i) {
+            threads.emplace_back(work, std::ref(*_cores[i]));
+        }
+        work(*_cores[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
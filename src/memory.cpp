@@ -1,12 +1,15 @@
 //
 // Created by talexander on 9/23/2024.
 //
+#include <algorithm>
+
 #include <arm7tdmi/memory.h>
 #include <arm7tdmi/cpu.h>
 
 namespace arm7tdmi {
     basic_memory::basic_memory(const u64 size) noexcept : _size(size) {
-        _memory = new u8[size];
+        _memory = new u8[size]();
+        _dirty_pages.resize((page_count() + 63) / 64);
     }
 
     basic_memory::~basic_memory() noexcept {
@@ -17,6 +20,27 @@ namespace arm7tdmi {
         return _size;
     }
 
+    const u8* basic_memory::direct_read(const u32 address, const u64 size) const noexcept {
+        if (address + size > _size) {
+            return nullptr;
+        }
+        return _memory + address;
+    }
+
+    u8* basic_memory::direct_write(const u32 address, const u64 size) noexcept {
+        if (address + size > _size) {
+            return nullptr;
+        }
+        for (u64 page = address / page_size; page < (address + size + page_size - 1) / page_size; ++page) {
+            mark_page_dirty(static_cast<u32>(page));
+        }
+        return _memory + address;
+    }
+
+    void basic_memory::clear_dirty_pages() noexcept {
+        std::fill(_dirty_pages.begin(), _dirty_pages.end(), 0);
+    }
+
     bool basic_memory::read_byte(const u32 address, u8* out) const noexcept {
         if (address >= _size) {
             return false;
@@ -30,6 +54,7 @@ namespace arm7tdmi {
             return false;
         }
         _memory[address] = value;
+        mark_page_dirty(static_cast<u32>(address / page_size));
         return true;
     }
 }
@@ -0,0 +1,343 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory_log.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        constexpr char log_magic[4] = {'A', '7', 'M', 'L'};
+        constexpr u8 log_version = 2;
+
+        constexpr u8 kind_write = 0x80;
+        constexpr u8 kind_fetch = 0x40;
+        constexpr u8 kind_size = 0x3f;
+        constexpr u32 line_size = 64;
+
+        // [u32 rows][u64 first cycle][u64 last cycle][u32 lowest address][u32 highest address]
+        constexpr size_t chunk_header_size = 28;
+
+        // Columns are stored in host byte order, which is little endian on every supported host
+        template <typename T>
+        void write_column(std::ostream& out, const std::vector<T>& column) noexcept {
+            out.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+        }
+
+        template <typename T>
+        bool read_column(std::istream& in, std::vector<T>& column, const size_t rows) noexcept {
+            column.resize(rows);
+            in.read(reinterpret_cast<char*>(column.data()), static_cast<std::streamsize>(rows * sizeof(T)));
+            return static_cast<size_t>(in.gcount()) == rows * sizeof(T);
+        }
+
+        template <typename T>
+        T take(const char*& data) noexcept {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            data += sizeof(T);
+            return value;
+        }
+
+        bool overlaps(const u32 address, const u64 size, const u64 begin, const u64 end) noexcept {
+            return address < end && address + size > begin;
+        }
+
+        // Accesses are at most a word wide, so a chunk's accesses all start within its address range
+        u64 chunk_span(const u32 lowest, const u32 highest) noexcept {
+            return static_cast<u64>(highest) - lowest + sizeof(u32);
+        }
+    }
+
+    memory_log_access memory_log_chunk::operator[](const size_t row) const noexcept {
+        return {cycles[row], pcs[row], addresses[row], values[row], static_cast<u8>(kinds[row] & kind_size),
+                (kinds[row] & kind_write) != 0, (kinds[row] & kind_fetch) != 0};
+    }
+
+    void memory_log_chunk::push_back(const memory_log_access& access) noexcept {
+        if (cycles.empty()) {
+            first_cycle = access.cycle;
+            lowest_address = access.address;
+            highest_address = access.address;
+        }
+        last_cycle = access.cycle;
+        lowest_address = std::min(lowest_address, access.address);
+        highest_address = std::max(highest_address, access.address);
+
+        cycles.push_back(access.cycle);
+        pcs.push_back(access.pc);
+        addresses.push_back(access.address);
+        values.push_back(access.value);
+        kinds.push_back(static_cast<u8>(access.size | (access.write ? kind_write : 0) | (access.fetch ? kind_fetch : 0)));
+    }
+
+    void memory_log_chunk::clear() noexcept {
+        cycles.clear();
+        pcs.clear();
+        addresses.clear();
+        values.clear();
+        kinds.clear();
+    }
+
+    memory_log_recorder::memory_log_recorder(memory_interface* memory, std::ostream& out) noexcept
+        : _memory(memory), _out(out) {
+        _out.write(log_magic, sizeof(log_magic));
+        _out.put(static_cast<char>(log_version));
+    }
+
+    memory_log_recorder::~memory_log_recorder() noexcept {
+        flush();
+    }
+
+    void memory_log_recorder::flush() noexcept {
+        close_access();
+        write_chunk();
+        _out.flush();
+    }
+
+    void memory_log_recorder::write_chunk() const noexcept {
+        if (_chunk.size() == 0) {
+            return;
+        }
+
+        const u32 rows = static_cast<u32>(_chunk.size());
+        _out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+        _out.write(reinterpret_cast<const char*>(&_chunk.first_cycle), sizeof(_chunk.first_cycle));
+        _out.write(reinterpret_cast<const char*>(&_chunk.last_cycle), sizeof(_chunk.last_cycle));
+        _out.write(reinterpret_cast<const char*>(&_chunk.lowest_address), sizeof(_chunk.lowest_address));
+        _out.write(reinterpret_cast<const char*>(&_chunk.highest_address), sizeof(_chunk.highest_address));
+        write_column(_out, _chunk.cycles);
+        write_column(_out, _chunk.pcs);
+        write_column(_out, _chunk.addresses);
+        write_column(_out, _chunk.values);
+        write_column(_out, _chunk.kinds);
+        _chunk.clear();
+    }
+
+    void memory_log_recorder::close_access() const noexcept {
+        if (!_has_open) {
+            return;
+        }
+        _has_open = false;
+        _chunk.push_back(_open);
+        if (_chunk.size() >= chunk_rows) {
+            write_chunk();
+        }
+    }
+
+    void memory_log_recorder::log(const u32 address, const u8 value, const bool write, const bool fetch) const noexcept {
+        const u64 cycle = _cpu ? _cpu->get_cycles() : 0;
+        if (_has_open && _open.write == write && _open.fetch == fetch && _open.cycle == cycle && _open.size < sizeof(u32)
+            && _open.address + _open.size == address) {
+            _open.value |= static_cast<u32>(value) << (_open.size * 8);
+            _open.size++;
+            return;
+        }
+
+        close_access();
+        _open = {cycle, _cpu ? _cpu->registers.pc() : 0, address, value, 1, write, fetch};
+        _has_open = true;
+    }
+
+    bool memory_log_recorder::read_byte(const u32 address, u8* out) const noexcept {
+        if (!_memory->read<u8>(address, out)) {
+            return false;
+        }
+        log(address, *out, false, _cpu && _cpu->fetching(address));
+        return true;
+    }
+
+    bool memory_log_recorder::write_byte(const size_t address, const u8 value) noexcept {
+        if (!_memory->write<u8>(static_cast<u32>(address), value)) {
+            return false;
+        }
+        log(static_cast<u32>(address), value, true, false);
+        return true;
+    }
+
+    bool memory_log_reader::open(const std::string& path) noexcept {
+        _path = path;
+        _chunks.clear();
+        _rows = 0;
+
+        std::ifstream in(path, std::ios::binary);
+        char header[sizeof(log_magic) + 1] = {};
+        in.read(header, sizeof(header));
+        if (in.gcount() != sizeof(header)
+            || !std::equal(std::begin(log_magic), std::end(log_magic), header)
+            || static_cast<u8>(header[sizeof(log_magic)]) != log_version) {
+            return false;
+        }
+
+        // Row size across every column
+        constexpr size_t row_bytes = sizeof(u64) + 3 * sizeof(u32) + sizeof(u8);
+        while (true) {
+            char bytes[chunk_header_size];
+            in.read(bytes, sizeof(bytes));
+            if (in.gcount() != sizeof(bytes)) {
+                break;
+            }
+
+            const char* data = bytes;
+            chunk_index chunk = {};
+            chunk.rows = take<u32>(data);
+            chunk.first_cycle = take<u64>(data);
+            chunk.last_cycle = take<u64>(data);
+            chunk.lowest_address = take<u32>(data);
+            chunk.highest_address = take<u32>(data);
+            chunk.offset = in.tellg();
+
+            in.seekg(static_cast<std::streamoff>(chunk.rows * row_bytes), std::ios::cur);
+            if (!in) {
+                // Truncated, keep the chunks before it
+                break;
+            }
+            _chunks.push_back(chunk);
+            _rows += chunk.rows;
+        }
+        return true;
+    }
+
+    bool memory_log_reader::read_chunk(std::ifstream& in, const size_t index, memory_log_chunk* out) const noexcept {
+        const auto& chunk = _chunks[index];
+        in.clear();
+        in.seekg(chunk.offset);
+        out->first_cycle = chunk.first_cycle;
+        out->last_cycle = chunk.last_cycle;
+        out->lowest_address = chunk.lowest_address;
+        out->highest_address = chunk.highest_address;
+        return read_column(in, out->cycles, chunk.rows)
+            && read_column(in, out->pcs, chunk.rows)
+            && read_column(in, out->addresses, chunk.rows)
+            && read_column(in, out->values, chunk.rows)
+            && read_column(in, out->kinds, chunk.rows);
+    }
+
+    template <typename Visit>
+    void memory_log_reader::scan(u32 threads, Visit visit) const noexcept {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<u32>(std::max<size_t>(1, std::min<size_t>(threads, _chunks.size())));
+
+        std::atomic<size_t> next = 0;
+        auto work = [&](const u32 worker) noexcept {
+            std::ifstream in(_path, std::ios::binary);
+            memory_log_chunk chunk;
+            for (size_t i = next++; i < _chunks.size(); i = next++) {
+                visit(worker, _chunks[i], [&]() noexcept -> const memory_log_chunk* {
+                    return read_chunk(in, i, &chunk) ? &chunk : nullptr;
+                });
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (u32 t = 1; t < threads; ++t) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::vector<memory_log_access> memory_log_reader::writes_in_range(const u32 begin, const u32 end, const u32 threads) const noexcept {
+        std::vector<std::vector<memory_log_access>> found(std::max(1u, threads == 0 ? std::thread::hardware_concurrency() : threads));
+        scan(static_cast<u32>(found.size()), [&](const u32 worker, const chunk_index& index, const auto& load) noexcept {
+            if (!overlaps(index.lowest_address, chunk_span(index.lowest_address, index.highest_address), begin, end)) {
+                return;
+            }
+            const memory_log_chunk* chunk = load();
+            if (!chunk) {
+                return;
+            }
+            for (size_t row = 0; row < chunk->size(); ++row) {
+                if ((chunk->kinds[row] & kind_write) && overlaps(chunk->addresses[row], chunk->kinds[row] & kind_size, begin, end)) {
+                    found[worker].push_back((*chunk)[row]);
+                }
+            }
+        });
+
+        std::vector<memory_log_access> writes;
+        for (auto& part : found) {
+            writes.insert(writes.end(), part.begin(), part.end());
+        }
+        std::stable_sort(writes.begin(), writes.end(), [](const memory_log_access& a, const memory_log_access& b) {
+            return a.cycle < b.cycle;
+        });
+        return writes;
+    }
+
+    std::vector<std::pair<u32, u64>> memory_log_reader::hottest_lines(const size_t count, const u32 threads) const noexcept {
+        std::vector<std::unordered_map<u32, u64>> counts(std::max(1u, threads == 0 ? std::thread::hardware_concurrency() : threads));
+        scan(static_cast<u32>(counts.size()), [&](const u32 worker, const chunk_index&, const auto& load) noexcept {
+            const memory_log_chunk* chunk = load();
+            if (!chunk) {
+                return;
+            }
+            auto& lines = counts[worker];
+            for (const u32 address : chunk->addresses) {
+                lines[address & ~(line_size - 1)]++;
+            }
+        });
+
+        std::unordered_map<u32, u64> total;
+        for (const auto& part : counts) {
+            for (const auto& [line, n] : part) {
+                total[line] += n;
+            }
+        }
+
+        std::vector<std::pair<u32, u64>> lines(total.begin(), total.end());
+        const size_t n = std::min(count, lines.size());
+        std::partial_sort(lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(n), lines.end(), [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+        lines.resize(n);
+        return lines;
+    }
+
+    std::optional<memory_log_access> memory_log_reader::first_writer(const u32 address, const u32 threads) const noexcept {
+        std::vector<std::optional<memory_log_access>> best(std::max(1u, threads == 0 ? std::thread::hardware_concurrency() : threads));
+
+        // Chunks that start after the best write found so far by any worker can be skipped
+        std::atomic<u64> earliest = ~0ull;
+        scan(static_cast<u32>(best.size()), [&](const u32 worker, const chunk_index& index, const auto& load) noexcept {
+            if (index.first_cycle > earliest.load(std::memory_order_relaxed)
+                || !overlaps(index.lowest_address, chunk_span(index.lowest_address, index.highest_address), address, address + 1ull)) {
+                return;
+            }
+            const memory_log_chunk* chunk = load();
+            if (!chunk) {
+                return;
+            }
+            for (size_t row = 0; row < chunk->size(); ++row) {
+                if ((chunk->kinds[row] & kind_write) && overlaps(chunk->addresses[row], chunk->kinds[row] & kind_size, address, address + 1ull)) {
+                    if (!best[worker] || chunk->cycles[row] < best[worker]->cycle) {
+                        best[worker] = (*chunk)[row];
+                        u64 current = earliest.load(std::memory_order_relaxed);
+                        while (chunk->cycles[row] < current && !earliest.compare_exchange_weak(current, chunk->cycles[row])) {}
+                    }
+                    // Rows are in cycle order within a chunk
+                    break;
+                }
+            }
+        });
+
+        std::optional<memory_log_access> first;
+        for (const auto& candidate : best) {
+            if (candidate && (!first || candidate->cycle < first->cycle)) {
+                first = candidate;
+            }
+        }
+        return first;
+    }
+}
@@ -0,0 +1,205 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        // Bytes of code decoded by a thread at a time
+        constexpr u32 chunk_size = 0x10000;
+
+        fused_pair fuse(const u16 first, const u16 second) noexcept {
+            if ((first & 0xf800) == 0xf000 && (second & 0xf800) == 0xf800) {
+                return fused_pair::branch_with_link;
+            }
+            // Condition codes 14 and 15 are the undefined and SWI encodings
+            if ((first & 0xf800) == 0x2800 && (second & 0xf000) == 0xd000 && (second & 0x0e00) != 0x0e00) {
+                return fused_pair::compare_branch;
+            }
+            if ((first & 0xf800) == 0x2000 && (second & 0xf800) == 0x3000 && (first & 0x0700) == (second & 0x0700)) {
+                return fused_pair::move_add;
+            }
+            return fused_pair::none;
+        }
+    }
+
+    predecode_cache::predecode_cache(const u32 base, const u32 size) noexcept {
+        reset(base, size);
+    }
+
+    predecode_cache::predecode_cache(const elf_image& image) noexcept {
+        const auto& segments = image.segments();
+        const bool executable = std::any_of(segments.begin(), segments.end(), [](const elf_segment& s) { return s.executable; });
+
+        u64 begin = std::numeric_limits<u32>::max();
+        u64 end = 0;
+        const elf_segment* largest = nullptr;
+        for (const auto& segment : segments) {
+            if (segment.executable || !executable) {
+                begin = std::min<u64>(begin, segment.address);
+                end = std::max<u64>(end, static_cast<u64>(segment.address) + segment.memory_size);
+                if (!largest || segment.memory_size > largest->memory_size) {
+                    largest = &segment;
+                }
+            }
+        }
+        // Segments far apart, e.g. a boot ROM and a cartridge, would allocate entries for the gap between them
+        if (largest && end - begin > max_size) {
+            begin = largest->address;
+            end = static_cast<u64>(largest->address) + largest->memory_size;
+        }
+        if (begin < end) {
+            reset(static_cast<u32>(begin), static_cast<u32>(std::min<u64>(end - begin, std::numeric_limits<u32>::max())));
+        }
+    }
+
+    void predecode_cache::reset(const u32 base, const u32 size) noexcept {
+        if (size > max_size) {
+            return;
+        }
+        _base = base & ~3u;
+        _size = static_cast<u32>((static_cast<u64>(size) + (base & 3u) + 3u) & ~u64{3});
+        _arm.assign(_size / sizeof(u32), {});
+        _thumb.assign(_size / sizeof(u16), {});
+    }
+
+    void predecode_cache::fill(const memory_interface& memory, u32 threads) noexcept {
+        const u32 chunks = (_size + chunk_size - 1) / chunk_size;
+        if (chunks == 0) {
+            return;
+        }
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = std::min(threads, chunks);
+
+        std::atomic<u32> next = 0;
+        auto work = [&]() noexcept {
+            std::vector<u32> words;
+            std::vector<u16> halfwords;
+            std::vector<arm::instruction> arm_instrs;
+            std::vector<thumb::instruction> thumb_instrs;
+
+            for (u32 chunk = next++; chunk < chunks; chunk = next++) {
+                const u32 begin = chunk * chunk_size;
+                const auto end = static_cast<u32>(std::min<u64>(_size, static_cast<u64>(begin) + chunk_size));
+
+                // Fetch every word once, the halfwords are its two halves
+                words.resize((end - begin) / sizeof(u32));
+                halfwords.resize(words.size() * 2);
+                for (u32 i = 0; i < words.size(); ++i) {
+                    const u32 address = _base + begin + i * sizeof(u32);
+                    u32 word = 0;
+                    const bool valid = memory.read<u32>(address, &word);
+                    words[i] = word;
+                    halfwords[i * 2] = static_cast<u16>(word);
+                    halfwords[i * 2 + 1] = static_cast<u16>(word >> 16);
+                    _arm[(begin / sizeof(u32)) + i].valid = valid;
+                    _thumb[(begin / sizeof(u16)) + i * 2].valid = valid;
+                    _thumb[(begin / sizeof(u16)) + i * 2 + 1].valid = valid;
+                }
+
+                arm_instrs.resize(words.size());
+                thumb_instrs.resize(halfwords.size());
+                arm::decode_batch(words, arm_instrs);
+                thumb::decode_batch(halfwords, thumb_instrs);
+
+                for (u32 i = 0; i < words.size(); ++i) {
+                    auto& entry = _arm[(begin / sizeof(u32)) + i];
+                    entry.opcode = words[i];
+                    entry.instr = arm_instrs[i];
+                }
+                for (u32 i = 0; i < halfwords.size(); ++i) {
+                    auto& entry = _thumb[(begin / sizeof(u16)) + i];
+                    entry.opcode = halfwords[i];
+                    entry.instr = thumb_instrs[i];
+                    entry.fusion = fused_pair::none;
+
+                    if (_fusion) {
+                        // The last halfword pairs with the first of the next chunk, which another thread owns
+                        u16 next = 0;
+                        bool has_next = false;
+                        if (i + 1 < halfwords.size()) {
+                            next = halfwords[i + 1];
+                            has_next = _thumb[(begin / sizeof(u16)) + i + 1].valid;
+                        }
+                        else {
+                            has_next = end < _size && memory.read<u16>(_base + end, &next);
+                        }
+                        if (entry.valid && has_next) {
+                            entry.fusion = fuse(entry.opcode, next);
+                            entry.next = next;
+                        }
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (u32 t = 1; t < threads; ++t) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void predecode_cache::invalidate_range(const u32 address, const u32 size) noexcept {
+        const u64 begin = std::max<u64>(address, _base) - _base;
+        const u64 end = std::min<u64>(static_cast<u64>(address) + size, static_cast<u64>(_base) + _size) - _base;
+        for (u64 i = begin / sizeof(u32); i < (end + sizeof(u32) - 1) / sizeof(u32); ++i) {
+            _arm[i].valid = false;
+        }
+        for (u64 i = begin / sizeof(u16); i < (end + sizeof(u16) - 1) / sizeof(u16); ++i) {
+            _thumb[i].valid = false;
+        }
+        // The instruction before the range may have been fused with one inside it
+        if (begin >= sizeof(u16)) {
+            _thumb[begin / sizeof(u16) - 1].fusion = fused_pair::none;
+        }
+    }
+
+    void predecode_cache::clear() noexcept {
+        for (auto& entry : _arm) entry.valid = false;
+        for (auto& entry : _thumb) entry.valid = false;
+    }
+
+    void predecode_cache::store(const u32 address, const u32 opcode, const arm::instruction instr) noexcept {
+        if (const u32 offset = address - _base; offset < _size) {
+            _arm[offset / sizeof(u32)] = {opcode, instr, true};
+        }
+    }
+
+    void predecode_cache::store(const u32 address, const u16 opcode, const thumb::instruction instr) noexcept {
+        const u32 offset = address - _base;
+        if (offset >= _size) {
+            return;
+        }
+
+        const u32 index = offset / sizeof(u16);
+        auto& entry = _thumb[index];
+        entry = {opcode, instr, true};
+        if (!_fusion) {
+            return;
+        }
+        if (index + 1 < _thumb.size() && _thumb[index + 1].valid) {
+            entry.fusion = fuse(opcode, _thumb[index + 1].opcode);
+            entry.next = _thumb[index + 1].opcode;
+        }
+        if (index > 0 && _thumb[index - 1].valid) {
+            _thumb[index - 1].fusion = fuse(_thumb[index - 1].opcode, opcode);
+            _thumb[index - 1].next = opcode;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/profiler.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        // The outermost frame never returns
+        constexpr u32 no_return = 0xffffffff;
+
+        std::string frame_name(const u32 address, const elf_image* symbols) noexcept {
+            if (symbols) {
+                if (const auto* symbol = symbols->find(address)) {
+                    return symbol->name;
+                }
+            }
+            return fmt::format("0x{:08x}", address);
+        }
+    }
+
+    profiler::profiler(const u64 period) noexcept : _period(std::max<u64>(period, 1)) {
+    }
+
+    void profiler::clear() noexcept {
+        _next_sample = 0;
+        _samples = 0;
+        _stack.clear();
+        _counts.clear();
+    }
+
+    std::vector<u32> profiler::call_stack() const noexcept {
+        std::vector<u32> entries;
+        entries.reserve(_stack.size());
+        for (const auto& f : _stack) {
+            entries.push_back(f.entry);
+        }
+        return entries;
+    }
+
+    void profiler::sample(const u32 pc) noexcept {
+        _key.clear();
+        for (const auto& f : _stack) {
+            _key.push_back(f.entry);
+        }
+        _key.push_back(pc);
+
+        if (const auto it = _counts.find(_key); it != _counts.end()) {
+            it->second++;
+        }
+        else {
+            _counts.emplace(_key, 1);
+        }
+        _samples++;
+    }
+
+    bool profiler::step(cpu& cpu) noexcept {
+        const u32 pc = cpu.registers.pc();
+        if (_stack.empty()) {
+            _stack.push_back({pc, no_return});
+        }
+
+        const u64 cycles = cpu.get_cycles();
+        if (cycles >= _next_sample) {
+            sample(pc);
+            _next_sample = cycles + _period;
+        }
+
+        const bool exception = cpu.irq_pending();
+
+        if (!cpu.step()) {
+            return false;
+        }
+
+        // A step may run several instructions (fused pairs, compiled blocks), only the last can branch
+        const u32 next = cpu.registers.pc();
+        const u32 end = cpu.get_instruction_end();
+        if (exception) {
+            _stack.push_back({next, pc});
+        }
+        else if (next != end) {
+            if ((cpu.registers.lr() & ~1u) == end) {
+                _stack.push_back({next, end});
+            }
+            else {
+                // Search the whole stack, so frames skipped by a longjmp or an exception return are dropped too
+                for (size_t i = _stack.size(); i-- > 1;) {
+                    if (_stack[i].return_address == next) {
+                        _stack.resize(i);
+                        break;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void profiler::write_folded(std::ostream& out, const elf_image* symbols) const noexcept {
+        // Different pcs in the same function fold into one line
+        std::map<std::string, u64> lines;
+        std::string line;
+        for (const auto& [key, count] : _counts) {
+            line.clear();
+            std::string inner;
+            for (size_t i = 0; i + 1 < key.size(); ++i) {
+                inner = frame_name(key[i], symbols);
+                if (i != 0) {
+                    line += ';';
+                }
+                line += inner;
+            }
+
+            // The sampled pc only adds a frame when it is outside the innermost function, e.g. after a tail call
+            if (symbols) {
+                if (const auto* symbol = symbols->find(key.back()); symbol && symbol->name != inner) {
+                    line += ';';
+                    line += symbol->name;
+                }
+            }
+            lines[line] += count;
+        }
+
+        for (const auto& [stack, count] : lines) {
+            out << stack << ' ' << count << '\n';
+        }
+    }
+}
@@ -0,0 +1,209 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <iterator>
+
+#include <arm7tdmi/replay.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/util.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        constexpr char log_magic[4] = {'A', '7', 'I', 'L'};
+        constexpr u8 log_version = 1;
+
+        constexpr size_t flush_threshold = 64 * 1024;
+    }
+
+    void mmio_ranges::add(u32 begin, u32 end) noexcept {
+        if (begin >= end) {
+            return;
+        }
+        for (u32 page = begin >> page_bits; page <= (end - 1) >> page_bits; ++page) {
+            _pages[page / 64] |= 1ull << (page % 64);
+        }
+
+        // Kept disjoint, so a lookup only checks the last range starting at or below the address
+        auto first = std::lower_bound(_ranges.begin(), _ranges.end(), begin, [](const range& r, const u32 address) {
+            return r.end < address;
+        });
+        auto last = first;
+        while (last != _ranges.end() && last->begin <= end) {
+            begin = std::min(begin, last->begin);
+            end = std::max(end, last->end);
+            ++last;
+        }
+        first = _ranges.erase(first, last);
+        _ranges.insert(first, {begin, end});
+    }
+
+    bool mmio_ranges::find(const u32 address) const noexcept {
+        const auto it = std::upper_bound(_ranges.begin(), _ranges.end(), address, [](const u32 a, const range& r) {
+            return a < r.begin;
+        });
+        return it != _ranges.begin() && address < std::prev(it)->end;
+    }
+
+    input_log_writer::input_log_writer(std::ostream& out) noexcept : _out(out) {
+        _buffer.reserve(flush_threshold);
+        _buffer.insert(_buffer.end(), std::begin(log_magic), std::end(log_magic));
+        _buffer.push_back(log_version);
+    }
+
+    input_log_writer::~input_log_writer() noexcept {
+        flush();
+    }
+
+    void input_log_writer::write(const input_record& record) noexcept {
+        // [event][cycle delta][payload], payload is the level for IRQ changes, or address delta and value for MMIO reads
+        _buffer.push_back(static_cast<u8>(record.event));
+        util::write_varint(_buffer, record.cycle - _last_cycle);
+        _last_cycle = record.cycle;
+
+        if (record.event == input_event::mmio_read) {
+            util::write_varint(_buffer, util::zigzag_encode(static_cast<i64>(record.address) - static_cast<i64>(_last_address)));
+            _last_address = record.address;
+        }
+        _buffer.push_back(record.value);
+
+        if (_buffer.size() >= flush_threshold) {
+            flush();
+        }
+    }
+
+    void input_log_writer::flush() noexcept {
+        if (!_buffer.empty()) {
+            _out.write(reinterpret_cast<const char*>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+            _buffer.clear();
+        }
+        _out.flush();
+    }
+
+    input_log_reader::input_log_reader(std::istream& in) noexcept : _in(in) {
+        char header[sizeof(log_magic) + 1] = {};
+        _in.read(header, sizeof(header));
+        _valid = _in.gcount() == sizeof(header)
+            && std::equal(std::begin(log_magic), std::end(log_magic), header)
+            && static_cast<u8>(header[sizeof(log_magic)]) == log_version;
+    }
+
+    bool input_log_reader::read_varint(u64* out) noexcept {
+        u64 value = 0;
+        u32 shift = 0;
+        for (;;) {
+            const auto c = _in.get();
+            if (c == std::istream::traits_type::eof()) {
+                return false;
+            }
+            value |= static_cast<u64>(c & 0x7f) << shift;
+            if ((c & 0x80) == 0) {
+                break;
+            }
+            shift += 7;
+        }
+        *out = value;
+        return true;
+    }
+
+    bool input_log_reader::next(input_record* out) noexcept {
+        if (!_valid || out == nullptr) {
+            return false;
+        }
+
+        const auto event = _in.get();
+        if (event == std::istream::traits_type::eof()) {
+            return false;
+        }
+
+        u64 cycle_delta = 0;
+        if (!read_varint(&cycle_delta)) {
+            return false;
+        }
+        out->event = static_cast<input_event>(event);
+        out->cycle = _last_cycle += cycle_delta;
+
+        if (out->event == input_event::mmio_read) {
+            u64 address_delta = 0;
+            if (!read_varint(&address_delta)) {
+                return false;
+            }
+            _last_address = static_cast<u32>(static_cast<i64>(_last_address) + util::zigzag_decode(address_delta));
+        }
+        out->address = out->event == input_event::mmio_read ? _last_address : 0;
+
+        const auto value = _in.get();
+        if (value == std::istream::traits_type::eof()) {
+            return false;
+        }
+        out->value = static_cast<u8>(value);
+        return true;
+    }
+
+    input_recorder::input_recorder(memory_interface* memory, std::ostream& out) noexcept
+        : _memory(memory), _log(out) {
+    }
+
+    void input_recorder::set_irq_line(cpu& cpu, const bool asserted) noexcept {
+        if (cpu.get_irq_line() != asserted) {
+            _log.write({input_event::irq_line, cpu.get_cycles(), 0, static_cast<u8>(asserted)});
+        }
+        cpu.set_irq_line(asserted);
+    }
+
+    bool input_recorder::read_byte(const u32 address, u8* out) const noexcept {
+        const bool success = _memory->read<u8>(address, out);
+        if (_mmio.contains(address) && !(_cpu && _cpu->fetching(address))) {
+            _log.write({input_event::mmio_read, _cpu ? _cpu->get_cycles() : 0, address, *out});
+        }
+        return success;
+    }
+
+    bool input_recorder::write_byte(const size_t address, const u8 value) noexcept {
+        return _memory->write<u8>(static_cast<u32>(address), value);
+    }
+
+    input_replayer::input_replayer(memory_interface* memory, std::istream& in) noexcept
+        : _memory(memory), _log(in) {
+        advance();
+    }
+
+    void input_replayer::advance() const noexcept {
+        _has_next = _log.next(&_next);
+    }
+
+    void input_replayer::sync(cpu& cpu) noexcept {
+        _cpu = &cpu;
+        while (_has_next && _next.cycle <= cpu.get_cycles()) {
+            if (_next.event != input_event::irq_line) {
+                // MMIO reads are consumed by the bus during the step; one from an earlier cycle never happened
+                _diverged |= _next.cycle < cpu.get_cycles();
+                return;
+            }
+            cpu.set_irq_line(_next.value != 0);
+            advance();
+        }
+    }
+
+    bool input_replayer::read_byte(const u32 address, u8* out) const noexcept {
+        if (!_mmio.contains(address) || (_cpu && _cpu->fetching(address))) {
+            return _memory->read<u8>(address, out);
+        }
+
+        const u64 cycle = _cpu ? _cpu->get_cycles() : 0;
+        if (!_has_next || _next.event != input_event::mmio_read || _next.address != address || _next.cycle != cycle) {
+            _diverged = true;
+            *out = 0;
+            return false;
+        }
+        *out = _next.value;
+        advance();
+        return true;
+    }
+
+    bool input_replayer::write_byte(const size_t address, const u8 value) noexcept {
+        return _memory->write<u8>(static_cast<u32>(address), value);
+    }
+}
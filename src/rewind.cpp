@@ -0,0 +1,178 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <arm7tdmi/rewind.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/util.h>
+
+namespace arm7tdmi {
+
+    rewind_buffer::rewind_buffer(basic_memory* memory, const rewind_config config) noexcept
+        : _memory(memory), _config(config), _interval(std::max<u64>(config.interval, 1)) {
+        clear();
+    }
+
+    void rewind_buffer::clear() noexcept {
+        _snapshots.clear();
+        _usage = 0;
+        _next_capture = 0;
+        _last_capture_end = {};
+        _base.assign(_memory->data(), _memory->data() + _memory->size());
+        _memory->clear_dirty_pages();
+    }
+
+    u64 rewind_buffer::oldest_cycle() const noexcept {
+        return _snapshots.empty() ? 0 : _snapshots.front().cycles;
+    }
+
+    void rewind_buffer::capture(const cpu& cpu) noexcept {
+        const auto start = std::chrono::steady_clock::now();
+
+        snapshot snap{cpu.registers, cpu.get_state(), cpu.get_irq_line(), cpu.get_irq_cycle(), cpu.get_cycles(), {}};
+        for (u32 page = 0; page < _memory->page_count(); ++page) {
+            if (_memory->page_dirty(page)) {
+                encode_page(page, snap.delta);
+            }
+        }
+        _memory->clear_dirty_pages();
+
+        snap.delta.shrink_to_fit();
+        _usage += snapshot_cost(snap);
+        _snapshots.push_back(std::move(snap));
+        enforce_budget();
+
+        // Widen the interval while capturing costs more than the allowed fraction of run time,
+        // and narrow it back towards the configured interval once it is cheap again.
+        const auto end = std::chrono::steady_clock::now();
+        if (_last_capture_end != std::chrono::steady_clock::time_point{}) {
+            const std::chrono::duration<double> spent = end - start;
+            const std::chrono::duration<double> elapsed = end - _last_capture_end;
+            if (spent.count() > _config.max_overhead * elapsed.count()) {
+                _interval *= 2;
+            }
+            else if (_interval > _config.interval && spent.count() * 4 < _config.max_overhead * elapsed.count()) {
+                _interval = std::max(_interval / 2, _config.interval);
+            }
+        }
+        _last_capture_end = end;
+        _next_capture = cpu.get_cycles() + _interval;
+    }
+
+    bool rewind_buffer::restore(cpu& cpu, const u64 cycle) noexcept {
+        if (_snapshots.empty() || _snapshots.front().cycles > cycle) {
+            return false;
+        }
+
+        revert_uncaptured();
+
+        // Undo every snapshot newer than the target; each delta takes memory from the previous snapshot to its own.
+        while (_snapshots.back().cycles > cycle) {
+            apply_delta(_snapshots.back().delta);
+            _usage -= snapshot_cost(_snapshots.back());
+            _snapshots.pop_back();
+        }
+
+        const snapshot& snap = _snapshots.back();
+        cpu.registers = snap.registers;
+        cpu.set_state(snap.state);
+        cpu.set_irq_line(snap.irq_line);
+        cpu.schedule_irq(snap.irq_cycle);
+        cpu.set_cycles(snap.cycles);
+        _next_capture = snap.cycles + _interval;
+
+        while (cpu.get_cycles() < cycle && cpu.step()) {}
+
+        return true;
+    }
+
+    bool rewind_buffer::step_back(cpu& cpu, const u64 cycles) noexcept {
+        const u64 now = cpu.get_cycles();
+        return restore(cpu, now > cycles ? now - cycles : 0);
+    }
+
+    void rewind_buffer::encode_page(const u32 page, std::vector<u8>& out) noexcept {
+        const u64 offset = static_cast<u64>(page) * basic_memory::page_size;
+        const u32 length = static_cast<u32>(std::min<u64>(basic_memory::page_size, _memory->size() - offset));
+        const u8* current = _memory->data() + offset;
+        u8* base = _base.data() + offset;
+
+        if (std::memcmp(current, base, length) == 0) {
+            return;
+        }
+
+        util::write_varint(out, page);
+
+        u32 i = 0;
+        while (i < length) {
+            u32 same = 0;
+            while (i + same < length && current[i + same] == base[i + same]) {
+                ++same;
+            }
+            i += same;
+
+            u32 changed = 0;
+            while (i + changed < length && current[i + changed] != base[i + changed]) {
+                ++changed;
+            }
+
+            util::write_varint(out, same);
+            util::write_varint(out, changed);
+            for (u32 k = 0; k < changed; ++k) {
+                out.push_back(current[i + k] ^ base[i + k]);
+                base[i + k] = current[i + k];
+            }
+            i += changed;
+        }
+    }
+
+    void rewind_buffer::apply_delta(const std::vector<u8>& delta) noexcept {
+        u8* memory = _memory->data();
+        size_t pos = 0;
+        while (pos < delta.size()) {
+            const u32 page = static_cast<u32>(util::read_varint(delta.data(), delta.size(), pos));
+            const u64 offset = static_cast<u64>(page) * basic_memory::page_size;
+            const u32 length = static_cast<u32>(std::min<u64>(basic_memory::page_size, _memory->size() - offset));
+
+            u32 i = 0;
+            while (i < length) {
+                i += static_cast<u32>(util::read_varint(delta.data(), delta.size(), pos));
+                const u32 changed = static_cast<u32>(util::read_varint(delta.data(), delta.size(), pos));
+                for (u32 k = 0; k < changed; ++k) {
+                    const u8 x = delta[pos++];
+                    memory[offset + i + k] ^= x;
+                    _base[offset + i + k] ^= x;
+                }
+                i += changed;
+            }
+        }
+    }
+
+    void rewind_buffer::revert_uncaptured() noexcept {
+        for (u32 page = 0; page < _memory->page_count(); ++page) {
+            if (_memory->page_dirty(page)) {
+                const u64 offset = static_cast<u64>(page) * basic_memory::page_size;
+                const u64 length = std::min<u64>(basic_memory::page_size, _memory->size() - offset);
+                std::memcpy(_memory->data() + offset, _base.data() + offset, length);
+            }
+        }
+        _memory->clear_dirty_pages();
+    }
+
+    void rewind_buffer::enforce_budget() noexcept {
+        while (_usage > _config.budget && _snapshots.size() > 1) {
+            _usage -= snapshot_cost(_snapshots.front());
+            _snapshots.pop_front();
+
+            // The oldest snapshot is only ever restored to, never undone, so its delta is dead weight.
+            snapshot& oldest = _snapshots.front();
+            _usage -= snapshot_cost(oldest);
+            oldest.delta.clear();
+            oldest.delta.shrink_to_fit();
+            _usage += snapshot_cost(oldest);
+        }
+    }
+}
@@ -0,0 +1,326 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <ctime>
+
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/register.h>
+#include <arm7tdmi/semihosting.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        enum operation : u32 {
+            sys_open = 0x01,
+            sys_close = 0x02,
+            sys_writec = 0x03,
+            sys_write0 = 0x04,
+            sys_write = 0x05,
+            sys_read = 0x06,
+            sys_readc = 0x07,
+            sys_iserror = 0x08,
+            sys_istty = 0x09,
+            sys_seek = 0x0a,
+            sys_flen = 0x0c,
+            sys_remove = 0x0e,
+            sys_rename = 0x0f,
+            sys_clock = 0x10,
+            sys_time = 0x11,
+            sys_errno = 0x13,
+            sys_get_cmdline = 0x15,
+            sys_heapinfo = 0x16,
+            sys_exit = 0x18,
+            sys_exit_extended = 0x20
+        };
+
+        constexpr u32 failed = 0xffffffff;
+        constexpr u32 adp_stopped_application_exit = 0x20026;
+
+        // Longest name read from guest memory
+        constexpr u32 max_name = 4096;
+
+        // fopen modes by SYS_OPEN mode number
+        constexpr const char* open_modes[] = {"r", "rb", "r+", "r+b", "w", "wb", "w+", "w+b", "a", "ab", "a+", "a+b"};
+
+        u32 argument(const memory_interface& memory, const u32 block, const u32 index) noexcept {
+            u32 value = 0;
+            memory.read<u32>(block + index * sizeof(u32), &value);
+            return value;
+        }
+
+        std::string read_string(const memory_interface& memory, u32 address, const u32 length) noexcept {
+            std::string result;
+            for (u8 c = 0; result.size() < length && memory.read<u8>(address, &c); ++address) {
+                result.push_back(static_cast<char>(c));
+            }
+            return result;
+        }
+
+        std::string read_terminated(const memory_interface& memory, u32 address) noexcept {
+            std::string result;
+            for (u8 c = 0; result.size() < max_name && memory.read<u8>(address, &c) && c != 0; ++address) {
+                result.push_back(static_cast<char>(c));
+            }
+            return result;
+        }
+    }
+
+    semihosting::semihosting(std::filesystem::path root, std::ostream& out, std::istream& in) noexcept
+        : _root(std::move(root)), _out(out), _in(in) {
+    }
+
+    semihosting::~semihosting() noexcept {
+        for (const auto& file : _files) {
+            if (file.handle) {
+                std::fclose(file.handle);
+            }
+        }
+    }
+
+    void semihosting::call(cpu_registers& registers, memory_interface& memory) noexcept {
+        const u32 block = registers.r1();
+        u32 result = failed;
+
+        switch (registers.r0()) {
+            case sys_open:
+                result = open(read_string(memory, argument(memory, block, 0), std::min(argument(memory, block, 2), max_name)), argument(memory, block, 1));
+                break;
+            case sys_close:
+                result = close(argument(memory, block, 0));
+                break;
+            case sys_writec: {
+                u8 c = 0;
+                memory.read<u8>(block, &c);
+                _out.put(static_cast<char>(c)).flush();
+                result = registers.r0();
+                break;
+            }
+            case sys_write0:
+                _out << read_terminated(memory, block) << std::flush;
+                result = registers.r0();
+                break;
+            case sys_write:
+                result = write(argument(memory, block, 0), argument(memory, block, 1), argument(memory, block, 2), memory);
+                break;
+            case sys_read:
+                result = read(argument(memory, block, 0), argument(memory, block, 1), argument(memory, block, 2), memory);
+                break;
+            case sys_readc:
+                result = static_cast<u8>(_in.get());
+                break;
+            case sys_iserror:
+                result = static_cast<i32>(argument(memory, block, 0)) < 0 ? 1 : 0;
+                break;
+            case sys_istty:
+                if (const auto* file = find(argument(memory, block, 0))) {
+                    result = file->console != stream::none;
+                }
+                break;
+            case sys_seek:
+                if (const auto* file = find(argument(memory, block, 0)); file && file->handle) {
+                    result = std::fseek(file->handle, argument(memory, block, 1), SEEK_SET) == 0 ? 0 : failed;
+                }
+                break;
+            case sys_flen:
+                if (const auto* file = find(argument(memory, block, 0)); file && file->handle) {
+                    const long position = std::ftell(file->handle);
+                    std::fseek(file->handle, 0, SEEK_END);
+                    result = static_cast<u32>(std::ftell(file->handle));
+                    std::fseek(file->handle, position, SEEK_SET);
+                }
+                break;
+            case sys_remove: {
+                std::filesystem::path path;
+                std::error_code error;
+                if (host_path(read_string(memory, argument(memory, block, 0), std::min(argument(memory, block, 1), max_name)), &path)) {
+                    result = std::filesystem::remove(path, error) ? 0 : failed;
+                }
+                break;
+            }
+            case sys_rename: {
+                std::filesystem::path from;
+                std::filesystem::path to;
+                std::error_code error;
+                if (host_path(read_string(memory, argument(memory, block, 0), std::min(argument(memory, block, 1), max_name)), &from) &&
+                    host_path(read_string(memory, argument(memory, block, 2), std::min(argument(memory, block, 3), max_name)), &to)) {
+                    std::filesystem::rename(from, to, error);
+                    result = error ? failed : 0;
+                }
+                break;
+            }
+            case sys_clock:
+                result = static_cast<u32>(std::clock() / (CLOCKS_PER_SEC / 100));
+                break;
+            case sys_time:
+                result = static_cast<u32>(std::time(nullptr));
+                break;
+            case sys_errno:
+                result = _errno;
+                break;
+            case sys_get_cmdline: {
+                // Block holds the buffer and its size, the size is replaced with the length written
+                const u32 buffer = argument(memory, block, 0);
+                const u32 size = argument(memory, block, 1);
+                if (_command_line.size() < size) {
+                    for (u32 i = 0; i < _command_line.size(); ++i) {
+                        memory.write<u8>(buffer + i, static_cast<u8>(_command_line[i]));
+                    }
+                    memory.write<u8>(buffer + static_cast<u32>(_command_line.size()), 0);
+                    memory.write<u32>(block + sizeof(u32), static_cast<u32>(_command_line.size()));
+                    result = 0;
+                }
+                break;
+            }
+            case sys_heapinfo: {
+                // Zeroes leave the heap and stack where the guest's startup code puts them
+                const u32 info = argument(memory, block, 0);
+                for (u32 i = 0; i < 4; ++i) {
+                    memory.write<u32>(info + i * sizeof(u32), 0);
+                }
+                result = 0;
+                break;
+            }
+            case sys_exit:
+                // r1 is the reason code itself, anything but a normal exit is reported as the code
+                _exited = true;
+                _exit_code = block == adp_stopped_application_exit ? 0 : block;
+                result = 0;
+                break;
+            case sys_exit_extended:
+                // Block of reason code and exit code
+                _exited = true;
+                _exit_code = argument(memory, block, 0) == adp_stopped_application_exit ? argument(memory, block, 1) : argument(memory, block, 0);
+                result = 0;
+                break;
+            default:
+                break;
+        }
+
+        registers.r0(result);
+    }
+
+    u32 semihosting::open(const std::string& name, const u32 mode) noexcept {
+        if (mode >= std::size(open_modes)) {
+            return failed;
+        }
+
+        file opened;
+        opened.open = true;
+        if (name == ":tt") {
+            opened.console = mode < 4 ? stream::input : stream::output;
+        }
+        else {
+            std::filesystem::path path;
+            if (!host_path(name, &path)) {
+                _errno = ENOENT;
+                return failed;
+            }
+            opened.handle = std::fopen(path.string().c_str(), open_modes[mode]);
+            if (!opened.handle) {
+                _errno = errno;
+                return failed;
+            }
+        }
+
+        for (u32 i = 0; i < _files.size(); ++i) {
+            if (!_files[i].open) {
+                _files[i] = opened;
+                return i + 1;
+            }
+        }
+        _files.push_back(opened);
+        return static_cast<u32>(_files.size());
+    }
+
+    u32 semihosting::close(const u32 handle) noexcept {
+        auto* file = find(handle);
+        if (!file) {
+            return failed;
+        }
+        const bool closed = !file->handle || std::fclose(file->handle) == 0;
+        *file = {};
+        return closed ? 0 : failed;
+    }
+
+    u32 semihosting::write(const u32 handle, const u32 buffer, const u32 length, const memory_interface& memory) noexcept {
+        auto* file = find(handle);
+        if (!file || file->console == stream::input) {
+            return length;
+        }
+
+        // Returns the number of bytes not written
+        char chunk[4096];
+        for (u32 done = 0; done < length;) {
+            const u32 n = std::min<u32>(length - done, sizeof(chunk));
+            for (u32 i = 0; i < n; ++i) {
+                u8 c = 0;
+                memory.read<u8>(buffer + done + i, &c);
+                chunk[i] = static_cast<char>(c);
+            }
+            if (file->console == stream::output) {
+                _out.write(chunk, n).flush();
+            }
+            else if (std::fwrite(chunk, 1, n, file->handle) != n) {
+                _errno = errno;
+                return length - done;
+            }
+            done += n;
+        }
+        return 0;
+    }
+
+    u32 semihosting::read(const u32 handle, const u32 buffer, const u32 length, memory_interface& memory) noexcept {
+        auto* file = find(handle);
+        if (!file || file->console == stream::output) {
+            return length;
+        }
+
+        // Returns the number of bytes not read, a short read is the end of the file
+        char chunk[4096];
+        for (u32 done = 0; done < length;) {
+            const u32 want = std::min<u32>(length - done, sizeof(chunk));
+            u32 n = 0;
+            if (file->console == stream::input) {
+                // A console read stops at the end of a line
+                _in.getline(chunk, want);
+                n = static_cast<u32>(_in.gcount());
+                if (n > 0 && n <= want && !_in.fail() && chunk[n - 1] == 0) {
+                    chunk[n - 1] = '\n';
+                }
+                _in.clear();
+            }
+            else {
+                n = static_cast<u32>(std::fread(chunk, 1, want, file->handle));
+            }
+            for (u32 i = 0; i < n; ++i) {
+                memory.write<u8>(buffer + done + i, static_cast<u8>(chunk[i]));
+            }
+            done += n;
+            if (n < want || file->console == stream::input) {
+                return length - done;
+            }
+        }
+        return 0;
+    }
+
+    semihosting::file* semihosting::find(const u32 handle) noexcept {
+        if (handle == 0 || handle > _files.size() || !_files[handle - 1].open) {
+            return nullptr;
+        }
+        return &_files[handle - 1];
+    }
+
+    bool semihosting::host_path(const std::string& name, std::filesystem::path* out) const noexcept {
+        const auto relative = std::filesystem::path(name).relative_path().lexically_normal();
+        if (relative.empty() || *relative.begin() == "..") {
+            return false;
+        }
+        *out = _root / relative;
+        return true;
+    }
+
+}
@@ -0,0 +1,225 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/tiers.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        // Instructions which branch, or write pc, whenever they execute
+        bool ends_block(const arm::instruction instr, const u32 opcode) noexcept {
+            switch (instr) {
+                case arm::instruction::branch:
+                case arm::instruction::branch_and_exchange:
+                case arm::instruction::software_interrupt:
+                case arm::instruction::undefined:
+                case arm::instruction::unknown:
+                    return true;
+                case arm::instruction::block_data_transfer:
+                    return (opcode & 0x00108000u) == 0x00108000u;
+                case arm::instruction::data_processing:
+                case arm::instruction::single_data_transfer:
+                    return ((opcode >> 12) & 0xfu) == 15;
+                default:
+                    return false;
+            }
+        }
+
+        bool ends_block(const thumb::instruction instr, const u16 opcode) noexcept {
+            switch (instr) {
+                case thumb::instruction::unconditional_branch:
+                case thumb::instruction::conditional_branch:
+                case thumb::instruction::software_interrupt:
+                case thumb::instruction::unknown:
+                    return true;
+                case thumb::instruction::long_branch_with_link:
+                    // The prefix only sets lr
+                    return (opcode & 0x0800u) != 0;
+                case thumb::instruction::push_pop_registers:
+                    // POP {..., pc}
+                    return (opcode & 0x0900u) == 0x0900u;
+                case thumb::instruction::hi_register_operations_branch_exchange:
+                    // BX, or ADD/MOV with pc as the destination
+                    return (opcode & 0x0300u) == 0x0300u || ((opcode & 0x0087u) == 0x0087u && (opcode & 0x0300u) != 0x0100u);
+                default:
+                    return false;
+            }
+        }
+
+        u32 key(const u32 address, const bool thumb) noexcept {
+            return address | static_cast<u32>(thumb);
+        }
+    }
+
+    tiered_execution::tiered_execution(const tier_config& config) noexcept : _config(config), _code_pages((1ull << (32 - page_bits)) / 64) {
+    }
+
+    tiered_block& tiered_execution::enter(const u32 address, const bool thumb, const memory_interface& memory) noexcept {
+        auto& block = _blocks[key(address, thumb)];
+        ++block.entries;
+
+        if (!block.function) {
+            if (_backend && !block.offered && block.entries >= _config.optimize_threshold) {
+                block.offered = true;
+                if (block.tier() == execution_tier::interpreted) {
+                    predecode(block, key(address, thumb), memory);
+                }
+                if (block.size != 0) {
+                    block.function = _backend->compile(memory, address, thumb, block.size);
+                }
+                if (block.function) {
+                    ++_statistics.optimized;
+                    _cached_instructions -= block.arm.size() + block.thumb.size();
+                    block.arm = {};
+                    block.thumb = {};
+                }
+                else {
+                    ++_statistics.declined;
+                }
+            }
+            else if (block.tier() == execution_tier::interpreted && block.entries >= _config.predecode_threshold) {
+                predecode(block, key(address, thumb), memory);
+            }
+        }
+
+        const execution_tier tier = block.tier();
+        ++_statistics.entries[static_cast<size_t>(tier)];
+        if (_config.timing) {
+            const auto now = std::chrono::steady_clock::now();
+            if (_timing) {
+                _statistics.nanoseconds[static_cast<size_t>(_timed_tier)] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - _last_entry).count();
+            }
+            _timing = true;
+            _timed_tier = tier;
+            _last_entry = now;
+        }
+        return block;
+    }
+
+    void tiered_execution::stop_timing() noexcept {
+        if (_timing) {
+            const auto elapsed = std::chrono::steady_clock::now() - _last_entry;
+            _statistics.nanoseconds[static_cast<size_t>(_timed_tier)] += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            _timing = false;
+        }
+    }
+
+    void tiered_execution::predecode(tiered_block& block, const u32 block_key, const memory_interface& memory) noexcept {
+        const u32 address = block_key & ~1u;
+        const bool thumb = (block_key & 1u) != 0;
+        const u32 width = thumb ? sizeof(u16) : sizeof(u32);
+        std::vector<predecoded_arm> arm;
+        std::vector<predecoded_thumb> thumb_instrs;
+
+        for (u32 i = 0; i < _config.max_block_instructions; ++i) {
+            const u32 pc = address + i * width;
+            if (thumb) {
+                u16 opcode = 0;
+                if (!memory.read<u16>(pc, &opcode)) {
+                    break;
+                }
+                const auto instr = thumb::decode(opcode);
+                thumb_instrs.push_back({opcode, instr, true});
+                if (ends_block(instr, opcode)) {
+                    break;
+                }
+            }
+            else {
+                u32 opcode = 0;
+                if (!memory.read<u32>(pc, &opcode)) {
+                    break;
+                }
+                const auto instr = arm::decode(opcode);
+                arm.push_back({opcode, instr, true});
+                if (ends_block(instr, opcode)) {
+                    break;
+                }
+            }
+        }
+
+        const u64 count = arm.size() + thumb_instrs.size();
+        if (count == 0 || count > _config.cache_instructions) {
+            return;
+        }
+        if (_cached_instructions + count > _config.cache_instructions) {
+            for (auto& [other_key, other] : _blocks) {
+                if (!other.function) {
+                    drop(other_key, other);
+                }
+            }
+            ++_statistics.evictions;
+        }
+
+        block.opcode = thumb ? thumb_instrs.front().opcode : arm.front().opcode;
+        block.arm = std::move(arm);
+        block.thumb = std::move(thumb_instrs);
+        block.size = static_cast<u32>(count * width);
+        _cached_instructions += count;
+        for (u32 page = first_page(address); page <= last_page(address, block.size); ++page) {
+            _page_blocks[page].push_back(block_key);
+            _code_pages[page / 64] |= 1ull << (page % 64);
+        }
+        ++_statistics.predecoded;
+    }
+
+    void tiered_execution::drop(const u32 block_key, tiered_block& block) noexcept {
+        if (block.size != 0) {
+            const u32 address = block_key & ~1u;
+            for (u32 page = first_page(address); page <= last_page(address, block.size); ++page) {
+                auto& keys = _page_blocks[page];
+                keys.erase(std::find(keys.begin(), keys.end(), block_key));
+                if (keys.empty()) {
+                    _page_blocks.erase(page);
+                    _code_pages[page / 64] &= ~(1ull << (page % 64));
+                }
+            }
+        }
+
+        _cached_instructions -= block.arm.size() + block.thumb.size();
+        block.arm = {};
+        block.thumb = {};
+        block.function = nullptr;
+        block.offered = false;
+        block.size = 0;
+    }
+
+    void tiered_execution::invalidate_range(const u32 address, const u32 size) noexcept {
+        const u64 end = static_cast<u64>(address) + size;
+        for (u32 page = first_page(address); page <= last_page(address, size); ++page) {
+            const auto it = _page_blocks.find(page);
+            if (it == _page_blocks.end()) {
+                continue;
+            }
+
+            // Copied, dropping a block edits the lists of every page it covers
+            const std::vector<u32> keys = it->second;
+            for (const u32 block_key : keys) {
+                auto& block = _blocks.find(block_key)->second;
+                const u32 begin = block_key & ~1u;
+                if (block.size != 0 && begin < end && static_cast<u64>(begin) + block.size > address) {
+                    drop(block_key, block);
+                    block.entries = 0;
+                    ++_statistics.invalidations;
+                }
+            }
+        }
+    }
+
+    void tiered_execution::clear() noexcept {
+        // Blocks stay allocated, the cpu may still be running one
+        for (auto& [block_key, block] : _blocks) {
+            drop(block_key, block);
+            block.entries = 0;
+        }
+    }
+
+    execution_tier tiered_execution::tier(const u32 address, const bool thumb) const noexcept {
+        const auto it = _blocks.find(key(address, thumb));
+        return it != _blocks.end() ? it->second.tier() : execution_tier::interpreted;
+    }
+
+}
@@ -0,0 +1,82 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <cstring>
+
+#include <arm7tdmi/timeline.h>
+
+namespace arm7tdmi {
+
+    void checkpoint::save(const cpu& cpu, const basic_memory& memory) noexcept {
+        registers = cpu.registers;
+        state = cpu.get_state();
+        cycles = cpu.get_cycles();
+        irq_line = cpu.get_irq_line();
+        irq_cycle = cpu.get_irq_cycle();
+        this->memory.assign(memory.data(), memory.data() + memory.size());
+    }
+
+    void checkpoint::restore(cpu& cpu, basic_memory& memory) const noexcept {
+        cpu.registers = registers;
+        cpu.set_state(state);
+        cpu.set_cycles(cycles);
+        cpu.set_irq_line(irq_line);
+        cpu.schedule_irq(irq_cycle);
+        std::memcpy(memory.data(), this->memory.data(), std::min<size_t>(memory.size(), this->memory.size()));
+    }
+
+    u32 checkpoint::restore_dirty(cpu& cpu, basic_memory& memory) const noexcept {
+        cpu.registers = registers;
+        cpu.set_state(state);
+        cpu.set_cycles(cycles);
+        cpu.set_irq_line(irq_line);
+        cpu.schedule_irq(irq_cycle);
+
+        u32 pages = 0;
+        const size_t size = std::min<size_t>(memory.size(), this->memory.size());
+        memory.for_each_dirty_page([&](const u32 page) noexcept {
+            const size_t begin = static_cast<size_t>(page) * basic_memory::page_size;
+            if (begin < size) {
+                std::memcpy(memory.data() + begin, this->memory.data() + begin, std::min<size_t>(basic_memory::page_size, size - begin));
+                pages++;
+            }
+        });
+        memory.clear_dirty_pages();
+        return pages;
+    }
+
+    void checkpoint_timeline::record(cpu& cpu, basic_memory& memory, const u64 interval, const u64 end_cycle) noexcept {
+        _checkpoints.clear();
+
+        _config = {};
+        if (const predecode_cache* predecode = cpu.get_predecode()) {
+            _config.predecode = true;
+            _config.predecode_base = predecode->base();
+            _config.predecode_size = predecode->size();
+            _config.fusion = predecode->fusion();
+        }
+        if (const tiered_execution* tiers = cpu.get_tiers()) {
+            _config.tiers = tiers->config();
+            _config.backend = tiers->backend();
+        }
+        _config.aot = cpu.get_aot();
+        _config.hooks = cpu.get_hooks();
+        _config.semihosting_calls = cpu.get_semihosting();
+        _config.bios = cpu.get_bios();
+        _config.block_loops = cpu.get_block_loops();
+
+        const u64 step = std::max<u64>(interval, 1);
+        while (cpu.get_cycles() < end_cycle) {
+            _checkpoints.emplace_back().save(cpu, memory);
+
+            const u64 next = std::min(end_cycle, cpu.get_cycles() + step);
+            while (cpu.get_cycles() < next && cpu.step()) {}
+            if (cpu.get_cycles() < next) {
+                // Faulted, the run ends here
+                break;
+            }
+        }
+        _end_cycle = cpu.get_cycles();
+    }
+}
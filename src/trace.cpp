@@ -0,0 +1,354 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/trace.h>
+#include <arm7tdmi/util.h>
+
+namespace arm7tdmi {
+
+    namespace {
+        constexpr char trace_magic[4] = {'A', '7', 'T', 'R'};
+        constexpr u8 trace_version = 1;
+
+        // Record flags
+        constexpr u8 flag_thumb = 1u << 0;
+        constexpr u8 flag_exception = 1u << 1;
+        constexpr u8 flag_registers = 1u << 2;
+        constexpr u8 flag_accesses = 1u << 3;
+        constexpr u8 flag_jump = 1u << 4;
+
+        // Index of the CPSR in the register arrays
+        constexpr u32 cpsr_index = 15;
+
+        void snapshot(const cpu& cpu, std::array<u32, 16>& out) noexcept {
+            for (u32 i = 0; i < cpsr_index; ++i) {
+                out[i] = cpu.registers.get(i);
+            }
+            out[cpsr_index] = cpu.registers.cpsr();
+        }
+
+        void write_u32(std::vector<u8>& out, const u32 value) noexcept {
+            for (u32 i = 0; i < sizeof(u32); ++i) {
+                out.push_back(static_cast<u8>(value >> (i * 8)));
+            }
+        }
+
+        u32 delta(const u32 from, const u32 to) noexcept {
+            return static_cast<u32>(util::zigzag_encode(static_cast<i32>(to - from)));
+        }
+
+        u32 apply_delta(const u32 from, const u64 encoded) noexcept {
+            return from + static_cast<u32>(util::zigzag_decode(encoded));
+        }
+    }
+
+    trace_recorder::trace_recorder(memory_interface* memory, std::ostream& out, const trace_config config) noexcept
+        : _memory(memory), _out(out), _config(config) {
+        _config.chunk_size = std::max<size_t>(_config.chunk_size, 64);
+        _chunk.reserve(_config.chunk_size + 256);
+        _pending.reserve(_config.chunk_size + 256);
+
+        _out.write(trace_magic, sizeof(trace_magic));
+        _out.put(static_cast<char>(trace_version));
+
+        _thread = std::thread(&trace_recorder::writer, this);
+    }
+
+    trace_recorder::~trace_recorder() noexcept {
+        flush();
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        _thread.join();
+    }
+
+    void trace_recorder::writer() noexcept {
+        std::unique_lock lock(_mutex);
+        while (true) {
+            _condition.wait(lock, [this] { return _has_pending || _stop; });
+            if (!_has_pending) {
+                return;
+            }
+
+            // The buffer is only touched by this thread until _has_pending is cleared
+            lock.unlock();
+            _out.write(reinterpret_cast<const char*>(_pending.data()), static_cast<std::streamsize>(_pending.size()));
+            _out.flush();
+            lock.lock();
+
+            _pending.clear();
+            _has_pending = false;
+            _condition.notify_all();
+        }
+    }
+
+    void trace_recorder::submit() noexcept {
+        if (_chunk_records == 0) {
+            return;
+        }
+
+        // [u32 size][u32 records], then the encoded chunk
+        const u32 size = static_cast<u32>(_chunk.size());
+        for (u32 i = 0; i < sizeof(u32); ++i) {
+            _chunk[i] = static_cast<u8>(size >> (i * 8));
+            _chunk[sizeof(u32) + i] = static_cast<u8>(_chunk_records >> (i * 8));
+        }
+
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this] { return !_has_pending; });
+            _pending.swap(_chunk);
+            _has_pending = true;
+        }
+        _condition.notify_all();
+
+        _chunk.clear();
+        _chunk_records = 0;
+        _started = false;
+    }
+
+    void trace_recorder::flush() noexcept {
+        submit();
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return !_has_pending; });
+    }
+
+    void trace_recorder::begin_chunk() noexcept {
+        // Header placeholder, then the state the first record's deltas are against
+        _chunk.resize(2 * sizeof(u32));
+        util::write_varint(_chunk, _expected_pc);
+        for (const u32 value : _registers) {
+            util::write_varint(_chunk, value);
+        }
+        _last_address = 0;
+        _started = true;
+    }
+
+    void trace_recorder::capture(const u32 address, const u8 value, const bool write) const noexcept {
+        // The fetch is recorded as the opcode the cpu dispatched
+        if (!_cpu || (!write && _cpu->fetching(address))) {
+            return;
+        }
+
+        // Multi-byte accesses arrive a byte at a time, merge them back together
+        if (!_accesses.empty()) {
+            auto& last = _accesses.back();
+            if (last.write == write && last.size < sizeof(u32) && last.address + last.size == address) {
+                last.value |= static_cast<u32>(value) << (last.size * 8);
+                last.size++;
+                return;
+            }
+        }
+        _accesses.push_back({address, value, 1, write});
+    }
+
+    bool trace_recorder::read_byte(const u32 address, u8* out) const noexcept {
+        if (!_memory->read<u8>(address, out)) {
+            return false;
+        }
+        capture(address, *out, false);
+        return true;
+    }
+
+    bool trace_recorder::write_byte(const size_t address, const u8 value) noexcept {
+        if (!_memory->write<u8>(static_cast<u32>(address), value)) {
+            return false;
+        }
+        capture(static_cast<u32>(address), value, true);
+        return true;
+    }
+
+    bool trace_recorder::step(cpu& cpu) noexcept {
+        if (_records == 0 && !_started) {
+            snapshot(cpu, _registers);
+            _expected_pc = cpu.registers.pc();
+        }
+        if (!_started) {
+            begin_chunk();
+        }
+
+        const bool exception = cpu.irq_pending();
+        const u32 pc = exception ? 0x18 : cpu.registers.pc();
+        const cpu_state state = exception ? cpu_state::arm : cpu.get_state();
+
+        _accesses.clear();
+        _cpu = &cpu;
+        const bool stepped = cpu.step_instruction();
+        _cpu = nullptr;
+        if (!stepped) {
+            return false;
+        }
+
+        const u32 size = state == cpu_state::thumb ? sizeof(u16) : sizeof(u32);
+        const u32 opcode = cpu.get_opcode();
+        auto access = _accesses.begin();
+
+        std::array<u32, 16> after;
+        snapshot(cpu, after);
+        u16 changed = 0;
+        for (u32 i = 0; i < after.size(); ++i) {
+            if (after[i] != _registers[i]) {
+                changed |= static_cast<u16>(1u << i);
+            }
+        }
+
+        u8 flags = 0;
+        if (state == cpu_state::thumb) flags |= flag_thumb;
+        if (exception) flags |= flag_exception;
+        if (changed) flags |= flag_registers;
+        if (access != _accesses.end()) flags |= flag_accesses;
+        if (pc != _expected_pc) flags |= flag_jump;
+
+        _chunk.push_back(flags);
+        if (flags & flag_jump) {
+            util::write_varint(_chunk, delta(_expected_pc, pc));
+        }
+        if (state == cpu_state::thumb) {
+            _chunk.push_back(static_cast<u8>(opcode));
+            _chunk.push_back(static_cast<u8>(opcode >> 8));
+        }
+        else {
+            write_u32(_chunk, opcode);
+        }
+
+        if (changed) {
+            util::write_varint(_chunk, changed);
+            for (u32 i = 0; i < after.size(); ++i) {
+                if (changed & (1u << i)) {
+                    // The CPSR changes by flipping bits, the rest mostly count up or down
+                    util::write_varint(_chunk, i == cpsr_index ? _registers[i] ^ after[i] : delta(_registers[i], after[i]));
+                }
+            }
+            _registers = after;
+        }
+
+        if (flags & flag_accesses) {
+            util::write_varint(_chunk, static_cast<u64>(_accesses.end() - access));
+            for (; access != _accesses.end(); ++access) {
+                _chunk.push_back(static_cast<u8>(access->size | (access->write ? 0x80 : 0)));
+                util::write_varint(_chunk, delta(_last_address, access->address));
+                util::write_varint(_chunk, access->value);
+                _last_address = access->address;
+            }
+        }
+
+        _expected_pc = pc + size;
+        _chunk_records++;
+        _records++;
+
+        if (_chunk.size() >= _config.chunk_size) {
+            submit();
+        }
+        return true;
+    }
+
+    trace_reader::trace_reader(std::istream& in) noexcept : _in(in) {
+        char header[sizeof(trace_magic) + 1] = {};
+        _in.read(header, sizeof(header));
+        _valid = _in.gcount() == sizeof(header)
+            && std::equal(std::begin(trace_magic), std::end(trace_magic), header)
+            && static_cast<u8>(header[sizeof(trace_magic)]) == trace_version;
+    }
+
+    bool trace_reader::next_chunk() noexcept {
+        u8 header[2 * sizeof(u32)] = {};
+        _in.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (_in.gcount() != sizeof(header)) {
+            return false;
+        }
+
+        u32 size = 0;
+        u32 records = 0;
+        for (u32 i = 0; i < sizeof(u32); ++i) {
+            size |= static_cast<u32>(header[i]) << (i * 8);
+            records |= static_cast<u32>(header[sizeof(u32) + i]) << (i * 8);
+        }
+        if (size < sizeof(header)) {
+            return false;
+        }
+
+        _chunk.resize(size - sizeof(header));
+        _in.read(reinterpret_cast<char*>(_chunk.data()), static_cast<std::streamsize>(_chunk.size()));
+        if (static_cast<size_t>(_in.gcount()) != _chunk.size()) {
+            return false;
+        }
+
+        _position = 0;
+        _expected_pc = static_cast<u32>(util::read_varint(_chunk.data(), _chunk.size(), _position));
+        for (auto& value : _registers) {
+            value = static_cast<u32>(util::read_varint(_chunk.data(), _chunk.size(), _position));
+        }
+        _last_address = 0;
+        _remaining = records;
+        return true;
+    }
+
+    bool trace_reader::next(trace_record* out) noexcept {
+        if (!_valid) {
+            return false;
+        }
+        while (_remaining == 0) {
+            if (!next_chunk()) {
+                return false;
+            }
+        }
+
+        const u8* data = _chunk.data();
+        const size_t size = _chunk.size();
+        auto varint = [&]() noexcept { return util::read_varint(data, size, _position); };
+
+        if (_position >= size) {
+            return false;
+        }
+        const u8 flags = data[_position++];
+        out->state = flags & flag_thumb ? cpu_state::thumb : cpu_state::arm;
+        out->exception = flags & flag_exception;
+        out->pc = flags & flag_jump ? apply_delta(_expected_pc, varint()) : _expected_pc;
+
+        const u32 opcode_size = out->state == cpu_state::thumb ? sizeof(u16) : sizeof(u32);
+        if (_position + opcode_size > size) {
+            return false;
+        }
+        out->opcode = 0;
+        for (u32 i = 0; i < opcode_size; ++i) {
+            out->opcode |= static_cast<u32>(data[_position++]) << (i * 8);
+        }
+
+        out->changed = 0;
+        if (flags & flag_registers) {
+            out->changed = static_cast<u16>(varint());
+            for (u32 i = 0; i < _registers.size(); ++i) {
+                if (out->changed & (1u << i)) {
+                    const u64 encoded = varint();
+                    _registers[i] = i == cpsr_index ? _registers[i] ^ static_cast<u32>(encoded) : apply_delta(_registers[i], encoded);
+                }
+            }
+        }
+        out->registers = _registers;
+
+        out->accesses.clear();
+        if (flags & flag_accesses) {
+            const u64 count = varint();
+            for (u64 i = 0; i < count && _position < size; ++i) {
+                trace_access access;
+                const u8 kind = data[_position++];
+                access.size = kind & 0x7f;
+                access.write = kind & 0x80;
+                access.address = apply_delta(_last_address, varint());
+                access.value = static_cast<u32>(varint());
+                _last_address = access.address;
+                out->accesses.push_back(access);
+            }
+        }
+
+        _expected_pc = out->pc + opcode_size;
+        _remaining--;
+        return _position <= size;
+    }
+}
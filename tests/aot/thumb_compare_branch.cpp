@@ -0,0 +1,45 @@
+// Generated by write_aot_source, compile as a shared object against the arm7tdmi headers.
+
+#include <bit>
+
+#include <arm7tdmi/aot.h>
+
+namespace {
+    u32 block_thumb_00000000(arm7tdmi::aot_context& c) noexcept {
+    // 0x00000000: mov r0, #5
+    { c.r[0] = 5u; c.cpsr = (c.cpsr & 0x3fffffffu) | 0u; }
+    // 0x00000002: add r0, #3
+    { c.r[0] = arm7tdmi::aot_add(c, c.r[0], 3u); }
+    // 0x00000004: cmp r0, #8
+    { arm7tdmi::aot_subtract(c, c.r[0], 8u); }
+    // 0x00000006: beq 0x0000000c
+    { if (arm7tdmi::util::condition_passed(c.cpsr, 0u)) { c.r[15] = 0x0000000cu; c.branched = true; c.branch_end = 0x00000008u; return 4; } c.r[15] = 0x00000008u; return 4; }
+    }
+
+    u32 block_thumb_00000008(arm7tdmi::aot_context& c) noexcept {
+    // 0x00000008: mov r1, #1
+    { c.r[1] = 1u; c.cpsr = (c.cpsr & 0x3fffffffu) | 0u; }
+    // 0x0000000a: b 0x0000000a
+    { c.r[15] = 0x0000000au; c.branched = true; c.branch_end = 0x0000000cu; return 2; }
+    }
+
+    u32 block_thumb_0000000a(arm7tdmi::aot_context& c) noexcept {
+    // 0x0000000a: b 0x0000000a
+    { c.r[15] = 0x0000000au; c.branched = true; c.branch_end = 0x0000000cu; return 1; }
+    }
+
+    u32 block_thumb_0000000c(arm7tdmi::aot_context& c) noexcept {
+    // 0x0000000c: b 0x0000000c
+    { c.r[15] = 0x0000000cu; c.branched = true; c.branch_end = 0x0000000eu; return 1; }
+    }
+
+}
+
+extern "C" const u32 arm7tdmi_aot_abi_version = 2;
+extern "C" const u32 arm7tdmi_aot_block_count = 4;
+extern "C" const arm7tdmi::aot_block arm7tdmi_aot_blocks[] = {
+    {0x00000000u, true, 8u, 0x69f0d4b7dfd033a2ull, 0x00002005u, block_thumb_00000000},
+    {0x00000008u, true, 4u, 0xa36db276b1dd5d64ull, 0x00002101u, block_thumb_00000008},
+    {0x0000000au, true, 2u, 0x0a9db107b6fa0772ull, 0x0000e7feu, block_thumb_0000000a},
+    {0x0000000cu, true, 2u, 0x0a9db107b6fa0772ull, 0x0000e7feu, block_thumb_0000000c},
+};
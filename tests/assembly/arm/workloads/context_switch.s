@@ -0,0 +1,72 @@
+@ Round robin switching between four tasks, saving and restoring R0-R12 with LDMIA/STMIA
+@ on every switch, 4096 switches. Then a hash of every task's saved context (h = h * 33 ^ word).
+@ Result in R0: 0xD8AAF9A1
+
+.section .text
+.global _start
+
+.equ TASKS, 0x20000             @ 4 contexts of 16 words, R0-R12 and 3 unused.
+.equ SWITCHES, 4096
+
+_start:
+    LDR SP, =0x40000
+
+    @ Word k of task t starts as t * 16 + k
+    LDR R0, =TASKS
+    MOV R1, #0
+init:
+    STR R1, [R0], #4
+    ADD R1, R1, #1
+    CMP R1, #64
+    BNE init
+
+    MOV R11, #0                 @ Switches so far.
+schedule:
+    AND R0, R11, #3
+    LDR R1, =TASKS
+    ADD R1, R1, R0, LSL #6
+    STMFD SP!, {R1, R11}        @ Scheduler state.
+    LDMIA R1, {R0-R12}          @ Switch in.
+    BL task
+    LDR R14, [SP]
+    STMIA R14, {R0-R12}         @ Switch out.
+    LDMFD SP!, {R1, R11}
+    ADD R11, R11, #1
+    CMP R11, #SWITCHES
+    BNE schedule
+
+    LDR R0, =TASKS
+    MOV R1, #4
+    MOV R2, #0
+hash_task:
+    MOV R3, #13
+hash_word:
+    LDR R4, [R0], #4
+    ADD R2, R2, R2, LSL #5
+    EOR R2, R2, R4
+    SUBS R3, R3, #1
+    BNE hash_word
+    ADD R0, R0, #12             @ Skip the unused words.
+    SUBS R1, R1, #1
+    BNE hash_task
+
+    MOV R0, R2
+done:
+    B done
+
+@ Every task runs the same body on its own registers.
+task:
+    ADD R0, R0, R1
+    EOR R1, R1, R2, ROR #7
+    ADD R2, R2, R3, LSL #1
+    SUB R3, R3, R4
+    EOR R4, R4, R5
+    ADD R5, R5, R6
+    ADD R6, R6, R7, LSR #3
+    EOR R7, R7, R8
+    ADD R8, R8, R9
+    RSB R9, R9, R10
+    EOR R10, R10, R11
+    ADD R11, R11, R12
+    ADD R12, R12, R0
+    MOV PC, R14
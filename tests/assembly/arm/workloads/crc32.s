@@ -0,0 +1,45 @@
+@ CRC-32 (IEEE 802.3, reflected, bitwise) over 4 KiB of pseudo-random bytes.
+@ Result in R0: 0xC39B3FFA, the same as the thumb version.
+
+.section .text
+.global _start
+
+.equ BUFFER, 0x20000
+.equ LENGTH, 4096
+
+_start:
+    LDR SP, =0x40000
+
+    @ Fill the buffer from a linear congruential generator
+    LDR R0, =BUFFER
+    LDR R1, =LENGTH
+    LDR R2, =12345              @ Seed.
+    LDR R3, =1103515245
+    LDR R4, =12345
+fill:
+    MLA R5, R2, R3, R4          @ x = x * a + c
+    MOV R2, R5
+    MOV R5, R2, LSR #16
+    STRB R5, [R0], #1
+    SUBS R1, R1, #1
+    BNE fill
+
+    LDR R0, =BUFFER
+    LDR R1, =LENGTH
+    MVN R2, #0                  @ crc = 0xFFFFFFFF
+    LDR R3, =0xEDB88320
+crc_byte:
+    LDRB R4, [R0], #1
+    EOR R2, R2, R4
+    MOV R5, #8
+crc_bit:
+    MOVS R2, R2, LSR #1         @ Carry is the bit shifted out.
+    EORCS R2, R2, R3
+    SUBS R5, R5, #1
+    BNE crc_bit
+    SUBS R1, R1, #1
+    BNE crc_byte
+
+    MVN R0, R2
+done:
+    B done
@@ -0,0 +1,135 @@
+@ Dhrystone style integer mix: procedure calls, array indexing, record copies,
+@ string comparison and division, 1000 iterations.
+@ Result in R0: 0xE783A7DA
+
+.section .text
+.global _start
+
+.equ ITERATIONS, 1000
+.equ ARRAY, 0x20000             @ 64 words.
+.equ RECORD_A, 0x20100          @ 4 words.
+.equ RECORD_B, 0x20120          @ 4 words.
+.equ STRING_B, 0x20200          @ 16 bytes.
+
+_start:
+    LDR SP, =0x40000
+
+    LDR R0, =ARRAY
+    MOV R1, #0
+    MOV R2, #64
+clear_array:
+    STR R1, [R0], #4
+    SUBS R2, R2, #1
+    BNE clear_array
+
+    LDR R0, =RECORD_A
+    MOV R1, #1
+init_record:
+    STR R1, [R0], #4
+    ADD R1, R1, #1
+    CMP R1, #5
+    BNE init_record
+
+    ADR R0, string_a
+    LDR R1, =STRING_B
+    LDMIA R0, {R2-R5}
+    STMIA R1, {R2-R5}
+
+    MOV R11, #0                 @ Checksum.
+    MOV R10, #0                 @ Iteration.
+    LDR R9, =ITERATIONS
+loop:
+    ADD R10, R10, #1
+
+    MOV R0, R10
+    BL mul_add
+    ADD R11, R11, R0
+
+    @ ARRAY[i & 63] += i
+    LDR R1, =ARRAY
+    AND R2, R10, #63
+    LDR R3, [R1, R2, LSL #2]
+    ADD R3, R3, R10
+    STR R3, [R1, R2, LSL #2]
+    EOR R11, R11, R3
+
+    @ RECORD_B = RECORD_A, then RECORD_A[i & 3] += checksum & 0xFF
+    LDR R0, =RECORD_A
+    LDR R1, =RECORD_B
+    LDMIA R0, {R4-R7}
+    STMIA R1, {R4-R7}
+    ADD R11, R11, R4
+    ADD R11, R11, R5
+    ADD R11, R11, R6
+    ADD R11, R11, R7
+    AND R2, R10, #3
+    LDR R3, [R0, R2, LSL #2]
+    AND R4, R11, #0xFF
+    ADD R3, R3, R4
+    STR R3, [R0, R2, LSL #2]
+
+    @ STRING_B[i & 15] = 'A' + (i & 7), then compare against the original
+    LDR R1, =STRING_B
+    AND R2, R10, #15
+    AND R3, R10, #7
+    ADD R3, R3, #0x41
+    STRB R3, [R1, R2]
+    ADR R0, string_a
+    BL common_prefix
+    ADD R11, R11, R0
+
+    MOV R0, R11
+    MOV R1, #7
+    BL udiv
+    ADD R11, R11, R1
+    MOV R11, R11, ROR #3
+
+    CMP R10, R9
+    BNE loop
+
+    MOV R0, R11
+done:
+    B done
+
+@ R0 = R0 * 3 + 7
+mul_add:
+    ADD R0, R0, R0, LSL #1
+    ADD R0, R0, #7
+    MOV PC, R14
+
+@ R0 = length of the common prefix of the 16 byte strings at R0 and R1.
+common_prefix:
+    MOV R12, #0
+prefix_loop:
+    LDRB R2, [R0, R12]
+    LDRB R3, [R1, R12]
+    CMP R2, R3
+    BNE prefix_done
+    ADD R12, R12, #1
+    CMP R12, #16
+    BNE prefix_loop
+prefix_done:
+    MOV R0, R12
+    MOV PC, R14
+
+@ R0 = R0 / R1, R1 = R0 % R1, shift and subtract.
+udiv:
+    STMFD SP!, {R4, R14}
+    MOV R2, #0                  @ Quotient.
+    MOV R3, #0                  @ Remainder.
+    MOV R4, #32
+udiv_loop:
+    MOVS R0, R0, LSL #1
+    ADC R3, R3, R3
+    CMP R3, R1
+    SUBHS R3, R3, R1
+    ADC R2, R2, R2              @ Carry is set by the compare when the divisor went in.
+    SUBS R4, R4, #1
+    BNE udiv_loop
+    MOV R0, R2
+    MOV R1, R3
+    LDMFD SP!, {R4, PC}
+
+.align 2
+string_a:
+    .ascii "DHRYSTONE STRING"
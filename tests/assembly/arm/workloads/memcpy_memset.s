@@ -0,0 +1,80 @@
+@ memset and memcpy of an 8 KiB buffer with 8 register LDMIA/STMIA blocks, 16 rounds,
+@ hashing the destination after every round (h = h * 33 ^ word).
+@ Result in R0: 0x7E04A7C0, the same as the thumb version.
+
+.section .text
+.global _start
+
+.equ SOURCE, 0x20000
+.equ DESTINATION, 0x28000
+.equ SIZE, 8192
+.equ ROUNDS, 16
+
+_start:
+    MOV R10, #0                 @ Round.
+    MOV R11, #0                 @ Hash.
+round:
+    @ Pattern is the byte round + 1 in every lane
+    ADD R2, R10, #1
+    ORR R2, R2, R2, LSL #8
+    ORR R2, R2, R2, LSL #16
+    MOV R3, R2
+    MOV R4, R2
+    MOV R5, R2
+    MOV R6, R2
+    MOV R7, R2
+    MOV R8, R2
+    MOV R9, R2
+
+    LDR R0, =SOURCE
+    MOV R12, #SIZE / 32
+memset:
+    STMIA R0!, {R2-R9}
+    SUBS R12, R12, #1
+    BNE memset
+
+    @ SOURCE[round * 97] = round
+    LDR R0, =SOURCE
+    MOV R3, #97
+    MUL R3, R10, R3
+    STRB R10, [R0, R3]
+
+    LDR R0, =SOURCE
+    LDR R1, =DESTINATION
+    MOV R12, #SIZE / 32
+memcpy:
+    LDMIA R0!, {R2-R9}
+    STMIA R1!, {R2-R9}
+    SUBS R12, R12, #1
+    BNE memcpy
+
+    LDR R0, =DESTINATION
+    MOV R12, #SIZE / 32
+hash:
+    LDMIA R0!, {R2-R9}
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R2
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R3
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R4
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R5
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R6
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R7
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R8
+    ADD R11, R11, R11, LSL #5
+    EOR R11, R11, R9
+    SUBS R12, R12, #1
+    BNE hash
+
+    ADD R10, R10, #1
+    CMP R10, #ROUNDS
+    BNE round
+
+    MOV R0, R11
+done:
+    B done
@@ -0,0 +1,78 @@
+@ Recursive quicksort (Lomuto partition, unsigned) of 512 pseudo-random words,
+@ then a hash of the sorted array (h = h * 31 + word).
+@ Result in R0: 0x6B913A18
+
+.section .text
+.global _start
+
+.equ ARRAY, 0x20000
+.equ COUNT, 512
+
+_start:
+    LDR SP, =0x40000
+
+    LDR R0, =ARRAY
+    LDR R1, =COUNT
+    LDR R2, =12345              @ Seed.
+    LDR R3, =1103515245
+    LDR R4, =12345
+fill:
+    MLA R5, R2, R3, R4          @ x = x * a + c
+    MOV R2, R5
+    STR R2, [R0], #4
+    SUBS R1, R1, #1
+    BNE fill
+
+    LDR R0, =ARRAY
+    LDR R1, =ARRAY + (COUNT - 1) * 4
+    BL quicksort
+
+    LDR R0, =ARRAY
+    LDR R1, =COUNT
+    MOV R2, #0
+hash:
+    LDR R3, [R0], #4
+    RSB R2, R2, R2, LSL #5
+    ADD R2, R2, R3
+    SUBS R1, R1, #1
+    BNE hash
+
+    MOV R0, R2
+done:
+    B done
+
+@ Sorts the words from R0 to R1 inclusive.
+quicksort:
+    CMP R0, R1
+    MOVHS PC, R14
+    STMFD SP!, {R4-R6, R14}
+    LDR R2, [R1]                @ Pivot is the last element.
+    SUB R3, R0, #4              @ i = lo - 1
+    MOV R4, R0                  @ j = lo
+partition:
+    CMP R4, R1
+    BHS partition_done
+    LDR R5, [R4]
+    CMP R5, R2
+    BHI partition_next
+    ADD R3, R3, #4
+    LDR R6, [R3]
+    STR R5, [R3]
+    STR R6, [R4]
+partition_next:
+    ADD R4, R4, #4
+    B partition
+partition_done:
+    ADD R3, R3, #4
+    LDR R6, [R3]
+    STR R2, [R3]
+    STR R6, [R1]
+
+    MOV R4, R3
+    MOV R5, R1
+    SUB R1, R3, #4
+    BL quicksort                @ lo, pivot - 1
+    ADD R0, R4, #4
+    MOV R1, R5
+    BL quicksort                @ pivot + 1, hi
+    LDMFD SP!, {R4-R6, PC}
@@ -0,0 +1,59 @@
+@ Interrupt heavy timer loop. The host raises IRQ periodically, and lowers it when the
+@ handler writes to TIMER_ACK. The handler counts 1024 ticks, hashing each one into
+@ TIMER_HASH (h = h * 33 ^ tick), while the main loop spins until the count is reached.
+@ Result in R0: 0xF5BFE400
+
+.section .text
+.global _start
+
+.equ TIMER_ACK, 0x30000
+.equ TIMER_TICKS, 0x30004
+.equ TIMER_HASH, 0x30008
+.equ TICKS, 1024
+
+_start:
+    @ IRQ vector: LDR PC, [PC, #-4], with the handler address in the next word
+    MOV R0, #0x18
+    LDR R1, =0xE51FF004
+    LDR R2, =irq_handler
+    STMIA R0, {R1, R2}
+
+    MSR CPSR_c, #0xD2           @ IRQ mode, interrupts masked.
+    LDR SP, =0x3F000
+    MSR CPSR_c, #0x53           @ Supervisor mode, IRQ enabled.
+    LDR SP, =0x40000
+
+    LDR R4, =TIMER_ACK
+    MOV R0, #0
+    STR R0, [R4]
+    STR R0, [R4, #4]
+    STR R0, [R4, #8]
+    MOV R5, #0                  @ Background work, not part of the result.
+wait:
+    ADD R5, R5, #1
+    LDR R0, [R4, #4]
+    CMP R0, #TICKS
+    BLO wait
+
+    MSR CPSR_c, #0xD3           @ Mask interrupts.
+    LDR R0, [R4, #8]
+done:
+    B done
+
+irq_handler:
+    STMFD SP!, {R0-R2}
+    LDR R0, =TIMER_ACK
+    MOV R1, #1
+    STR R1, [R0]
+    LDR R1, [R0, #4]
+    CMP R1, #TICKS
+    BHS irq_return              @ Ticks after the last one only acknowledge.
+    ADD R1, R1, #1
+    STR R1, [R0, #4]
+    LDR R2, [R0, #8]
+    ADD R2, R2, R2, LSL #5
+    EOR R2, R2, R1
+    STR R2, [R0, #8]
+irq_return:
+    LDMFD SP!, {R0-R2}
+    SUBS PC, R14, #4
@@ -0,0 +1,64 @@
+@ Bubble sort (unsigned) of 128 pseudo-random words, then a hash of the sorted
+@ array (h = h * 31 + word).
+@ Result in R0: 0x3F184CEE
+
+.section .text
+.global _start
+
+.equ ARRAY, 0x20000
+.equ COUNT, 128
+
+_start:
+    ADR R0, main + 1
+    BX R0
+
+.thumb
+main:
+    LDR R0, =ARRAY
+    MOV R1, #COUNT
+    LDR R2, =12345              @ Seed.
+    LDR R3, =1103515245
+    LDR R4, =12345
+fill:
+    MUL R2, R3                  @ x = x * a + c
+    ADD R2, R2, R4
+    STR R2, [R0, #0]
+    ADD R0, #4
+    SUB R1, #1
+    BNE fill
+
+    MOV R6, #COUNT - 1          @ Passes.
+outer:
+    LDR R0, =ARRAY
+    MOV R1, R6
+inner:
+    LDR R2, [R0, #0]
+    LDR R3, [R0, #4]
+    CMP R2, R3
+    BLS no_swap
+    STR R3, [R0, #0]
+    STR R2, [R0, #4]
+no_swap:
+    ADD R0, #4
+    SUB R1, #1
+    BNE inner
+    SUB R6, #1
+    BNE outer
+
+    LDR R0, =ARRAY
+    MOV R1, #COUNT
+    MOV R2, #0
+hash:
+    LDR R3, [R0, #0]
+    LSL R4, R2, #5
+    SUB R4, R4, R2
+    ADD R2, R4, R3
+    ADD R0, #4
+    SUB R1, #1
+    BNE hash
+
+    MOV R0, R2
+done:
+    B done
+
+.pool
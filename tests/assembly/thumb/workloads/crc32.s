@@ -0,0 +1,56 @@
+@ CRC-32 (IEEE 802.3, reflected, bitwise) over 4 KiB of pseudo-random bytes.
+@ Result in R0: 0xC39B3FFA, the same as the arm version.
+
+.section .text
+.global _start
+
+.equ BUFFER, 0x20000
+.equ LENGTH, 4096
+
+_start:
+    LDR SP, =0x40000
+    ADR R0, main + 1
+    BX R0
+
+.thumb
+main:
+    @ Fill the buffer from a linear congruential generator
+    LDR R0, =BUFFER
+    LDR R1, =LENGTH
+    LDR R2, =12345              @ Seed.
+    LDR R3, =1103515245
+    LDR R4, =12345
+fill:
+    MUL R2, R3                  @ x = x * a + c
+    ADD R2, R2, R4
+    LSR R5, R2, #16
+    STRB R5, [R0, #0]
+    ADD R0, #1
+    SUB R1, #1
+    BNE fill
+
+    LDR R0, =BUFFER
+    LDR R1, =LENGTH
+    MOV R2, #0
+    MVN R2, R2                  @ crc = 0xFFFFFFFF
+    LDR R3, =0xEDB88320
+crc_byte:
+    LDRB R4, [R0, #0]
+    ADD R0, #1
+    EOR R2, R4
+    MOV R5, #8
+crc_bit:
+    LSR R2, R2, #1              @ Carry is the bit shifted out.
+    BCC crc_skip
+    EOR R2, R3
+crc_skip:
+    SUB R5, #1
+    BNE crc_bit
+    SUB R1, #1
+    BNE crc_byte
+
+    MVN R0, R2
+done:
+    B done
+
+.pool
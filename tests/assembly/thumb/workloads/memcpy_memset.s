@@ -0,0 +1,76 @@
+@ memset and memcpy of an 8 KiB buffer with 4 register LDMIA/STMIA blocks, 16 rounds,
+@ hashing the destination after every round (h = h * 33 ^ word).
+@ Result in R0: 0x7E04A7C0, the same as the arm version.
+
+.section .text
+.global _start
+
+.equ SOURCE, 0x20000
+.equ DESTINATION, 0x28000
+.equ SIZE, 8192
+.equ ROUNDS, 16
+
+_start:
+    ADR R0, main + 1
+    BX R0
+
+.thumb
+main:
+    MOV R7, #0                  @ Round.
+    MOV R9, R7                  @ Hash.
+round:
+    @ Pattern is the byte round + 1 in every lane
+    ADD R2, R7, #1
+    LSL R3, R2, #8
+    ORR R2, R3
+    LSL R3, R2, #16
+    ORR R2, R3
+    MOV R3, R2
+    MOV R4, R2
+    MOV R5, R2
+
+    LDR R0, =SOURCE
+    LDR R6, =SIZE / 16
+memset:
+    STMIA R0!, {R2-R5}
+    SUB R6, #1
+    BNE memset
+
+    @ SOURCE[round * 97] = round
+    MOV R1, #97
+    MUL R1, R7
+    LDR R0, =SOURCE
+    STRB R7, [R0, R1]
+
+    LDR R0, =SOURCE
+    LDR R1, =DESTINATION
+    LDR R6, =SIZE / 16
+memcpy:
+    LDMIA R0!, {R2-R5}
+    STMIA R1!, {R2-R5}
+    SUB R6, #1
+    BNE memcpy
+
+    MOV R8, R7
+    MOV R6, R9
+    LDR R0, =DESTINATION
+    LDR R1, =SIZE / 4
+hash:
+    LDMIA R0!, {R2}
+    LSL R3, R6, #5
+    ADD R6, R6, R3
+    EOR R6, R2
+    SUB R1, #1
+    BNE hash
+    MOV R9, R6
+    MOV R7, R8
+
+    ADD R7, #1
+    CMP R7, #ROUNDS
+    BNE round
+
+    MOV R0, R9
+done:
+    B done
+
+.pool
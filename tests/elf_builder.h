@@ -0,0 +1,98 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <arm7tdmi/types.h>
+
+// Builds small ARM executables in memory, so the tests don't need the Arm GNU Toolchain. Each
+// segment becomes a PT_LOAD program header, symbols go in a .symtab, all in section 1.
+struct elf_segment {
+    u32 address;
+    const void* data;
+    u32 file_size;
+    u32 memory_size;
+    u32 flags = 0;
+};
+
+struct elf_symbol {
+    const char* name;
+    u32 value;
+    u32 size;
+    u8 info = 0x12;     // Global function
+};
+
+template <typename T>
+void elf_put(std::vector<u8>& data, const size_t offset, const T value) {
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+inline std::vector<u8> make_elf(const std::initializer_list<elf_segment> segments, const std::initializer_list<elf_symbol> symbols = {},
+                                const u32 entry = 0) {
+    const auto align = [](const size_t offset) { return (offset + 3) & ~size_t{3}; };
+
+    std::vector<u8> data(52 + segments.size() * 32);
+    constexpr u8 ident[] = {0x7f, 'E', 'L', 'F', 1, 1, 1};
+    std::memcpy(data.data(), ident, sizeof(ident));
+    elf_put<u16>(data, 16, 2);          // Executable
+    elf_put<u16>(data, 18, 40);         // ARM
+    elf_put<u32>(data, 24, entry);
+    elf_put<u32>(data, 28, 52);         // Program headers
+    elf_put<u16>(data, 42, 32);
+    elf_put<u16>(data, 44, static_cast<u16>(segments.size()));
+
+    size_t header = 52;
+    for (const auto& segment : segments) {
+        const size_t offset = align(data.size());
+        data.resize(offset + segment.file_size);
+        if (segment.file_size) {
+            std::memcpy(data.data() + offset, segment.data, segment.file_size);
+        }
+        elf_put<u32>(data, header, 1);  // PT_LOAD
+        elf_put<u32>(data, header + 4, static_cast<u32>(offset));
+        elf_put<u32>(data, header + 8, segment.address);
+        elf_put<u32>(data, header + 16, segment.file_size);
+        elf_put<u32>(data, header + 20, segment.memory_size);
+        elf_put<u32>(data, header + 24, segment.flags);
+        header += 32;
+    }
+
+    // Symbols after the null one, and their names
+    std::string names(1, '\0');
+    const size_t symtab = align(data.size());
+    data.resize(symtab + (symbols.size() + 1) * 16);
+    size_t entry_offset = symtab + 16;
+    for (const auto& symbol : symbols) {
+        elf_put<u32>(data, entry_offset, static_cast<u32>(names.size()));
+        elf_put<u32>(data, entry_offset + 4, symbol.value);
+        elf_put<u32>(data, entry_offset + 8, symbol.size);
+        elf_put<u8>(data, entry_offset + 12, symbol.info);
+        elf_put<u16>(data, entry_offset + 14, 1);
+        names += symbol.name;
+        names += '\0';
+        entry_offset += 16;
+    }
+    const size_t strtab = data.size();
+    data.insert(data.end(), names.begin(), names.end());
+
+    // Sections: null, .symtab, .strtab
+    const size_t sections = align(data.size());
+    data.resize(sections + 3 * 40);
+    elf_put<u32>(data, 32, static_cast<u32>(sections));
+    elf_put<u16>(data, 46, 40);
+    elf_put<u16>(data, 48, 3);
+    elf_put<u32>(data, sections + 40 + 4, 2);
+    elf_put<u32>(data, sections + 40 + 16, static_cast<u32>(symtab));
+    elf_put<u32>(data, sections + 40 + 20, static_cast<u32>(strtab - symtab));
+    elf_put<u32>(data, sections + 40 + 24, 2);
+    elf_put<u32>(data, sections + 80 + 4, 3);
+    elf_put<u32>(data, sections + 80 + 16, static_cast<u32>(strtab));
+    elf_put<u32>(data, sections + 80 + 20, static_cast<u32>(names.size()));
+    return data;
+}
@@ -0,0 +1,153 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <arm7tdmi/aot.h>
+#include <arm7tdmi/memory.h>
+
+// Small hand-assembled guest programs shared by the tests. ARM programs list each instruction with
+// its address, since some leave gaps, THUMB programs are contiguous from address 0.
+struct program_word {
+    u32 address;
+    u32 opcode;
+};
+
+template <size_t N>
+void load_program(arm7tdmi::memory_interface& memory, const program_word (&program)[N]) {
+    for (const auto& word : program) {
+        memory.write<u32>(word.address, word.opcode);
+    }
+}
+
+template <size_t N>
+void load_program(arm7tdmi::memory_interface& memory, const u16 (&program)[N]) {
+    for (u32 i = 0; i < N; ++i) {
+        memory.write<u16>(i * 2, program[i]);
+    }
+}
+
+// 0x0000: STMIA R0,{R15}
+// 0x0004: STMIA R1,{R15}
+// 0x0008: B 0x0000
+inline constexpr program_word store_pc_loop[] = {
+    {0x0000, 0xe8808000},
+    {0x0004, 0xe8818000},
+    {0x0008, 0xeafffffc},
+};
+
+// 0x0000: LDMIA R0,{R2}
+// 0x0004: STMIA R1,{R2}
+// 0x0008: B 0x0000
+// 0x0018: B 0x0000       @ IRQ vector
+inline constexpr program_word copy_word_loop[] = {
+    {0x0000, 0xe8900004},
+    {0x0004, 0xe8810004},
+    {0x0008, 0xeafffffc},
+    {0x0018, 0xeafffff8},
+};
+
+// 0x0000: STMIA R0,{R1,R2}
+// 0x0004: LDMIA R0,{R3}
+// 0x0008: B 0x0000
+inline constexpr program_word store_load_loop[] = {
+    {0x0000, 0xe8800006},
+    {0x0004, 0xe8900008},
+    {0x0008, 0xeafffffc},
+};
+
+// 0x0000: BEQ 0x000C
+// 0x0004: STMIA R0,{R15}
+// 0x0008: B 0x0010
+// 0x000C: STMIA R1,{R15}
+// 0x0010: BL 0x0018
+// 0x0018: B 0x0000
+inline constexpr program_word branch_on_zero[] = {
+    {0x0000, 0x0a000001},
+    {0x0004, 0xe8808000},
+    {0x0008, 0xea000000},
+    {0x000c, 0xe8818000},
+    {0x0010, 0xeb000000},
+    {0x0018, 0xeafffff8},
+};
+
+// 0x0000: STMIA R0,{R15}
+// 0x0004: BL 0x000C
+// 0x0008: B 0x0000
+// 0x000C: STMIA R1,{R14}
+// 0x0010: B 0x0008
+inline constexpr program_word call_store_lr[] = {
+    {0x0000, 0xe8808000},
+    {0x0004, 0xeb000000},
+    {0x0008, 0xeafffffc},
+    {0x000c, 0xe8814000},
+    {0x0010, 0xeafffffc},
+};
+
+// 0x0000: BL 0x0010
+// 0x0004: B 0x0000
+// 0x0008: (never executed)
+// 0x000C: (never executed)
+// 0x0010: BX LR
+inline constexpr program_word call_return[] = {
+    {0x0000, 0xeb000002},
+    {0x0004, 0xeafffffd},
+    {0x0010, 0xe12fff1e},
+};
+
+// 0x0000: STMIA R0, {R1}
+// 0x0004: MOV R0, R0
+// 0x0008: B 0x0010, overwritten with B 0x0018 when R0 = 0x0008 and R1 = 0xea000002
+inline constexpr program_word store_over_branch[] = {
+    {0x0000, 0xe8800002},
+    {0x0004, 0xe1a00000},
+    {0x0008, 0xea000000},
+};
+
+// 0x0000: BL 0x0100
+// 0x0004: B 0x0004
+// 0x0100: B 0x0100, the guest's own division
+inline constexpr program_word call_divide[] = {
+    {0x0000, 0xeb00003e},
+    {0x0004, 0xeafffffe},
+    {0x0100, 0xeafffffe},
+};
+
+// Core 0:
+// 0x0000: STMIA R0,{R15}      @ [R0] <- 0
+// 0x0004: B 0x0000
+// Core 1:
+// 0x0100: LDMIA R1,{R2}       @ R2 <- [R1]
+// 0x0104: STMIA R3,{R2}       @ [R3] <- R2
+// 0x0108: B 0x0100
+inline constexpr program_word producer_consumer[] = {
+    {0x0000, 0xe8808000},
+    {0x0004, 0xeafffffd},
+    {0x0100, 0xe8910004},
+    {0x0104, 0xe8830004},
+    {0x0108, 0xeafffffc},
+};
+
+// 0x0000: MOV R0, #5
+// 0x0002: ADD R0, #3
+// 0x0004: CMP R0, #8
+// 0x0006: BEQ 0x000c
+// 0x0008: MOV R1, #1
+// 0x000a: B 0x000a
+// 0x000c: B 0x000c
+inline constexpr u16 thumb_compare_branch[] = {0x2005, 0x3003, 0x2808, 0xd001, 0x2101, 0xe7fe, 0xe7fe};
+
+// thumb_compare_branch as write_aot_source() compiles it from 0x0000, checked in as
+// aot/thumb_compare_branch.cpp and linked into the tests
+extern "C" const u32 arm7tdmi_aot_block_count;
+extern "C" const arm7tdmi::aot_block arm7tdmi_aot_blocks[];
+
+// 0x0000: MOV R0, #100
+// 0x0002: MOV R1, #0
+// 0x0004: ADD R1, #3       loop
+// 0x0006: SUB R0, #1
+// 0x0008: BNE 0x0004
+// 0x000a: STR R1, [R2, #0]
+// 0x000c: B 0x000c
+inline constexpr u16 thumb_count_loop[] = {0x2064, 0x2100, 0x3103, 0x3801, 0xd1fc, 0x6011, 0xe7fe};
@@ -0,0 +1,122 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/aot.h>
+#include <arm7tdmi/coverage.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/hle.h>
+#include <arm7tdmi/memory.h>
+
+#include "programs.h"
+#include "utility.h"
+
+namespace {
+    bool skip_to_end(arm7tdmi::cpu_registers& registers, arm7tdmi::memory_interface&) {
+        registers.r2(0xaa);
+        return false;
+    }
+}
+
+TEST_CASE("aot_source_matches_checked_in_module", "[aot]")
+{
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    load_program(memory, thumb_compare_branch);
+
+    const arm7tdmi::aot_seed seed{0x0000, true};
+    std::ostringstream out;
+    REQUIRE(arm7tdmi::write_aot_source(memory, {&seed, 1}, out) == 4);
+
+    const auto golden = read_binary_from_file<char>("aot/thumb_compare_branch.cpp");
+    REQUIRE(out.str() == std::string(golden.begin(), golden.end()));
+}
+
+TEST_CASE("aot_block_runs_in_one_step", "[aot]")
+{
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    load_program(memory, thumb_compare_branch);
+
+    // Only the block at 0x0000, the interpreter runs the rest
+    const arm7tdmi::aot_block& block = arm7tdmi_aot_blocks[0];
+    REQUIRE(block.address == 0x0000);
+
+    arm7tdmi::aot_module module;
+    module.add({&block, 1});
+    REQUIRE(module.size() == 1);
+    REQUIRE(module.find(0x0000, true) == block.function);
+    REQUIRE(module.find(0x0000, false) == nullptr);
+
+    arm7tdmi::coverage coverage(0x0000, 0x0100);
+    arm7tdmi::hle_hooks hooks;
+    hooks.add(0x000c, skip_to_end);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    cpu.set_aot(&module);
+    cpu.set_coverage(&coverage);
+    cpu.set_hooks(&hooks);
+    coverage.start(cpu.registers.pc());
+
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x000c);
+    REQUIRE(cpu.registers.r0() == 8);
+    REQUIRE(cpu.registers.cpsr_get_z() == 1);
+    REQUIRE(cpu.registers.cpsr_get_c() == 1);
+    REQUIRE(cpu.registers.r2() == 0xaa);
+    REQUIRE(cpu.get_cycles() == 4);
+    REQUIRE(coverage.executed(0x0006));
+    REQUIRE_FALSE(coverage.executed(0x0008));
+
+    // Outside the module the interpreter takes over
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x000c);
+    REQUIRE(cpu.get_cycles() == 5);
+
+    // Code changed since the block was compiled
+    memory.write<u16>(0x0002, 0x3004);
+    REQUIRE(module.verify(memory) == 1);
+    REQUIRE(module.find(0x0000, true) == nullptr);
+}
+
+TEST_CASE("aot_module_matches_interpreter", "[aot]")
+{
+    arm7tdmi::aot_module module;
+    module.add({arm7tdmi_aot_blocks, arm7tdmi_aot_block_count});
+    REQUIRE(module.size() == 4);
+
+    struct result {
+        u32 pc, r0, r1, cpsr;
+        u64 cycles;
+    };
+
+    // Both ways through the program, each until it has spun on its last branch for a while
+    for (const u32 entry : {0x0000u, 0x0008u}) {
+        INFO(entry);
+        auto run = [&](arm7tdmi::aot_module* aot) {
+            auto memory = arm7tdmi::basic_memory(0x1000);
+            load_program(memory, thumb_compare_branch);
+            auto cpu = arm7tdmi::cpu(&memory);
+            cpu.set_state(arm7tdmi::cpu_state::thumb);
+            cpu.set_aot(aot);
+            cpu.registers.pc(entry);
+            cpu.registers.cpsr_set_n(true);
+            cpu.registers.cpsr_set_z(true);
+            while (cpu.get_cycles() < 8) {
+                REQUIRE(cpu.step());
+            }
+            return result{cpu.registers.pc(), cpu.registers.r0(), cpu.registers.r1(), cpu.registers.cpsr(), cpu.get_cycles()};
+        };
+
+        const auto expected = run(nullptr);
+        const auto compiled = run(&module);
+        REQUIRE(compiled.pc == expected.pc);
+        REQUIRE(compiled.r0 == expected.r0);
+        REQUIRE(compiled.r1 == expected.r1);
+        REQUIRE(compiled.cpsr == expected.cpsr);
+        REQUIRE(compiled.cycles == expected.cycles);
+    }
+}
@@ -0,0 +1,124 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <memory>
+
+#include <arm7tdmi/batch.h>
+#include <arm7tdmi/coverage.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+
+#include "programs.h"
+
+namespace {
+    void setup_lane(arm7tdmi::cpu& cpu, const u32 lane) {
+        cpu.registers.r0(0x80);
+        cpu.registers.r1(0x84 + (lane % 3) * 4);
+        cpu.registers.cpsr_set_z(lane % 2 == 0);
+    }
+}
+
+TEST_CASE("batch_matches_scalar_execution", "[batch]")
+{
+    constexpr u32 lanes = 16;
+    constexpr u64 steps = 100;
+
+    std::vector<std::unique_ptr<arm7tdmi::basic_memory>> memories;
+    std::vector<arm7tdmi::memory_interface*> interfaces;
+    for (u32 i = 0; i < lanes; ++i) {
+        memories.push_back(std::make_unique<arm7tdmi::basic_memory>(0x100));
+        load_program(*memories.back(), branch_on_zero);
+        interfaces.push_back(memories.back().get());
+    }
+
+    auto batch = arm7tdmi::cpu_batch(interfaces);
+    for (u32 i = 0; i < lanes; ++i) {
+        setup_lane(batch.lane(i), i);
+    }
+    batch.run(steps);
+
+    for (u32 i = 0; i < lanes; ++i) {
+        auto memory = arm7tdmi::basic_memory(0x100);
+        load_program(memory, branch_on_zero);
+        auto cpu = arm7tdmi::cpu(&memory);
+        setup_lane(cpu, i);
+        for (u64 c = 0; c < steps; ++c) {
+            REQUIRE(cpu.step());
+        }
+
+        REQUIRE_FALSE(batch.halted(i));
+        REQUIRE(batch.lane(i).get_cycles() == steps);
+        for (size_t r = 0; r < std::size(cpu.registers.data); ++r) {
+            REQUIRE(batch.lane(i).registers.data[r] == cpu.registers.data[r]);
+        }
+        for (u32 address = 0x80; address < 0x90; address += 4) {
+            u32 expected = 0, actual = 0;
+            REQUIRE(memory.read<u32>(address, &expected));
+            REQUIRE(memories[i]->read<u32>(address, &actual));
+            REQUIRE(actual == expected);
+        }
+    }
+
+    // Lanes split on the BEQ and rejoin at 0x0010, so most steps are shared
+    const auto& stats = batch.statistics();
+    REQUIRE(stats.scalar_steps == 0);
+    REQUIRE(stats.lockstep_lanes == lanes * steps);
+    REQUIRE(stats.lockstep_steps < steps * 2);
+
+    // A lane the host moves leaves its group on the next step
+    const u32 pc = batch.lane(1).registers.pc();
+    batch.lane(0).registers.pc(0x0018);
+    batch.step();
+    REQUIRE(batch.lane(0).registers.pc() == 0x0000);
+    REQUIRE(batch.lane(1).registers.pc() != pc);
+    REQUIRE(stats.scalar_steps == 1);
+}
+
+TEST_CASE("batch_lanes_keep_their_instrumentation", "[batch]")
+{
+    constexpr u32 lanes = 4;
+    constexpr u64 steps = 40;
+
+    std::vector<std::unique_ptr<arm7tdmi::basic_memory>> memories;
+    std::vector<arm7tdmi::memory_interface*> interfaces;
+    for (u32 i = 0; i < lanes; ++i) {
+        memories.push_back(std::make_unique<arm7tdmi::basic_memory>(0x100));
+        load_program(*memories.back(), branch_on_zero);
+        interfaces.push_back(memories.back().get());
+    }
+
+    auto batch = arm7tdmi::cpu_batch(interfaces);
+    std::vector<std::unique_ptr<arm7tdmi::coverage>> coverages;
+    for (u32 i = 0; i < lanes; ++i) {
+        setup_lane(batch.lane(i), i);
+        coverages.push_back(std::make_unique<arm7tdmi::coverage>(0x0000, 0x0100));
+        batch.lane(i).set_coverage(coverages.back().get());
+    }
+    // Executes from its own cache, so never joins a group
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    batch.lane(lanes - 1).set_predecode(&cache);
+    batch.run(steps);
+
+    for (u32 i = 0; i < lanes; ++i) {
+        auto memory = arm7tdmi::basic_memory(0x100);
+        load_program(memory, branch_on_zero);
+        auto cpu = arm7tdmi::cpu(&memory);
+        setup_lane(cpu, i);
+        arm7tdmi::coverage coverage(0x0000, 0x0100);
+        cpu.set_coverage(&coverage);
+        for (u64 c = 0; c < steps; ++c) {
+            REQUIRE(cpu.step());
+        }
+
+        REQUIRE(batch.lane(i).registers.pc() == cpu.registers.pc());
+        REQUIRE(batch.lane(i).get_cycles() == steps);
+        REQUIRE(coverages[i]->executed_halfwords() == coverage.executed_halfwords());
+        REQUIRE(std::equal(coverage.edges(), coverage.edges() + arm7tdmi::coverage::edge_map_size, coverages[i]->edges()));
+    }
+
+    REQUIRE(batch.statistics().scalar_steps >= steps);
+}
@@ -0,0 +1,163 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <cstring>
+#include <random>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+
+namespace {
+    constexpr u32 loop_exit = 0x0100;
+    constexpr u32 irq_vector = 0x0018;
+
+    struct loop_result {
+        u32 registers[16] = {};
+        u32 cpsr = 0;
+        u64 cycles = 0;
+        u32 steps = 0;
+    };
+
+    // Loads the THUMB loop at 0x0000, with B . at loop_exit and the IRQ vector, random data from 0x1000
+    // and the given registers, then steps until the loop exits or the IRQ scheduled for irq_cycle is taken.
+    loop_result run_loop(arm7tdmi::basic_memory& memory, std::initializer_list<u16> loop, std::initializer_list<std::pair<u32, u32>> setup, const bool block_loops,
+                         const u64 irq_cycle = ~0ull) {
+        std::mt19937 rng(46);
+        for (u32 address = 0x1000; address < memory.size(); address += 4) {
+            memory.write<u32>(address, rng());
+        }
+        u32 address = 0;
+        for (const u16 opcode : loop) {
+            memory.write<u16>(address, opcode);
+            address += 2;
+        }
+        // B loop_exit
+        memory.write<u16>(address, static_cast<u16>(0xe000 | (((loop_exit - address - 4) >> 1) & 0x7ff)));
+        memory.write<u16>(loop_exit, 0xe7fe);
+        memory.write<u32>(irq_vector, 0xeafffffe);
+
+        arm7tdmi::predecode_cache cache(0x0000, 0x200);
+        cache.fill(memory);
+
+        auto cpu = arm7tdmi::cpu(&memory);
+        cpu.set_predecode(&cache);
+        cpu.set_block_loops(block_loops);
+        cpu.set_state(arm7tdmi::cpu_state::thumb);
+        for (const auto& [reg, value] : setup) {
+            cpu.registers.set(reg, value);
+        }
+        cpu.schedule_irq(irq_cycle);
+
+        loop_result result;
+        while (cpu.registers.pc() != loop_exit && cpu.registers.pc() != irq_vector && result.steps < 0x10000) {
+            REQUIRE(cpu.step());
+            ++result.steps;
+        }
+        for (u32 i = 0; i < 16; ++i) {
+            result.registers[i] = cpu.registers.get(i);
+        }
+        result.cpsr = cpu.registers.cpsr();
+        result.cycles = cpu.get_cycles();
+        return result;
+    }
+
+    void require_same(const loop_result& a, const arm7tdmi::basic_memory& a_memory, const loop_result& b, const arm7tdmi::basic_memory& b_memory) {
+        for (u32 i = 0; i < 16; ++i) {
+            REQUIRE(a.registers[i] == b.registers[i]);
+        }
+        REQUIRE(a.cpsr == b.cpsr);
+        REQUIRE(a.cycles == b.cycles);
+        REQUIRE(std::memcmp(a_memory.data(), b_memory.data(), a_memory.size()) == 0);
+    }
+}
+
+TEST_CASE("block_loop_copy", "[block_loops]")
+{
+    // LDMIA R1!, {R3-R6}; STMIA R0!, {R3-R6}; SUB R2, #16; BNE 0x0000
+    const auto loop = {u16{0xc978}, u16{0xc078}, u16{0x3a10}, u16{0xd1fb}};
+    const auto setup = {std::pair<u32, u32>{0, 0x2000}, {1, 0x1000}, {2, 0x400}};
+
+    auto stepped_memory = arm7tdmi::basic_memory(0x4000);
+    auto bulk_memory = arm7tdmi::basic_memory(0x4000);
+    const auto stepped = run_loop(stepped_memory, loop, setup, false);
+    const auto bulk = run_loop(bulk_memory, loop, setup, true);
+
+    REQUIRE(stepped.steps == 0x40 * 4 + 1);
+    REQUIRE(bulk.steps == 2);
+    REQUIRE(bulk.registers[0] == 0x2400);
+    REQUIRE(bulk.registers[1] == 0x1400);
+    REQUIRE(bulk.registers[2] == 0);
+    REQUIRE(std::memcmp(bulk_memory.data() + 0x2000, bulk_memory.data() + 0x1000, 0x400) == 0);
+    require_same(stepped, stepped_memory, bulk, bulk_memory);
+}
+
+TEST_CASE("block_loop_fill", "[block_loops]")
+{
+    auto stepped_memory = arm7tdmi::basic_memory(0x4000);
+    auto bulk_memory = arm7tdmi::basic_memory(0x4000);
+
+    SECTION("stmia") {
+        // STMIA R0!, {R3, R4}; SUB R2, #1; BGT 0x0000
+        const auto loop = {u16{0xc018}, u16{0x3a01}, u16{0xdcfc}};
+        const auto setup = {std::pair<u32, u32>{0, 0x2000}, {2, 100}, {3, 0x11223344}, {4, 0xaabbccdd}};
+        const auto stepped = run_loop(stepped_memory, loop, setup, false);
+        const auto bulk = run_loop(bulk_memory, loop, setup, true);
+
+        REQUIRE(bulk.steps == 2);
+        REQUIRE(bulk.registers[0] == 0x2000 + 100 * 8);
+        require_same(stepped, stepped_memory, bulk, bulk_memory);
+    }
+
+    SECTION("str") {
+        // STR R3, [R0]; ADD R0, #4; SUB R2, #1; BNE 0x0000
+        const auto loop = {u16{0x6003}, u16{0x3004}, u16{0x3a01}, u16{0xd1fb}};
+        const auto setup = {std::pair<u32, u32>{0, 0x3000}, {2, 0x123}, {3, 0x5a5a5a5a}};
+        const auto stepped = run_loop(stepped_memory, loop, setup, false);
+        const auto bulk = run_loop(bulk_memory, loop, setup, true);
+
+        REQUIRE(bulk.steps == 2);
+        REQUIRE(bulk.registers[0] == 0x3000 + 0x123 * 4);
+        require_same(stepped, stepped_memory, bulk, bulk_memory);
+    }
+}
+
+TEST_CASE("block_loop_overlapping_copy_is_stepped", "[block_loops]")
+{
+    // Destination one block ahead of the source, so each iteration reads what the last one stored
+    const auto loop = {u16{0xc978}, u16{0xc078}, u16{0x3a10}, u16{0xd1fb}};
+    const auto setup = {std::pair<u32, u32>{0, 0x1010}, {1, 0x1000}, {2, 0x100}};
+
+    auto stepped_memory = arm7tdmi::basic_memory(0x4000);
+    auto bulk_memory = arm7tdmi::basic_memory(0x4000);
+    const auto stepped = run_loop(stepped_memory, loop, setup, false);
+    const auto bulk = run_loop(bulk_memory, loop, setup, true);
+
+    // Only the last iteration, which reads nothing stored by the loop, runs in one step
+    REQUIRE(bulk.steps == stepped.steps - 3);
+    require_same(stepped, stepped_memory, bulk, bulk_memory);
+}
+
+TEST_CASE("block_loop_stops_for_scheduled_irq", "[block_loops]")
+{
+    const auto loop = {u16{0xc978}, u16{0xc078}, u16{0x3a10}, u16{0xd1fb}};
+    const auto setup = {std::pair<u32, u32>{0, 0x2000}, {1, 0x1000}, {2, 0x400}};
+
+    // Due on the first instruction of an iteration, and inside one
+    for (const u64 irq_cycle : {u64{100}, u64{102}}) {
+        INFO(irq_cycle);
+        auto stepped_memory = arm7tdmi::basic_memory(0x4000);
+        auto bulk_memory = arm7tdmi::basic_memory(0x4000);
+        const auto stepped = run_loop(stepped_memory, loop, setup, false, irq_cycle);
+        const auto bulk = run_loop(bulk_memory, loop, setup, true, irq_cycle);
+
+        // The IRQ is entered on its cycle, and its vector's B . executed in the same step
+        REQUIRE(stepped.registers[15] == irq_vector);
+        REQUIRE(stepped.cycles == irq_cycle + 1);
+        REQUIRE(bulk.steps < stepped.steps);
+        require_same(stepped, stepped_memory, bulk, bulk_memory);
+    }
+}
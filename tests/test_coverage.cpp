@@ -0,0 +1,113 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <algorithm>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/coverage.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+
+#include "programs.h"
+
+TEST_CASE("coverage_marks_blocks_and_edges", "[coverage]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_program(memory, call_return);
+    auto cpu = arm7tdmi::cpu(&memory);
+
+    arm7tdmi::coverage coverage(0x0000, 0x0100);
+    cpu.set_coverage(&coverage);
+    coverage.start(cpu.registers.pc());
+
+    // Three taken branches per loop
+    for (int i = 0; i < 30; ++i) {
+        REQUIRE(cpu.step());
+    }
+
+    REQUIRE(coverage.executed(0x0000));
+    REQUIRE(coverage.executed(0x0006));
+    REQUIRE_FALSE(coverage.executed(0x0008));
+    REQUIRE_FALSE(coverage.executed(0x000c));
+    REQUIRE(coverage.executed(0x0010));
+    REQUIRE_FALSE(coverage.executed(0x0014));
+    REQUIRE(coverage.executed_halfwords() == 6);
+
+    // Every loop takes the same three edges. Address 0 hashes to 0, so the first edge from the start matches the loop's.
+    std::vector<u32> counts;
+    for (u32 i = 0; i < arm7tdmi::coverage::edge_map_size; ++i) {
+        if (coverage.edges()[i] != 0) {
+            counts.push_back(coverage.edges()[i]);
+        }
+    }
+    std::sort(counts.begin(), counts.end());
+    REQUIRE(counts == std::vector<u32>{10, 10, 10});
+
+    coverage.reset();
+    REQUIRE(coverage.executed_halfwords() == 0);
+    REQUIRE(std::all_of(coverage.edges(), coverage.edges() + arm7tdmi::coverage::edge_map_size, [](const u8 n) { return n == 0; }));
+}
+
+TEST_CASE("coverage_external_edge_map", "[coverage]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_program(memory, call_return);
+    auto cpu = arm7tdmi::cpu(&memory);
+
+    std::vector<u8> map(arm7tdmi::coverage::edge_map_size);
+    arm7tdmi::coverage coverage(0x0000, 0x0100);
+    coverage.attach(map.data());
+    cpu.set_coverage(&coverage);
+
+    REQUIRE(cpu.step());
+    REQUIRE(std::count(map.begin(), map.end(), 1) == 1);
+
+    // Without AFL running there is no segment to attach to
+    REQUIRE_FALSE(coverage.attach_afl_shared_memory());
+}
+
+TEST_CASE("coverage_long_blocks", "[coverage]")
+{
+    // 0x0000-0x23fc: MOV R0, R0
+    // 0x2400: B 0x2400
+    auto memory = arm7tdmi::basic_memory(0x4000);
+    for (u32 address = 0; address < 0x2400; address += 4) {
+        memory.write<u32>(address, 0xe1a00000);
+    }
+    memory.write<u32>(0x2400, 0xeafffffe);
+
+    // The first block starts where the cpu is when coverage is attached
+    arm7tdmi::coverage from_pc(0x0000, 0x4000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.registers.pc(0x1000);
+    cpu.set_coverage(&from_pc);
+    for (u32 i = 0; i < 0x501; ++i) {
+        REQUIRE(cpu.step());
+    }
+    REQUIRE_FALSE(from_pc.executed(0x0ffe));
+    REQUIRE(from_pc.executed(0x1000));
+    REQUIRE(from_pc.executed(0x2402));
+    REQUIRE(from_pc.executed_halfwords() == 0x1404 / 2);
+    REQUIRE(from_pc.truncated_blocks() == 0);
+
+    // A block longer than max_block_size is marked up to it
+    arm7tdmi::coverage from_start(0x0000, 0x4000);
+    cpu = arm7tdmi::cpu(&memory);
+    cpu.set_coverage(&from_start);
+    for (u32 i = 0; i < 0x901; ++i) {
+        REQUIRE(cpu.step());
+    }
+    REQUIRE(from_start.truncated_blocks() == 1);
+    REQUIRE(from_start.executed(0x0000));
+    REQUIRE(from_start.executed(arm7tdmi::coverage::max_block_size - 2));
+    REQUIRE_FALSE(from_start.executed(arm7tdmi::coverage::max_block_size));
+
+    // The branch looping on itself is a short block
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.step());
+    REQUIRE(from_start.truncated_blocks() == 1);
+    REQUIRE(from_start.executed(0x2400));
+}
@@ -2,7 +2,11 @@
 // Created by talexander on 9/4/2024.
 //
 
+#include <algorithm>
 #include <iostream>
+#include <random>
+#include <vector>
+
 #include <catch2/catch_test_macros.hpp>
 
 #include <arm7tdmi/decoder.h>
@@ -140,4 +144,37 @@ TEST_CASE("arm_decode_data_processing", "[decode]") {
     }
 }
 
-#endif
\ No newline at end of file
+#endif
+
+TEST_CASE("arm_decode_patterns", "[decode]") {
+    // Every combination of the bits any pattern tests, with the rest of the opcode held at 0 or 1
+    const auto patterns = arm7tdmi::arm::patterns();
+    for (u32 fill : {0u, 0xffffffffu}) {
+        for (u32 high = 0; high < 0x100; ++high) {
+            for (u32 low = 0; low < 0x100; ++low) {
+                const u32 tested = high << 20 | (low & 0xf0) | (low & 0x0f) << 12;
+                const u32 opcode = (fill & ~0x0ff0f0f0u) | tested;
+                const auto it = std::find_if(patterns.begin(), patterns.end(), [&](const auto& p) { return (opcode & p.mask) == p.format; });
+                const auto expected = it == patterns.end() ? arm7tdmi::arm::instruction::unknown : it->instr;
+                REQUIRE(arm7tdmi::arm::decode(opcode) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("arm_decode_batch", "[decode]") {
+    // Every table index, with the bits outside it both random and set to the BX / PSR transfer fields
+    std::mt19937 rng(41);
+    std::vector<u32> opcodes;
+    for (u32 index = 0; index < 0x1000; ++index) {
+        const u32 bits = (index & 0xff0) << 16 | (index & 0xf) << 4;
+        for (const u32 rest : {static_cast<u32>(rng()), 0u, 0xfff00u, 0xff00fu, 0xf000fu}) {
+            opcodes.push_back(bits | (rest & ~0x0ff000f0u));
+        }
+    }
+    std::vector<arm7tdmi::arm::instruction> out(opcodes.size());
+    arm7tdmi::arm::decode_batch(opcodes, out);
+    for (size_t i = 0; i < opcodes.size(); ++i) {
+        REQUIRE(out[i] == arm7tdmi::arm::decode(opcodes[i]));
+    }
+}
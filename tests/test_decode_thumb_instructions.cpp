@@ -2,6 +2,9 @@
 // Created by talexander on 9/4/2024.
 //
 
+#include <algorithm>
+#include <vector>
+
 #include <catch2/catch_test_macros.hpp>
 
 #include <arm7tdmi/decoder.h>
@@ -166,4 +169,26 @@ TEST_CASE("thumb_decode_move_shifted_register", "[decode]") {
     }
 }
 
-#endif
\ No newline at end of file
+#endif
+
+TEST_CASE("thumb_decode_patterns", "[decode]") {
+    // patterns() must describe decode() exactly, tools/decodeverify checks the same for every ARM opcode
+    const auto patterns = arm7tdmi::thumb::patterns();
+    for (u32 opcode = 0; opcode <= 0xffff; ++opcode) {
+        const auto it = std::find_if(patterns.begin(), patterns.end(), [&](const auto& p) { return (opcode & p.mask) == p.format; });
+        const auto expected = it == patterns.end() ? arm7tdmi::thumb::instruction::unknown : it->instr;
+        REQUIRE(arm7tdmi::thumb::decode(static_cast<u16>(opcode)) == expected);
+    }
+}
+
+TEST_CASE("thumb_decode_batch", "[decode]") {
+    std::vector<u16> opcodes(0x10000);
+    for (u32 opcode = 0; opcode <= 0xffff; ++opcode) {
+        opcodes[opcode] = static_cast<u16>(opcode);
+    }
+    std::vector<arm7tdmi::thumb::instruction> out(opcodes.size());
+    arm7tdmi::thumb::decode_batch(opcodes, out);
+    for (const u16 opcode : opcodes) {
+        REQUIRE(out[opcode] == arm7tdmi::thumb::decode(opcode));
+    }
+}
@@ -0,0 +1,127 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/disassembler.h>
+
+namespace {
+    std::string arm_text(const u32 opcode, const u32 address = 0) {
+        char buffer[arm7tdmi::disassembly_line_size];
+        const size_t length = arm7tdmi::arm::disassemble(opcode, address, buffer, sizeof(buffer));
+        return {buffer, length};
+    }
+
+    std::string thumb_text(const u16 opcode, const u32 address = 0) {
+        char buffer[arm7tdmi::disassembly_line_size];
+        const size_t length = arm7tdmi::thumb::disassemble(opcode, address, buffer, sizeof(buffer));
+        return {buffer, length};
+    }
+}
+
+TEST_CASE("disassemble_arm", "[disassembler]")
+{
+    // Data processing
+    REQUIRE(arm_text(0xe3a00001) == "mov r0, #1");
+    REQUIRE(arm_text(0xe0910002) == "adds r0, r1, r2");
+    REQUIRE(arm_text(0x10810102) == "addne r0, r1, r2, lsl #2");
+    REQUIRE(arm_text(0xe1a00231) == "mov r0, r1, lsr r2");
+    REQUIRE(arm_text(0xe1a00061) == "mov r0, r1, rrx");
+    REQUIRE(arm_text(0xe1a00021) == "mov r0, r1, lsr #32");
+    REQUIRE(arm_text(0xe3500000) == "cmp r0, #0");
+    REQUIRE(arm_text(0xe3a004ff) == "mov r0, #0xff000000");
+
+    // PSR transfer, multiply, swap
+    REQUIRE(arm_text(0xe10f0000) == "mrs r0, cpsr");
+    REQUIRE(arm_text(0xe14f0000) == "mrs r0, spsr");
+    REQUIRE(arm_text(0xe129f000) == "msr cpsr_fc, r0");
+    REQUIRE(arm_text(0xe328f20f) == "msr cpsr_f, #0xf0000000");
+    REQUIRE(arm_text(0xe0010392) == "mul r1, r2, r3");
+    REQUIRE(arm_text(0xe0210392) == "mla r1, r2, r3, r0");
+    REQUIRE(arm_text(0xe0810392) == "umull r0, r1, r2, r3");
+    REQUIRE(arm_text(0xe0f10392) == "smlals r0, r1, r2, r3");
+    REQUIRE(arm_text(0xe1420091) == "swpb r0, r1, [r2]");
+
+    // Transfers
+    REQUIRE(arm_text(0xe5910004) == "ldr r0, [r1, #4]");
+    REQUIRE(arm_text(0xe5310004) == "ldr r0, [r1, #-4]!");
+    REQUIRE(arm_text(0xe4910004) == "ldr r0, [r1], #4");
+    REQUIRE(arm_text(0xe7910102) == "ldr r0, [r1, r2, lsl #2]");
+    REQUIRE(arm_text(0xe59f0008, 0x100) == "ldr r0, [pc, #8] ; 0x00000110");
+    REQUIRE(arm_text(0xe5c10000) == "strb r0, [r1]");
+    REQUIRE(arm_text(0xe1d100b2) == "ldrh r0, [r1, #2]");
+    REQUIRE(arm_text(0xe19100f2) == "ldrsh r0, [r1, r2]");
+    REQUIRE(arm_text(0xe8bd8010) == "ldmia sp!, {r4, pc}");
+    REQUIRE(arm_text(0xe92d40f0) == "stmdb sp!, {r4-r7, lr}");
+    REQUIRE(arm_text(0xe8d00003) == "ldmia r0, {r0, r1}^");
+
+    // Branches and the rest
+    REQUIRE(arm_text(0xea000000) == "b 0x00000008");
+    REQUIRE(arm_text(0xebfffffe, 0x100) == "bl 0x00000100");
+    REQUIRE(arm_text(0x012fff1e) == "bxeq lr");
+    REQUIRE(arm_text(0xef000011) == "swi 0x11");
+    REQUIRE(arm_text(0xe7f000f0) == "undefined");
+    REQUIRE(arm_text(0xec000000) == ".word 0xec000000");
+}
+
+TEST_CASE("disassemble_thumb", "[disassembler]")
+{
+    REQUIRE(thumb_text(0x0088) == "lsl r0, r1, #2");
+    REQUIRE(thumb_text(0x0848) == "lsr r0, r1, #1");
+    REQUIRE(thumb_text(0x1888) == "add r0, r1, r2");
+    REQUIRE(thumb_text(0x1e48) == "sub r0, r1, #1");
+    REQUIRE(thumb_text(0x2aff) == "cmp r2, #255");
+    REQUIRE(thumb_text(0x4348) == "mul r0, r1");
+    REQUIRE(thumb_text(0x4770) == "bx lr");
+    REQUIRE(thumb_text(0x46c0) == "mov r8, r8");
+    REQUIRE(thumb_text(0x4801, 0x102) == "ldr r0, [pc, #4] ; 0x00000108");
+    REQUIRE(thumb_text(0x5088) == "str r0, [r1, r2]");
+    REQUIRE(thumb_text(0x5e88) == "ldrsh r0, [r1, r2]");
+    REQUIRE(thumb_text(0x6848) == "ldr r0, [r1, #4]");
+    REQUIRE(thumb_text(0x7848) == "ldrb r0, [r1, #1]");
+    REQUIRE(thumb_text(0x8848) == "ldrh r0, [r1, #2]");
+    REQUIRE(thumb_text(0x9001) == "str r0, [sp, #4]");
+    REQUIRE(thumb_text(0xa901) == "add r1, sp, #4");
+    REQUIRE(thumb_text(0xb082) == "sub sp, #8");
+    REQUIRE(thumb_text(0xb5f0) == "push {r4-r7, lr}");
+    REQUIRE(thumb_text(0xbdf0) == "pop {r4-r7, pc}");
+    REQUIRE(thumb_text(0xc807) == "ldmia r0!, {r0-r2}");
+    REQUIRE(thumb_text(0xd0fe, 0x100) == "beq 0x00000100");
+    REQUIRE(thumb_text(0xdf05) == "swi 0x5");
+    REQUIRE(thumb_text(0xe7fe, 0x100) == "b 0x00000100");
+    REQUIRE(thumb_text(0xf000, 0x100) == "bl.hi 0x00000104");
+    REQUIRE(thumb_text(0xf802) == "bl.lo #4");
+    REQUIRE(thumb_text(0xde00) == "undefined");
+    REQUIRE(thumb_text(0xb100) == ".hword 0xb100");
+}
+
+TEST_CASE("disassemble_truncates", "[disassembler]")
+{
+    char buffer[5] = {'x', 'x', 'x', 'x', 'x'};
+    REQUIRE(arm7tdmi::arm::disassemble(0xe3a00001, 0, buffer, sizeof(buffer)) == 4);
+    REQUIRE(std::string(buffer) == "mov ");
+    REQUIRE(arm7tdmi::arm::disassemble(0xe3a00001, 0, buffer, 0) == 0);
+    REQUIRE(buffer[0] == 'm');
+}
+
+TEST_CASE("disassemble_batch", "[disassembler]")
+{
+    const std::vector<u32> arm = {0xe3a00001, 0xea000000, 0xe12fff1e};
+    std::vector<char> out(arm.size() * arm7tdmi::disassembly_line_size);
+    REQUIRE(arm7tdmi::arm::disassemble_batch(arm, 0x100, out) == 3);
+    REQUIRE(std::string(&out[0]) == "mov r0, #1");
+    REQUIRE(std::string(&out[arm7tdmi::disassembly_line_size]) == "b 0x0000010c");
+    REQUIRE(std::string(&out[2 * arm7tdmi::disassembly_line_size]) == "bx lr");
+
+    // Long branch with link pairs are joined, the batch stops when the output is full
+    const std::vector<u16> thumb = {0x2001, 0xf000, 0xf802, 0x4770};
+    out.assign(3 * arm7tdmi::disassembly_line_size, 0);
+    REQUIRE(arm7tdmi::thumb::disassemble_batch(thumb, 0x100, out) == 3);
+    REQUIRE(std::string(&out[0]) == "mov r0, #1");
+    REQUIRE(std::string(&out[arm7tdmi::disassembly_line_size]) == "bl 0x0000010a");
+    REQUIRE(std::string(&out[2 * arm7tdmi::disassembly_line_size]) == "bl.lo #4");
+}
@@ -0,0 +1,60 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/farm.h>
+#include <arm7tdmi/memory.h>
+
+TEST_CASE("farm_runs_every_job", "[farm]")
+{
+    std::vector<arm7tdmi::farm_job> jobs;
+    for (u32 i = 0; i < 64; ++i) {
+        // Run times vary by three orders of magnitude
+        const u64 length = (i % 8 == 0) ? 100000 : 100 + i;
+        jobs.push_back({
+            .memory_size = 0x100,
+            .setup = [](arm7tdmi::cpu& cpu, arm7tdmi::basic_memory& memory) {
+                memory.write<u32>(0x0000, 0xeafffffe); // B .
+            },
+            .done = [length](const arm7tdmi::cpu& cpu, const arm7tdmi::basic_memory&) {
+                return cpu.get_cycles() >= length;
+            },
+        });
+    }
+
+    // PC runs off the end of memory
+    jobs.push_back({.memory_size = 0x10});
+
+    // Never finishes on its own
+    jobs.push_back({
+        .memory_size = 0x100,
+        .setup = [](arm7tdmi::cpu&, arm7tdmi::basic_memory& memory) { memory.write<u32>(0x0000, 0xeafffffe); },
+        .max_cycles = 5000,
+    });
+
+    auto farm = arm7tdmi::execution_farm({.threads = 4, .slice = 1000});
+    const auto results = farm.run(jobs);
+
+    REQUIRE(results.size() == jobs.size());
+    u64 total = 0;
+    for (u32 i = 0; i < 64; ++i) {
+        const u64 length = (i % 8 == 0) ? 100000 : 100 + i;
+        REQUIRE(results[i].status == arm7tdmi::farm_status::completed);
+        REQUIRE(results[i].cycles == length);
+        REQUIRE(results[i].registers.pc() == 0);
+        total += length;
+    }
+
+    REQUIRE(results[64].status == arm7tdmi::farm_status::fault);
+    total += results[64].cycles;
+
+    REQUIRE(results[65].status == arm7tdmi::farm_status::cycle_limit);
+    REQUIRE(results[65].cycles == 5000);
+    REQUIRE(results[65].slices == 5);
+    total += 5000;
+
+    REQUIRE(farm.statistics().cycles == total);
+}
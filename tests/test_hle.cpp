@@ -0,0 +1,93 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/hle.h>
+#include <arm7tdmi/memory.h>
+
+#include "programs.h"
+
+namespace {
+    // Unsigned division as compilers call it, quotient in R0 and remainder in R1
+    bool divide(arm7tdmi::cpu_registers& registers, arm7tdmi::memory_interface&) {
+        if (registers.r1() == 0) {
+            return false;
+        }
+        const u32 n = registers.r0();
+        const u32 d = registers.r1();
+        registers.r0(n / d);
+        registers.r1(n % d);
+        return true;
+    }
+}
+
+TEST_CASE("hle_hook_by_address", "[hle]")
+{
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    load_program(memory, call_divide);
+
+    arm7tdmi::hle_hooks hooks;
+    hooks.add(0x0100, divide);
+    REQUIRE(hooks.find(0x0100) != nullptr);
+    REQUIRE(hooks.find(0x0104) == nullptr);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_hooks(&hooks);
+    cpu.registers.r0(100);
+    cpu.registers.r1(7);
+
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0004);
+    REQUIRE(cpu.registers.r0() == 14);
+    REQUIRE(cpu.registers.r1() == 2);
+    REQUIRE(cpu.get_cycles() == 1);
+
+    // Declined by the hook, so the guest function runs
+    cpu.registers.pc(0x0000);
+    cpu.registers.r1(0);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0100);
+
+    hooks.remove(0x0100);
+    REQUIRE(hooks.find(0x0100) == nullptr);
+}
+
+TEST_CASE("hle_hook_by_signature", "[hle]")
+{
+    // The same function body at 0x0100 in a reference build, and at 0x0300 in the firmware
+    const u32 body[] = {0xe3510000, 0x012fff1e, 0xe1a02000, 0xe12fff1e};
+    auto reference = arm7tdmi::basic_memory(0x1000);
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    for (u32 i = 0; i < std::size(body); ++i) {
+        reference.write<u32>(0x0100 + i * 4, body[i]);
+        memory.write<u32>(0x0300 + i * 4, body[i]);
+    }
+
+    u64 hash = 0;
+    REQUIRE(arm7tdmi::hle_hooks::signature(reference, 0x0100, sizeof(body), &hash));
+
+    arm7tdmi::hle_hooks hooks;
+    hooks.add_signature(hash, sizeof(body), divide);
+    REQUIRE(hooks.resolve(memory, 0x0000, 0x1000) == 1);
+    REQUIRE(hooks.find(0x0300) != nullptr);
+
+    // THUMB caller: BL 0x0300, returning to THUMB state
+    memory.write<u16>(0x0000, 0xf000);
+    memory.write<u16>(0x0002, 0xf97e);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_hooks(&hooks);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    cpu.registers.r0(0xffffffff);
+    cpu.registers.r1(0x10);
+
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0004);
+    REQUIRE(cpu.get_state() == arm7tdmi::cpu_state::thumb);
+    REQUIRE(cpu.registers.r0() == 0x0fffffff);
+    REQUIRE(cpu.registers.r1() == 0xf);
+}
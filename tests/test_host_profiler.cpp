@@ -0,0 +1,43 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/host_profiler.h>
+#include <arm7tdmi/memory.h>
+
+TEST_CASE("host_profiler_attributes_per_class", "[host profiler]")
+{
+    // 0x0000: STMIA R0,{R1}
+    // 0x0004: B 0x0000
+    auto memory = arm7tdmi::basic_memory(0x100);
+    memory.write<u32>(0x0000, 0xe8800002);
+    memory.write<u32>(0x0004, 0xeafffffd);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.registers.r0(0x80);
+
+    arm7tdmi::host_profiler profiler(&memory);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(profiler.step(cpu));
+    }
+
+    REQUIRE(profiler.cost(arm7tdmi::arm::instruction::block_data_transfer).count == 50);
+    REQUIRE(profiler.cost(arm7tdmi::arm::instruction::branch).count == 50);
+    REQUIRE(profiler.cost(arm7tdmi::arm::instruction::data_processing).count == 0);
+    REQUIRE(cpu.get_cycles() == 100);
+
+    std::ostringstream report;
+    profiler.write_report(report);
+    REQUIRE(report.str().find("arm block_data_transfer") != std::string::npos);
+
+    profiler.clear();
+    REQUIRE(profiler.cost(arm7tdmi::arm::instruction::branch).count == 0);
+
+    // Fetch failure ends the run, like cpu::step
+    cpu.registers.pc(0x1000);
+    REQUIRE_FALSE(profiler.step(cpu));
+}
@@ -0,0 +1,52 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/machine.h>
+#include <arm7tdmi/memory.h>
+
+#include "programs.h"
+
+namespace {
+    constexpr u32 shared_address = 0x800;
+    constexpr u32 result_address = 0x900;
+
+    void load_programs(arm7tdmi::basic_memory& memory, arm7tdmi::machine& machine) {
+        load_program(memory, producer_consumer);
+        memory.write<u32>(shared_address, 0xffffffff);
+
+        machine.core(0).registers.r0(shared_address);
+        machine.core(1).registers.pc(0x0100);
+        machine.core(1).registers.r1(shared_address);
+        machine.core(1).registers.r3(result_address);
+    }
+}
+
+TEST_CASE("machine_writes_visible_at_quantum_boundary", "[machine]")
+{
+    for (const auto mode : {arm7tdmi::machine_mode::interleaved, arm7tdmi::machine_mode::parallel}) {
+        auto memory = arm7tdmi::basic_memory(0x1000);
+        auto machine = arm7tdmi::machine(&memory, {.cores = 2, .quantum = 100, .mode = mode});
+        load_programs(memory, machine);
+
+        u32 value = 0;
+
+        // Core 1 cannot see core 0's store during the quantum it was made in
+        machine.run(1);
+        REQUIRE(memory.read<u32>(result_address, &value));
+        REQUIRE(value == 0xffffffff);
+        REQUIRE(memory.read<u32>(shared_address, &value));
+        REQUIRE(value == 0);
+
+        machine.run(1);
+        REQUIRE(memory.read<u32>(result_address, &value));
+        REQUIRE(value == 0);
+
+        REQUIRE(machine.quanta() == 2);
+        REQUIRE(machine.core(0).get_cycles() == 200);
+        REQUIRE(machine.core(1).get_cycles() == 200);
+        REQUIRE_FALSE(machine.halted(0));
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <filesystem>
+#include <fstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/memory_log.h>
+
+TEST_CASE("memory_log_queries", "[memory log]")
+{
+    const auto path = (std::filesystem::temp_directory_path() / "arm7tdmi_test_memory_log.a7ml").string();
+
+    // 0x0000: STMIA R0,{R1,R2}
+    // 0x0004: B 0x0000
+    constexpr int steps = 200'000;
+    auto memory = arm7tdmi::basic_memory(0x100);
+    memory.write<u32>(0x0000, 0xe8800006);
+    memory.write<u32>(0x0004, 0xeafffffd);
+    {
+        std::ofstream out(path, std::ios::binary);
+        arm7tdmi::memory_log_recorder recorder(&memory, out);
+        auto cpu = arm7tdmi::cpu(&recorder);
+        recorder.attach(&cpu);
+        cpu.registers.r0(0x80);
+        cpu.registers.r1(0xaabbccdd);
+
+        for (int i = 0; i < steps; ++i) {
+            REQUIRE(cpu.step());
+        }
+
+        // A byte written by the host, after every instruction
+        cpu.set_cycles(cpu.get_cycles() + 1);
+        recorder.write<u8>(0xc1, 0x42);
+    }
+
+    arm7tdmi::memory_log_reader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.chunks() > 1);
+
+    // A fetch for every instruction, and two word writes for every STMIA
+    REQUIRE(reader.rows() == steps + steps + 1);
+
+    for (const u32 threads : {1u, 4u}) {
+        const auto writes = reader.writes_in_range(0x84, 0x88, threads);
+        REQUIRE(writes.size() == steps / 2);
+        REQUIRE(writes.front().cycle == 0);
+        REQUIRE(writes.front().pc == 0x0000);
+        REQUIRE(writes.front().size == 4);
+        REQUIRE(writes.back().cycle == steps - 2);
+
+        const auto lines = reader.hottest_lines(2, threads);
+        REQUIRE(lines.size() == 2);
+        REQUIRE(lines[0] == std::pair<u32, u64>{0x00, steps});
+        REQUIRE(lines[1] == std::pair<u32, u64>{0x80, steps});
+
+        const auto first = reader.first_writer(0x82, threads);
+        REQUIRE(first);
+        REQUIRE(first->cycle == 0);
+        REQUIRE(first->value == 0xaabbccdd);
+        REQUIRE_FALSE(first->fetch);
+
+        const auto host = reader.first_writer(0xc1, threads);
+        REQUIRE(host);
+        REQUIRE(host->cycle == steps + 1);
+        REQUIRE(host->size == 1);
+
+        REQUIRE_FALSE(reader.first_writer(0x10, threads));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("memory_log_keeps_fetches_apart", "[memory log]")
+{
+    const auto path = (std::filesystem::temp_directory_path() / "arm7tdmi_test_memory_log_fetch.a7ml").string();
+
+    // 0x0002: LDRB R1, [R0, #0], reading the byte just past itself
+    auto memory = arm7tdmi::basic_memory(0x100);
+    memory.write<u16>(0x0002, 0x7801);
+    {
+        std::ofstream out(path, std::ios::binary);
+        arm7tdmi::memory_log_recorder recorder(&memory, out);
+        auto cpu = arm7tdmi::cpu(&recorder);
+        recorder.attach(&cpu);
+        cpu.set_state(arm7tdmi::cpu_state::thumb);
+        cpu.registers.pc(0x0002);
+        cpu.registers.r0(0x0004);
+        REQUIRE(cpu.step());
+    }
+
+    arm7tdmi::memory_log_reader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.rows() == 2);
+
+    std::ifstream in(path, std::ios::binary);
+    arm7tdmi::memory_log_chunk chunk;
+    REQUIRE(reader.read_chunk(in, 0, &chunk));
+    REQUIRE(chunk[0].fetch);
+    REQUIRE(chunk[0].address == 0x0002);
+    REQUIRE(chunk[0].size == 2);
+    REQUIRE_FALSE(chunk[1].fetch);
+    REQUIRE(chunk[1].address == 0x0004);
+    REQUIRE(chunk[1].size == 1);
+
+    in.close();
+    std::filesystem::remove(path);
+}
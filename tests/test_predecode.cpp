@@ -0,0 +1,275 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <random>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+
+#include "elf_builder.h"
+#include "programs.h"
+
+TEST_CASE("predecode_fill_matches_decode", "[predecode]")
+{
+    auto memory = arm7tdmi::basic_memory(0x40000);
+    std::mt19937 rng(43);
+    for (u32 address = 0; address < memory.size(); address += 4) {
+        memory.write<u32>(address, rng());
+    }
+
+    // Runs past the end of memory, those entries must stay empty
+    arm7tdmi::predecode_cache cache(0x1000, 0x40000);
+    cache.fill(memory, 4);
+
+    for (u32 address = 0x1000; address < 0x40000; address += 4) {
+        u32 opcode = 0;
+        REQUIRE(memory.read<u32>(address, &opcode));
+        const auto* entry = cache.find_arm(address);
+        REQUIRE(entry != nullptr);
+        REQUIRE(entry->opcode == opcode);
+        REQUIRE(entry->instr == arm7tdmi::arm::decode(opcode));
+
+        for (const u32 half : {address, address + 2}) {
+            u16 halfword = 0;
+            REQUIRE(memory.read<u16>(half, &halfword));
+            const auto* thumb = cache.find_thumb(half);
+            REQUIRE(thumb != nullptr);
+            REQUIRE(thumb->opcode == halfword);
+            REQUIRE(thumb->instr == arm7tdmi::thumb::decode(halfword));
+        }
+    }
+    REQUIRE(cache.find_arm(0x0ffc) == nullptr);
+    REQUIRE(cache.find_arm(0x40000) == nullptr);
+    REQUIRE(cache.find_thumb(0x40ffe) == nullptr);
+}
+
+TEST_CASE("predecode_cpu_writes_invalidate", "[predecode]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_program(memory, store_over_branch);
+
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    cache.fill(memory);
+    REQUIRE(cache.find_arm(0x0008)->opcode == 0xea000000);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_predecode(&cache);
+    cpu.registers.r0(0x0008);
+    cpu.registers.r1(0xea000002);
+
+    REQUIRE(cpu.step());
+    REQUIRE(cache.find_arm(0x0008) == nullptr);
+    REQUIRE(cache.find_thumb(0x0008) == nullptr);
+    REQUIRE(cache.find_thumb(0x000a) == nullptr);
+    REQUIRE(cache.find_arm(0x0004) != nullptr);
+
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0018);
+    REQUIRE(cpu.get_cycles() == 3);
+
+    // Decoded again on first execution, and kept
+    REQUIRE(cache.find_arm(0x0008)->opcode == 0xea000002);
+}
+
+TEST_CASE("predecode_host_writes_need_invalidate", "[predecode]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_program(memory, store_over_branch);
+
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    cache.fill(memory);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_predecode(&cache);
+    cpu.registers.pc(0x0008);
+
+    memory.write<u32>(0x0008, 0xea000002);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0010);
+
+    cpu.registers.pc(0x0008);
+    cache.invalidate(0x0008, 4);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0018);
+}
+
+namespace {
+    // 0x0000: MOV R0, #5         \ fused
+    // 0x0002: ADD R0, #3         /
+    // 0x0004: CMP R0, #8         \ fused
+    // 0x0006: BEQ 0x000c         /
+    // 0x0008: MOV R1, #1
+    // 0x000a: MOV R1, #1
+    // 0x000c: BL 0x0020          fused
+    // 0x0020: MOV R2, #0xff      \ fused
+    // 0x0022: ADD R2, #1         /
+    // 0x0024: B 0x0024
+    void load_thumb_program(arm7tdmi::basic_memory& memory) {
+        const u16 program[] = {0x2005, 0x3003, 0x2808, 0xd001, 0x2101, 0x2101, 0xf000, 0xf808};
+        for (u32 i = 0; i < std::size(program); ++i) {
+            memory.write<u16>(i * 2, program[i]);
+        }
+        memory.write<u16>(0x0020, 0x22ff);
+        memory.write<u16>(0x0022, 0x3201);
+        memory.write<u16>(0x0024, 0xe7fe);
+    }
+
+    arm7tdmi::cpu run_thumb_program(arm7tdmi::basic_memory& memory, arm7tdmi::predecode_cache& cache) {
+        auto cpu = arm7tdmi::cpu(&memory);
+        cpu.set_predecode(&cache);
+        cpu.set_state(arm7tdmi::cpu_state::thumb);
+        for (u32 i = 0; i < 16 && cpu.registers.pc() != 0x0024; ++i) {
+            REQUIRE(cpu.step());
+        }
+        return cpu;
+    }
+}
+
+TEST_CASE("predecode_fusion_matches_unfused", "[predecode]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_thumb_program(memory);
+
+    arm7tdmi::predecode_cache unfused(0x0000, 0x100);
+    unfused.fill(memory);
+    arm7tdmi::predecode_cache fused(0x0000, 0x100);
+    fused.set_fusion(true);
+    fused.fill(memory);
+
+    REQUIRE(unfused.find_thumb(0x0000)->fusion == arm7tdmi::fused_pair::none);
+    REQUIRE(fused.find_thumb(0x0000)->fusion == arm7tdmi::fused_pair::move_add);
+    REQUIRE(fused.find_thumb(0x0004)->fusion == arm7tdmi::fused_pair::compare_branch);
+    REQUIRE(fused.find_thumb(0x000c)->fusion == arm7tdmi::fused_pair::branch_with_link);
+
+    const auto expected = run_thumb_program(memory, unfused);
+    const auto actual = run_thumb_program(memory, fused);
+
+    REQUIRE(expected.registers.pc() == 0x0024);
+    REQUIRE(expected.registers.r0() == 8);
+    REQUIRE(expected.registers.r1() == 0);
+    REQUIRE(expected.registers.r2() == 0x100);
+    REQUIRE(expected.registers.lr() == 0x0011);
+    REQUIRE(expected.get_cycles() == 8);
+
+    for (u32 i = 0; i < 16; ++i) {
+        REQUIRE(actual.registers.get(i) == expected.registers.get(i));
+    }
+    REQUIRE(actual.registers.cpsr_get_n() == expected.registers.cpsr_get_n());
+    REQUIRE(actual.registers.cpsr_get_z() == expected.registers.cpsr_get_z());
+    REQUIRE(actual.registers.cpsr_get_c() == expected.registers.cpsr_get_c());
+    REQUIRE(actual.registers.cpsr_get_v() == expected.registers.cpsr_get_v());
+    REQUIRE(actual.get_cycles() == expected.get_cycles());
+}
+
+TEST_CASE("predecode_fusion_second_half_alone", "[predecode]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_thumb_program(memory);
+
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    cache.set_fusion(true);
+    cache.fill(memory);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_predecode(&cache);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+
+    // Branch target between MOV and ADD
+    cpu.registers.pc(0x0002);
+    cpu.registers.r0(10);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.r0() == 13);
+    REQUIRE(cpu.registers.pc() == 0x0004);
+    REQUIRE(cpu.get_cycles() == 1);
+
+    // BL suffix on its own branches relative to whatever is in lr
+    cpu.registers.pc(0x000e);
+    cpu.registers.lr(0x0040);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0050);
+    REQUIRE(cpu.registers.lr() == 0x0011);
+}
+
+TEST_CASE("predecode_fusion_invalidated_by_second_half", "[predecode]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_thumb_program(memory);
+
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    cache.set_fusion(true);
+    cache.fill(memory);
+
+    // SUB R0, #3 replaces the ADD
+    memory.write<u16>(0x0002, 0x3803);
+    cache.invalidate(0x0002, 2);
+    REQUIRE(cache.find_thumb(0x0000)->fusion == arm7tdmi::fused_pair::none);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_predecode(&cache);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0002);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.r0() == 2);
+    REQUIRE(cpu.registers.pc() == 0x0004);
+
+    // Not a pair any more once the new instruction is stored
+    REQUIRE(cache.find_thumb(0x0000)->fusion == arm7tdmi::fused_pair::none);
+    REQUIRE(cache.find_thumb(0x0002)->opcode == 0x3803);
+}
+
+TEST_CASE("predecode_fusion_irq_between_halves", "[predecode]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_thumb_program(memory);
+    // IRQ vector: B 0x18
+    memory.write<u32>(0x0018, 0xeafffffe);
+
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    cache.set_fusion(true);
+    cache.fill(memory);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_predecode(&cache);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    cpu.registers.cpsr_set_i(false);
+
+    // Due after MOV R0, #5, so ADD R0, #3 never runs
+    cpu.schedule_irq(1);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.get_irq_line());
+    REQUIRE(cpu.registers.r0() == 5);
+    REQUIRE(cpu.registers.pc() == 0x0002);
+    REQUIRE(cpu.get_cycles() == 1);
+
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.cpsr_get_mode() == arm7tdmi::cpu_mode::irq);
+    REQUIRE(cpu.get_state() == arm7tdmi::cpu_state::arm);
+    REQUIRE(cpu.registers.pc() == 0x0018);
+    REQUIRE(cpu.registers.lr() == 0x0006);
+    REQUIRE(cpu.registers.r0() == 5);
+    REQUIRE(cpu.get_cycles() == 2);
+}
+
+TEST_CASE("predecode_elf_segments_far_apart", "[predecode]")
+{
+    // Executable with a 0x100 byte segment at 0x0000 and a 0x400 byte one at 0x08000000, both
+    // readable and executable
+    const auto data = make_elf({{0, nullptr, 0, 0x100, 5}, {0x08000000, nullptr, 0, 0x400, 5}});
+
+    arm7tdmi::elf_image image;
+    REQUIRE(image.load(data));
+    const arm7tdmi::predecode_cache cache(image);
+    REQUIRE(cache.base() == 0x08000000);
+    REQUIRE(cache.size() == 0x400);
+
+    const arm7tdmi::predecode_cache too_large(0x0000, arm7tdmi::predecode_cache::max_size + 4);
+    REQUIRE(too_large.size() == 0);
+    REQUIRE(too_large.find_arm(0x0000) == nullptr);
+}
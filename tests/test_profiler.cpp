@@ -0,0 +1,128 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+#include <arm7tdmi/profiler.h>
+
+#include "elf_builder.h"
+
+namespace {
+    // main:
+    // 0x0000: BL f
+    // 0x0004: BL f
+    // 0x0008: B main
+    // f:
+    // 0x0010: B 0x0014
+    // 0x0014: B 0x0018
+    // 0x0018: BX LR
+    constexpr u32 program[] = {0xeb000002, 0xeb000001, 0xeafffffc, 0, 0xeaffffff, 0xeaffffff, 0xe12fff1e};
+
+    // Executable with the program at address 0, and symbols for main and f
+    std::vector<u8> profiled_elf() {
+        // The mapping symbol is skipped
+        return make_elf({{0, program, sizeof(program), sizeof(program) + 4}},
+                        {{"main", 0x00, 0x10}, {"f", 0x10, 0x0c}, {"$a", 0x10, 0, 0}});
+    }
+}
+
+TEST_CASE("elf_image_symbols_and_segments", "[profiler]")
+{
+    arm7tdmi::elf_image image;
+    REQUIRE(image.load(profiled_elf()));
+    REQUIRE(image.entry() == 0);
+    REQUIRE(image.symbols().size() == 2);
+    REQUIRE(image.find(0x04)->name == "main");
+    REQUIRE(image.find(0x18)->name == "f");
+    REQUIRE(image.find(0x1c) == nullptr);
+
+    auto memory = arm7tdmi::basic_memory(0x100);
+    memory.write<u32>(0x1c, 0xffffffff);
+    REQUIRE(image.load_segments(memory));
+    u32 word = 0;
+    memory.read<u32>(0x18, &word);
+    REQUIRE(word == 0xe12fff1e);
+    memory.read<u32>(0x1c, &word);
+    REQUIRE(word == 0);
+
+    auto small = arm7tdmi::basic_memory(0x10);
+    REQUIRE_FALSE(image.load_segments(small));
+
+    auto truncated = profiled_elf();
+    truncated.resize(40);
+    REQUIRE_FALSE(image.load(truncated));
+}
+
+TEST_CASE("profiler_folded_call_stacks", "[profiler]")
+{
+    arm7tdmi::elf_image image;
+    REQUIRE(image.load(profiled_elf()));
+
+    auto memory = arm7tdmi::basic_memory(0x100);
+    REQUIRE(image.load_segments(memory));
+    auto cpu = arm7tdmi::cpu(&memory);
+
+    arm7tdmi::profiler profiler(1);
+    // Every loop of main is 3 instructions in main and 6 in f
+    for (int i = 0; i < 900; ++i) {
+        REQUIRE(profiler.step(cpu));
+    }
+    REQUIRE(profiler.samples() == 900);
+    REQUIRE(profiler.call_stack() == std::vector<u32>{0x00});
+
+    std::ostringstream symbolized;
+    profiler.write_folded(symbolized, &image);
+    REQUIRE(symbolized.str() == "main 300\nmain;f 600\n");
+
+    std::ostringstream raw;
+    profiler.write_folded(raw);
+    REQUIRE(raw.str() == "0x00000000 300\n0x00000000;0x00000010 600\n");
+}
+
+TEST_CASE("profiler_fused_calls", "[profiler]")
+{
+    // main:
+    // 0x0000: BL f             fused into one step
+    // 0x0004: B main
+    // f:
+    // 0x0010: MOV R0, #1
+    // 0x0012: B 0x0004         returns without BX
+    auto memory = arm7tdmi::basic_memory(0x100);
+    const u16 main[] = {0xf000, 0xf806, 0xe7fc};
+    const u16 f[] = {0x2001, 0xe7f7};
+    for (u32 i = 0; i < std::size(main); ++i) {
+        memory.write<u16>(i * 2, main[i]);
+    }
+    for (u32 i = 0; i < std::size(f); ++i) {
+        memory.write<u16>(0x10 + i * 2, f[i]);
+    }
+
+    arm7tdmi::predecode_cache cache(0x0000, 0x100);
+    cache.set_fusion(true);
+    cache.fill(memory);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    cpu.set_predecode(&cache);
+
+    arm7tdmi::profiler profiler(1);
+    REQUIRE(profiler.step(cpu));
+    REQUIRE(cpu.get_cycles() == 2);
+    REQUIRE(profiler.call_stack() == std::vector<u32>{0x00, 0x10});
+
+    // Every loop of main is 2 steps in main and 2 in f
+    for (int i = 1; i < 400; ++i) {
+        REQUIRE(profiler.step(cpu));
+    }
+    REQUIRE(profiler.call_stack() == std::vector<u32>{0x00});
+
+    std::ostringstream raw;
+    profiler.write_folded(raw);
+    REQUIRE(raw.str() == "0x00000000 200\n0x00000000;0x00000010 200\n");
+}
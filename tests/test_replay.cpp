@@ -0,0 +1,146 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/replay.h>
+
+#include "programs.h"
+
+namespace {
+    constexpr u32 device_address = 0x4000;
+
+    // RAM with a free running counter mapped at device_address, standing in for a host-backed device
+    class board final : public arm7tdmi::memory_interface {
+    public:
+        arm7tdmi::basic_memory ram{0x5000};
+        mutable u8 counter = 0;
+
+        [[nodiscard]] u64 size() const noexcept override { return ram.size(); }
+
+    protected:
+        [[nodiscard]] bool read_byte(const u32 address, u8* out) const noexcept override {
+            if (address >= device_address && address < device_address + 4) {
+                *out = counter += 7;
+                return true;
+            }
+            return ram.read<u8>(address, out);
+        }
+
+        bool write_byte(const size_t address, const u8 value) noexcept override {
+            return ram.write<u8>(static_cast<u32>(address), value);
+        }
+    };
+}
+
+TEST_CASE("replay_reproduces_recorded_run", "[replay]")
+{
+    std::stringstream log;
+
+    board recorded_board;
+    load_program(recorded_board, copy_word_loop);
+    arm7tdmi::cpu_registers recorded_registers;
+    {
+        auto recorder = arm7tdmi::input_recorder(&recorded_board, log);
+        recorder.add_mmio_range(device_address, device_address + 4);
+        auto cpu = arm7tdmi::cpu(&recorder);
+        recorder.attach(&cpu);
+        cpu.registers.r0(device_address);
+        cpu.registers.r1(0x2000);
+
+        while (cpu.get_cycles() < 300) {
+            if (cpu.get_cycles() == 100) recorder.set_irq_line(cpu, true);
+            if (cpu.get_cycles() == 101) recorder.set_irq_line(cpu, false);
+            REQUIRE(cpu.step());
+        }
+        recorded_registers = cpu.registers;
+        REQUIRE(cpu.registers.cpsr_get_mode() == arm7tdmi::cpu_mode::irq);
+    }
+
+    // Replay against plain memory, the device is no longer there
+    auto memory = arm7tdmi::basic_memory(0x5000);
+    load_program(memory, copy_word_loop);
+    auto replayer = arm7tdmi::input_replayer(&memory, log);
+    REQUIRE(replayer.valid());
+    replayer.add_mmio_range(device_address, device_address + 4);
+
+    auto cpu = arm7tdmi::cpu(&replayer);
+    cpu.registers.r0(device_address);
+    cpu.registers.r1(0x2000);
+    while (cpu.get_cycles() < 300) {
+        replayer.sync(cpu);
+        REQUIRE(cpu.step());
+    }
+
+    REQUIRE_FALSE(replayer.diverged());
+    REQUIRE(replayer.finished());
+    for (size_t i = 0; i < std::size(recorded_registers.data); ++i) {
+        REQUIRE(cpu.registers.data[i] == recorded_registers.data[i]);
+    }
+
+    u32 recorded_value = 0, replayed_value = 0;
+    REQUIRE(recorded_board.ram.read<u32>(0x2000, &recorded_value));
+    REQUIRE(memory.read<u32>(0x2000, &replayed_value));
+    REQUIRE(recorded_value != 0);
+    REQUIRE(replayed_value == recorded_value);
+}
+
+TEST_CASE("replay_detects_divergence", "[replay]")
+{
+    std::stringstream log;
+    {
+        arm7tdmi::input_log_writer writer(log);
+        writer.write({arm7tdmi::input_event::mmio_read, 0, device_address + 1, 0x12});
+    }
+
+    auto memory = arm7tdmi::basic_memory(0x5000);
+    load_program(memory, copy_word_loop);
+    auto replayer = arm7tdmi::input_replayer(&memory, log);
+    replayer.add_mmio_range(device_address, device_address + 4);
+
+    auto cpu = arm7tdmi::cpu(&replayer);
+    cpu.registers.r0(device_address);
+    replayer.sync(cpu);
+    cpu.step();
+    REQUIRE(replayer.diverged());
+}
+
+TEST_CASE("replay_logs_data_reads_only", "[replay]")
+{
+    std::stringstream log;
+
+    // The code itself is registered as device memory, its fetches still aren't inputs
+    board recorded_board;
+    load_program(recorded_board, copy_word_loop);
+    {
+        auto recorder = arm7tdmi::input_recorder(&recorded_board, log);
+        recorder.add_mmio_range(device_address + 2, device_address + 4);
+        recorder.add_mmio_range(0x0000, 0x0010);
+        recorder.add_mmio_range(device_address, device_address + 3);
+        auto cpu = arm7tdmi::cpu(&recorder);
+        recorder.attach(&cpu);
+        cpu.registers.r0(device_address);
+        cpu.registers.r1(0x2000);
+        while (cpu.get_cycles() < 30) {
+            REQUIRE(cpu.step());
+        }
+    }
+
+    arm7tdmi::input_log_reader reader(log);
+    REQUIRE(reader.valid());
+    arm7tdmi::input_record record;
+    u32 records = 0;
+    while (reader.next(&record)) {
+        REQUIRE(record.event == arm7tdmi::input_event::mmio_read);
+        REQUIRE(record.address >= device_address);
+        REQUIRE(record.address < device_address + 4);
+        ++records;
+    }
+    // One word read from the device every 3 instructions
+    REQUIRE(records == 10 * 4);
+}
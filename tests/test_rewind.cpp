@@ -0,0 +1,145 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/rewind.h>
+
+#include "programs.h"
+
+namespace {
+    // Runs the program, with the host scribbling over a second page as it goes
+    void run(arm7tdmi::cpu& cpu, arm7tdmi::basic_memory& memory, arm7tdmi::rewind_buffer& rewind, const u64 until) {
+        while (cpu.get_cycles() < until) {
+            rewind.tick(cpu);
+            memory.write<u32>(0x1000 + (cpu.get_cycles() % 256) * sizeof(u32), static_cast<u32>(cpu.get_cycles()));
+            REQUIRE(cpu.step());
+        }
+    }
+}
+
+TEST_CASE("rewind_restores_snapshot", "[rewind]")
+{
+    auto memory = arm7tdmi::basic_memory(0x3000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    load_program(memory, store_pc_loop);
+    cpu.registers.r0(0x2000);
+    cpu.registers.r1(0x2004);
+
+    auto rewind = arm7tdmi::rewind_buffer(&memory, {.interval = 64, .max_overhead = 1.0});
+
+    run(cpu, memory, rewind, 256);
+    rewind.tick(cpu);
+    std::vector<u8> expected(memory.data(), memory.data() + memory.size());
+    const u32 expected_pc = cpu.registers.pc();
+
+    run(cpu, memory, rewind, 1000);
+    REQUIRE(rewind.size() == 16);
+
+    REQUIRE(rewind.restore(cpu, 256));
+    REQUIRE(cpu.get_cycles() == 256);
+    REQUIRE(cpu.registers.pc() == expected_pc);
+    REQUIRE(std::memcmp(memory.data(), expected.data(), expected.size()) == 0);
+
+    // Newer snapshots are discarded
+    REQUIRE(rewind.size() == 5);
+}
+
+TEST_CASE("rewind_replays_forward", "[rewind]")
+{
+    auto memory = arm7tdmi::basic_memory(0x3000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    load_program(memory, store_pc_loop);
+    cpu.registers.r0(0x2000);
+    cpu.registers.r1(0x2004);
+
+    auto rewind = arm7tdmi::rewind_buffer(&memory, {.interval = 64, .max_overhead = 1.0});
+
+    while (cpu.get_cycles() < 500) {
+        rewind.tick(cpu);
+        cpu.step();
+    }
+    const u32 expected_pc = cpu.registers.pc();
+
+    while (cpu.get_cycles() < 700) {
+        rewind.tick(cpu);
+        cpu.step();
+    }
+
+    REQUIRE(rewind.step_back(cpu, 200));
+    REQUIRE(cpu.get_cycles() == 500);
+    REQUIRE(cpu.registers.pc() == expected_pc);
+
+    // Cannot go further back than the oldest snapshot
+    REQUIRE(rewind.oldest_cycle() == 0);
+    REQUIRE(rewind.restore(cpu, 0));
+    REQUIRE(cpu.registers.pc() == 0);
+}
+
+TEST_CASE("rewind_respects_budget", "[rewind]")
+{
+    auto memory = arm7tdmi::basic_memory(0x3000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    load_program(memory, store_pc_loop);
+    cpu.registers.r0(0x2000);
+    cpu.registers.r1(0x2004);
+
+    constexpr u64 budget = 4096;
+    auto rewind = arm7tdmi::rewind_buffer(&memory, {.interval = 16, .budget = budget});
+
+    run(cpu, memory, rewind, 5000);
+    REQUIRE(rewind.memory_usage() <= budget);
+    REQUIRE(rewind.oldest_cycle() > 0);
+    REQUIRE_FALSE(rewind.restore(cpu, 0));
+    REQUIRE(rewind.restore(cpu, rewind.oldest_cycle()));
+}
+
+TEST_CASE("rewind_restores_irq_line", "[rewind]")
+{
+    auto memory = arm7tdmi::basic_memory(0x3000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    load_program(memory, store_pc_loop);
+    // 0x0018: B 0x0018, the IRQ handler
+    memory.write<u32>(0x0018, 0xeafffffe);
+    cpu.registers.r0(0x2000);
+    cpu.registers.r1(0x2004);
+    cpu.registers.cpsr_set_i(false);
+
+    auto rewind = arm7tdmi::rewind_buffer(&memory, {.interval = 64, .max_overhead = 1.0});
+
+    run(cpu, memory, rewind, 256);
+    cpu.set_irq_line(true);
+    run(cpu, memory, rewind, 400);
+    REQUIRE(cpu.registers.pc() == 0x0018);
+    cpu.set_irq_line(false);
+
+    // The IRQ was pending when the snapshot at 256 was taken, so replaying from it takes the IRQ again
+    REQUIRE(rewind.restore(cpu, 300));
+    REQUIRE(cpu.get_irq_line());
+    REQUIRE(cpu.registers.pc() == 0x0018);
+    REQUIRE(cpu.registers.cpsr_get_mode() == arm7tdmi::cpu_mode::irq);
+
+    // And was not before it
+    REQUIRE(rewind.restore(cpu, 200));
+    REQUIRE_FALSE(cpu.get_irq_line());
+    REQUIRE(cpu.registers.pc() < 0x0018);
+
+    // An IRQ scheduled for later is kept, and taken again when the replay reaches it
+    cpu.schedule_irq(500);
+    run(cpu, memory, rewind, 600);
+    REQUIRE(cpu.registers.pc() == 0x0018);
+    cpu.set_irq_line(false);
+
+    REQUIRE(rewind.restore(cpu, 450));
+    REQUIRE(cpu.get_irq_cycle() == 500);
+    REQUIRE(cpu.registers.pc() < 0x0018);
+    REQUIRE(rewind.restore(cpu, 520));
+    REQUIRE(cpu.get_irq_cycle() == ~0ull);
+    REQUIRE(cpu.registers.pc() == 0x0018);
+}
@@ -0,0 +1,58 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+
+#ifdef ARM7TDMI_STATISTICS
+
+TEST_CASE("statistics_count_instruction_classes", "[statistics]")
+{
+    auto memory = arm7tdmi::basic_memory(0x100);
+    auto cpu = arm7tdmi::cpu(&memory);
+
+    // 0x0000: STMIA R0,{R0,R1}
+    // 0x0004: BNE 0x0010 (Z set, not taken)
+    // 0x0008: BX R2 (into thumb at 0x0010)
+    memory.write<u32>(0x0000, 0xe8800003);
+    memory.write<u32>(0x0004, 0x1a000001);
+    memory.write<u32>(0x0008, 0xe12fff12);
+    cpu.registers.r0(0x80);
+    cpu.registers.r2(0x11);
+    cpu.registers.cpsr_set_z(true);
+
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.step());
+
+    const auto& statistics = cpu.statistics();
+    REQUIRE(statistics.arm_count(arm7tdmi::arm::instruction::block_data_transfer) == 1);
+    REQUIRE(statistics.arm_count(arm7tdmi::arm::instruction::branch) == 1);
+    REQUIRE(statistics.arm_count(arm7tdmi::arm::instruction::branch_and_exchange) == 1);
+    REQUIRE(statistics.condition_failed == 1);
+    REQUIRE(statistics.state_switches == 1);
+    REQUIRE(statistics.writes[arm7tdmi::cpu_statistics::access_width<u32>()] == 2);
+    REQUIRE(statistics.reads[arm7tdmi::cpu_statistics::access_width<u32>()] == 0);
+    REQUIRE(cpu.get_state() == arm7tdmi::cpu_state::thumb);
+
+    // 0x0010: ADD R0, R1, R2
+    memory.write<u16>(0x0010, 0x1888);
+    REQUIRE(cpu.step());
+    REQUIRE(statistics.thumb_count(arm7tdmi::thumb::instruction::add_subtract) == 1);
+
+    // 0x0012: BNE 0x0012 (Z still set, not taken)
+    memory.write<u16>(0x0012, 0xd1fe);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x0014);
+    REQUIRE(statistics.condition_failed == 2);
+
+    cpu.reset_statistics();
+    REQUIRE(statistics.arm_count(arm7tdmi::arm::instruction::branch) == 0);
+    REQUIRE(statistics.state_switches == 0);
+    REQUIRE(statistics.condition_failed == 0);
+}
+
+#endif
@@ -0,0 +1,199 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/bios.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/semihosting.h>
+
+namespace {
+    constexpr u32 code = 0x0100;
+    constexpr u32 block = 0x0800;
+    constexpr u32 strings = 0x0900;
+
+    void write_string(arm7tdmi::basic_memory& memory, u32 address, const std::string& text) {
+        for (const char c : text) {
+            memory.write<u8>(address++, static_cast<u8>(c));
+        }
+        memory.write<u8>(address, 0);
+    }
+
+    // Runs one semihosting call from ARM state, with the parameter block at block
+    u32 semihost(arm7tdmi::cpu& cpu, arm7tdmi::basic_memory& memory, const u32 operation, std::initializer_list<u32> parameters) {
+        u32 address = block;
+        for (const u32 parameter : parameters) {
+            memory.write<u32>(address, parameter);
+            address += 4;
+        }
+        memory.write<u32>(code, 0xef123456);
+        cpu.set_state(arm7tdmi::cpu_state::arm);
+        cpu.registers.pc(code);
+        cpu.registers.r0(operation);
+        cpu.registers.r1(block);
+        REQUIRE(cpu.step());
+        REQUIRE(cpu.registers.pc() == code + 4);
+        return cpu.registers.r0();
+    }
+}
+
+TEST_CASE("swi_enters_supervisor", "[swi]")
+{
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    memory.write<u32>(code, 0xef000010);
+    memory.write<u16>(code + 4, 0xdf10);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.registers.cpsr_set_mode(arm7tdmi::cpu_mode::user);
+    const u32 cpsr = cpu.registers.cpsr();
+    cpu.registers.pc(code);
+
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x08);
+    REQUIRE(cpu.registers.cpsr_get_mode() == arm7tdmi::cpu_mode::supervisor);
+    REQUIRE(cpu.registers.cpsr_get_i());
+    REQUIRE(cpu.registers.lr() == code + 4);
+    REQUIRE(cpu.registers.spsr() == cpsr);
+
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    cpu.registers.pc(code + 4);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x08);
+    REQUIRE(cpu.get_state() == arm7tdmi::cpu_state::arm);
+    REQUIRE(cpu.registers.lr() == code + 6);
+}
+
+TEST_CASE("swi_semihosting", "[swi]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "arm7tdmi_semihosting";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    std::ostringstream out;
+    std::istringstream in("typed\n");
+    arm7tdmi::semihosting host(root, out, in);
+
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_semihosting(&host);
+
+    SECTION("console") {
+        // SYS_WRITE0 and SYS_WRITEC take the string or character itself in r1
+        write_string(memory, block, "hello ");
+        semihost(cpu, memory, 0x04, {});
+        memory.write<u8>(block, 'x');
+        semihost(cpu, memory, 0x03, {});
+        REQUIRE(out.str() == "hello x");
+
+        write_string(memory, strings, ":tt");
+        const u32 input = semihost(cpu, memory, 0x01, {strings, 0, 3});
+        REQUIRE(semihost(cpu, memory, 0x09, {input}) == 1);
+        REQUIRE(semihost(cpu, memory, 0x06, {input, 0x0a00, 16}) == 16 - 6);
+        REQUIRE(memory.data()[0x0a00] == 't');
+        REQUIRE(memory.data()[0x0a05] == '\n');
+    }
+
+    SECTION("files") {
+        write_string(memory, strings, "out.txt");
+        write_string(memory, 0x0a00, "file data");
+        const u32 handle = semihost(cpu, memory, 0x01, {strings, 4, 7});
+        REQUIRE(handle != 0xffffffff);
+        REQUIRE(semihost(cpu, memory, 0x09, {handle}) == 0);
+        REQUIRE(semihost(cpu, memory, 0x05, {handle, 0x0a00, 9}) == 0);
+        REQUIRE(semihost(cpu, memory, 0x02, {handle}) == 0);
+        REQUIRE(std::filesystem::file_size(root / "out.txt") == 9);
+
+        const u32 reopened = semihost(cpu, memory, 0x01, {strings, 1, 7});
+        REQUIRE(semihost(cpu, memory, 0x0c, {reopened}) == 9);
+        REQUIRE(semihost(cpu, memory, 0x0a, {reopened, 5}) == 0);
+        REQUIRE(semihost(cpu, memory, 0x06, {reopened, 0x0b00, 8}) == 4);
+        REQUIRE(std::string(reinterpret_cast<const char*>(memory.data() + 0x0b00), 4) == "data");
+        REQUIRE(semihost(cpu, memory, 0x02, {reopened}) == 0);
+        REQUIRE(semihost(cpu, memory, 0x02, {reopened}) == 0xffffffff);
+
+        // Paths cannot leave the root
+        write_string(memory, strings, "../escape.txt");
+        REQUIRE(semihost(cpu, memory, 0x01, {strings, 4, 13}) == 0xffffffff);
+    }
+
+    SECTION("exit") {
+        REQUIRE_FALSE(host.exited());
+        memory.write<u16>(code, 0xdfab);
+        cpu.set_state(arm7tdmi::cpu_state::thumb);
+        cpu.registers.pc(code);
+        cpu.registers.r0(0x18);
+        cpu.registers.r1(0x20026);
+        REQUIRE(cpu.step());
+        REQUIRE(cpu.registers.pc() == code + 2);
+        REQUIRE(host.exited());
+        REQUIRE(host.exit_code() == 0);
+    }
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("swi_bios_calls", "[swi]")
+{
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    arm7tdmi::bios_calls bios;
+    bios.add_standard();
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_bios(&bios);
+
+    // THUMB SWI 0x06, Div
+    memory.write<u16>(code, 0xdf06);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    cpu.registers.pc(code);
+    cpu.registers.r0(static_cast<u32>(-100));
+    cpu.registers.r1(7);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == code + 2);
+    REQUIRE(cpu.registers.r0() == static_cast<u32>(-14));
+    REQUIRE(cpu.registers.r1() == static_cast<u32>(-2));
+    REQUIRE(cpu.registers.r3() == 14);
+
+    // Division by zero is left to the guest
+    cpu.registers.pc(code);
+    cpu.registers.r1(0);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.pc() == 0x08);
+
+    // ARM SWI 0x080000, Sqrt
+    memory.write<u32>(code, 0xef080000);
+    cpu.set_state(arm7tdmi::cpu_state::arm);
+    cpu.registers.pc(code);
+    cpu.registers.r0(1000000);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.r0() == 1000);
+
+    // ARM SWI 0x0b0000, CpuSet word fill
+    memory.write<u32>(code, 0xef0b0000);
+    memory.write<u32>(0x0800, 0xdeadbeef);
+    cpu.registers.pc(code);
+    cpu.registers.r0(0x0800);
+    cpu.registers.r1(0x0900);
+    cpu.registers.r2((1u << 26) | (1u << 24) | 5);
+    REQUIRE(cpu.step());
+    for (u32 i = 0; i < 6; ++i) {
+        u32 value = 0;
+        REQUIRE(memory.read<u32>(0x0900 + i * 4, &value));
+        REQUIRE(value == (i < 5 ? 0xdeadbeef : 0));
+    }
+
+    // Functions can be replaced
+    bios.add(arm7tdmi::bios_calls::sqrt, [](arm7tdmi::cpu_registers& registers, arm7tdmi::memory_interface&) {
+        registers.r0(42);
+        return true;
+    });
+    memory.write<u32>(code, 0xef080000);
+    cpu.registers.pc(code);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.r0() == 42);
+}
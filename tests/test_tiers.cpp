@@ -0,0 +1,171 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/tiers.h>
+
+#include "programs.h"
+
+namespace {
+    // The loop at 0x0004 as write_aot_source() would compile it
+    u32 compiled_loop(arm7tdmi::aot_context& c) noexcept {
+        c.r[1] = arm7tdmi::aot_add(c, c.r[1], 3u);
+        c.r[0] = arm7tdmi::aot_subtract(c, c.r[0], 1u);
+        if (arm7tdmi::util::condition_passed(c.cpsr, 1u)) {
+            c.r[15] = 0x00000004u;
+            c.branched = true;
+            c.branch_end = 0x0000000au;
+            return 3;
+        }
+        c.r[15] = 0x0000000au;
+        return 3;
+    }
+
+    class loop_backend final : public arm7tdmi::tier_backend {
+    public:
+        arm7tdmi::aot_function compile(const arm7tdmi::memory_interface&, const u32 address, const bool thumb, const u32 size) noexcept override {
+            ++calls;
+            last_size = size;
+            return address == 0x0004 && thumb ? compiled_loop : nullptr;
+        }
+
+        u32 calls = 0;
+        u32 last_size = 0;
+    };
+
+    struct result {
+        u32 r0, r1, cpsr;
+        u64 cycles;
+        u32 stored;
+    };
+
+    result run(arm7tdmi::tiered_execution* tiers) {
+        auto memory = arm7tdmi::basic_memory(0x1000);
+        load_program(memory, thumb_count_loop);
+        auto cpu = arm7tdmi::cpu(&memory);
+        cpu.set_state(arm7tdmi::cpu_state::thumb);
+        cpu.set_tiers(tiers);
+        cpu.registers.r2(0x0800);
+        while (cpu.registers.pc() != 0x000c) {
+            REQUIRE(cpu.step());
+        }
+        u32 stored = 0;
+        REQUIRE(memory.read<u32>(0x0800, &stored));
+        return {cpu.registers.r0(), cpu.registers.r1(), cpu.registers.cpsr(), cpu.get_cycles(), stored};
+    }
+}
+
+TEST_CASE("tiers_match_interpreter", "[tiers]")
+{
+    const auto expected = run(nullptr);
+    REQUIRE(expected.r1 == 300);
+    REQUIRE(expected.stored == 300);
+
+    arm7tdmi::tier_config config;
+    config.predecode_threshold = 2;
+    config.optimize_threshold = 10;
+    arm7tdmi::tiered_execution tiers(config);
+    loop_backend backend;
+    tiers.set_backend(&backend);
+
+    const auto tiered = run(&tiers);
+    REQUIRE(tiered.r0 == expected.r0);
+    REQUIRE(tiered.r1 == expected.r1);
+    REQUIRE(tiered.cpsr == expected.cpsr);
+    REQUIRE(tiered.cycles == expected.cycles);
+    REQUIRE(tiered.stored == expected.stored);
+
+    // The loop's branch enters it 99 times: once interpreted, 8 times predecoded, then compiled on the 10th
+    REQUIRE(backend.calls == 1);
+    REQUIRE(backend.last_size == 6);
+    REQUIRE(tiers.tier(0x0004, true) == arm7tdmi::execution_tier::optimized);
+    REQUIRE(tiers.tier(0x0000, true) == arm7tdmi::execution_tier::interpreted);
+
+    const auto& statistics = tiers.statistics();
+    REQUIRE(statistics.predecoded == 1);
+    REQUIRE(statistics.optimized == 1);
+    REQUIRE(statistics.entry_count(arm7tdmi::execution_tier::predecoded) == 8);
+    REQUIRE(statistics.entry_count(arm7tdmi::execution_tier::optimized) == 90);
+    REQUIRE(statistics.instruction_count(arm7tdmi::execution_tier::interpreted) +
+            statistics.instruction_count(arm7tdmi::execution_tier::predecoded) +
+            statistics.instruction_count(arm7tdmi::execution_tier::optimized) == expected.cycles);
+    REQUIRE(statistics.instruction_count(arm7tdmi::execution_tier::optimized) == 270);
+}
+
+TEST_CASE("tiers_invalidate_written_code", "[tiers]")
+{
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    load_program(memory, thumb_count_loop);
+
+    arm7tdmi::tier_config config;
+    config.predecode_threshold = 1;
+    config.timing = false;
+    arm7tdmi::tiered_execution tiers(config);
+
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_state(arm7tdmi::cpu_state::thumb);
+    cpu.set_tiers(&tiers);
+    for (u32 i = 0; i < 8; ++i) {
+        REQUIRE(cpu.step());
+    }
+    REQUIRE(tiers.tier(0x0004, true) == arm7tdmi::execution_tier::predecoded);
+    REQUIRE(tiers.statistics().time(arm7tdmi::execution_tier::predecoded) == 0);
+
+    // STR R1, [R2, #0] turns the loop's ADD R1, #3 into SUB R0, #0, dropping both blocks which hold it
+    cpu.registers.r2(0x0004);
+    cpu.registers.pc(0x000a);
+    cpu.registers.r1(0x3800);
+    REQUIRE(cpu.step());
+    REQUIRE(tiers.tier(0x0004, true) == arm7tdmi::execution_tier::interpreted);
+    REQUIRE(tiers.statistics().invalidations == 2);
+
+    cpu.registers.pc(0x0004);
+    cpu.registers.r1(7);
+    REQUIRE(cpu.step());
+    REQUIRE(cpu.registers.r1() == 7);
+    REQUIRE(tiers.tier(0x0004, true) == arm7tdmi::execution_tier::predecoded);
+}
+
+TEST_CASE("tiers_cache_evicts_when_full", "[tiers]")
+{
+    auto memory = arm7tdmi::basic_memory(0x1000);
+    load_program(memory, thumb_count_loop);
+
+    arm7tdmi::tier_config config;
+    config.predecode_threshold = 1;
+    config.cache_instructions = 4;
+    arm7tdmi::tiered_execution tiers(config);
+
+    REQUIRE(tiers.enter(0x0000, true, memory).tier() == arm7tdmi::execution_tier::interpreted);
+    REQUIRE(tiers.enter(0x0004, true, memory).thumb.size() == 3);
+    REQUIRE(tiers.enter(0x000a, true, memory).thumb.size() == 2);
+    REQUIRE(tiers.tier(0x0004, true) == arm7tdmi::execution_tier::interpreted);
+    REQUIRE(tiers.statistics().evictions == 1);
+
+    tiers.clear();
+    REQUIRE(tiers.tier(0x000a, true) == arm7tdmi::execution_tier::interpreted);
+}
+
+TEST_CASE("tiers_invalidate_spanning_write", "[tiers]")
+{
+    auto memory = arm7tdmi::basic_memory(0x4000);
+    memory.write<u16>(0x2000, 0x2001);
+    memory.write<u16>(0x2002, 0xe7fe);
+
+    arm7tdmi::tier_config config;
+    config.predecode_threshold = 1;
+    arm7tdmi::tiered_execution tiers(config);
+    REQUIRE(tiers.enter(0x2000, true, memory).tier() == arm7tdmi::execution_tier::predecoded);
+
+    // Neither the first nor the last page written holds the block
+    tiers.invalidate(0x1ffc, 4);
+    tiers.invalidate(0x2004, 0x1000);
+    REQUIRE(tiers.tier(0x2000, true) == arm7tdmi::execution_tier::predecoded);
+    tiers.invalidate(0x0000, 0x4000);
+    REQUIRE(tiers.tier(0x2000, true) == arm7tdmi::execution_tier::interpreted);
+    REQUIRE(tiers.statistics().invalidations == 1);
+}
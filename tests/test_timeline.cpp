@@ -0,0 +1,158 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <memory>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/coverage.h>
+#include <arm7tdmi/timeline.h>
+
+#include "programs.h"
+
+namespace {
+    // Collects every pc executed
+    struct pc_trace {
+        std::vector<u32> pcs;
+
+        void step(const arm7tdmi::cpu& cpu, arm7tdmi::basic_memory&) {
+            pcs.push_back(cpu.registers.pc());
+        }
+    };
+
+    // Attaches coverage to the worker cpu, and steps it itself
+    struct covered_trace {
+        std::vector<u32> pcs;
+        std::unique_ptr<arm7tdmi::coverage> map;
+        bool code_caches = false;
+
+        void configure(arm7tdmi::cpu& cpu, arm7tdmi::basic_memory&) {
+            code_caches = cpu.uses_code_caches();
+            map = std::make_unique<arm7tdmi::coverage>(0, 0x100);
+            cpu.set_coverage(map.get());
+        }
+
+        bool step(arm7tdmi::cpu& cpu, arm7tdmi::basic_memory&) {
+            pcs.push_back(cpu.registers.pc());
+            return cpu.step();
+        }
+    };
+}
+
+TEST_CASE("timeline_stitched_analysis_matches_serial", "[timeline]")
+{
+    constexpr u64 cycles = 10000;
+
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_program(memory, call_store_lr);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.registers.r0(0x80);
+    cpu.registers.r1(0x84);
+
+    // Serial reference
+    pc_trace serial;
+    {
+        auto reference_memory = arm7tdmi::basic_memory(0x100);
+        load_program(reference_memory, call_store_lr);
+        auto reference = arm7tdmi::cpu(&reference_memory);
+        reference.registers = cpu.registers;
+        while (reference.get_cycles() < cycles) {
+            serial.step(reference, reference_memory);
+            REQUIRE(reference.step());
+        }
+    }
+
+    arm7tdmi::checkpoint_timeline timeline;
+    timeline.record(cpu, memory, 999, cycles);
+    REQUIRE(timeline.size() == 11);
+    REQUIRE(timeline.end_cycle() == cycles);
+
+    const auto parts = timeline.analyze([](size_t) { return pc_trace{}; }, 4);
+    REQUIRE(parts.size() == timeline.size());
+
+    std::vector<u32> stitched;
+    for (const auto& part : parts) {
+        stitched.insert(stitched.end(), part.pcs.begin(), part.pcs.end());
+    }
+    REQUIRE(stitched == serial.pcs);
+}
+
+TEST_CASE("timeline_workers_match_recorded_cpu", "[timeline]")
+{
+    constexpr u64 cycles = 10000;
+    constexpr u64 irq_cycle = 4321;
+
+    auto memory = arm7tdmi::basic_memory(0x100);
+    load_program(memory, copy_word_loop);
+    auto predecode = arm7tdmi::predecode_cache(0, 0x100);
+    predecode.fill(memory, 1);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.set_predecode(&predecode);
+    cpu.registers.r0(0x80);
+    cpu.registers.r1(0x84);
+    cpu.registers.cpsr_set_i(false);
+    cpu.schedule_irq(irq_cycle);
+
+    // Serial reference, the IRQ is taken once since it leaves CPSR.I set
+    pc_trace serial;
+    {
+        auto reference_memory = arm7tdmi::basic_memory(0x100);
+        load_program(reference_memory, copy_word_loop);
+        auto reference = arm7tdmi::cpu(&reference_memory);
+        reference.registers = cpu.registers;
+        reference.schedule_irq(irq_cycle);
+        while (reference.get_cycles() < cycles) {
+            serial.step(reference, reference_memory);
+            REQUIRE(reference.step());
+        }
+        REQUIRE(reference.registers.cpsr_get_mode() == arm7tdmi::cpu_mode::irq);
+    }
+
+    arm7tdmi::checkpoint_timeline timeline;
+    timeline.record(cpu, memory, 999, cycles);
+    REQUIRE(timeline[4].irq_cycle == irq_cycle);
+
+    const auto parts = timeline.analyze([](size_t) { return covered_trace{}; }, 4);
+    REQUIRE(parts.size() == timeline.size());
+
+    std::vector<u32> stitched;
+    for (const auto& part : parts) {
+        REQUIRE(part.code_caches);
+        stitched.insert(stitched.end(), part.pcs.begin(), part.pcs.end());
+    }
+    REQUIRE(stitched == serial.pcs);
+
+    // Only the interval holding the IRQ reaches the vector
+    REQUIRE(parts[4].map->executed(0x18));
+    REQUIRE(!parts[3].map->executed(0x18));
+}
+
+TEST_CASE("checkpoint_restore_dirty_pages", "[timeline]")
+{
+    constexpr u32 size = 4 * arm7tdmi::basic_memory::page_size;
+
+    auto memory = arm7tdmi::basic_memory(size);
+    load_program(memory, call_store_lr);
+    auto cpu = arm7tdmi::cpu(&memory);
+    cpu.registers.r0(0x80);
+    cpu.registers.r1(0x84);
+
+    memory.clear_dirty_pages();
+    arm7tdmi::checkpoint snapshot;
+    snapshot.save(cpu, memory);
+
+    // Writes to two pages, one by the guest and one by the host
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(cpu.step());
+    }
+    memory.write<u32>(2 * arm7tdmi::basic_memory::page_size + 8, 0xdeadbeef);
+
+    REQUIRE(snapshot.restore_dirty(cpu, memory) == 2);
+    REQUIRE(cpu.get_cycles() == 0);
+    REQUIRE(cpu.registers.pc() == 0);
+    REQUIRE(std::equal(snapshot.memory.begin(), snapshot.memory.end(), memory.data()));
+
+    // Nothing ran since, so there is nothing to copy
+    REQUIRE(snapshot.restore_dirty(cpu, memory) == 0);
+}
@@ -0,0 +1,179 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arm7tdmi/aot.h>
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+#include <arm7tdmi/predecode.h>
+#include <arm7tdmi/trace.h>
+
+#include "programs.h"
+
+TEST_CASE("trace_round_trip", "[trace]")
+{
+    constexpr int steps = 3000;
+
+    auto memory = arm7tdmi::basic_memory(0x100);
+    std::stringstream stream;
+    {
+        // Small chunks, so the trace spans several and the writer thread is exercised
+        arm7tdmi::trace_recorder recorder(&memory, stream, {.chunk_size = 256});
+        load_program(recorder, store_load_loop);
+        auto cpu = arm7tdmi::cpu(&recorder);
+        cpu.registers.r0(0x80);
+        cpu.registers.r1(0x11223344);
+        cpu.registers.r2(0x55667788);
+
+        for (int i = 0; i < steps; ++i) {
+            REQUIRE(recorder.step(cpu));
+        }
+        REQUIRE(recorder.records() == steps);
+    }
+
+    stream.seekg(0);
+    arm7tdmi::trace_reader reader(stream);
+    REQUIRE(reader.valid());
+
+    arm7tdmi::trace_record record;
+    for (int i = 0; i < steps; ++i) {
+        REQUIRE(reader.next(&record));
+        REQUIRE(record.state == arm7tdmi::cpu_state::arm);
+        REQUIRE(record.registers[0] == 0x80);
+
+        switch (i % 3) {
+            case 0:
+                REQUIRE(record.pc == 0x0000);
+                REQUIRE(record.opcode == 0xe8800006);
+                REQUIRE(record.accesses.size() == 2);
+                REQUIRE(record.accesses[0].write);
+                REQUIRE(record.accesses[0].address == 0x80);
+                REQUIRE(record.accesses[0].size == 4);
+                REQUIRE(record.accesses[0].value == 0x11223344);
+                REQUIRE(record.accesses[1].address == 0x84);
+                REQUIRE(record.accesses[1].value == 0x55667788);
+                break;
+            case 1:
+                REQUIRE(record.pc == 0x0004);
+                REQUIRE(record.accesses.size() == 1);
+                REQUIRE_FALSE(record.accesses[0].write);
+                REQUIRE(record.accesses[0].value == 0x11223344);
+                REQUIRE(record.registers[3] == 0x11223344);
+                REQUIRE(record.changed == (i == 1 ? 1u << 3 : 0u));
+                break;
+            case 2:
+                REQUIRE(record.pc == 0x0008);
+                REQUIRE(record.opcode == 0xeafffffc);
+                REQUIRE(record.accesses.empty());
+                break;
+        }
+    }
+    REQUIRE_FALSE(reader.next(&record));
+}
+
+TEST_CASE("trace_records_fused_and_compiled_instructions", "[trace]")
+{
+    constexpr u32 steps = 6;
+    constexpr u32 pcs[steps] = {0x0000, 0x0002, 0x0004, 0x0006, 0x000c, 0x000c};
+
+    arm7tdmi::aot_module module;
+    module.add({arm7tdmi_aot_blocks, arm7tdmi_aot_block_count});
+
+    for (const bool aot : {false, true}) {
+        INFO(aot);
+        auto memory = arm7tdmi::basic_memory(0x100);
+        load_program(memory, thumb_compare_branch);
+
+        // MOV/ADD and CMP/BEQ fuse into pairs, and the module runs the first four instructions as one block
+        arm7tdmi::predecode_cache cache(0x0000, 0x100);
+        cache.set_fusion(true);
+        cache.fill(memory);
+        auto attach = [&](arm7tdmi::cpu& cpu) {
+            cpu.set_state(arm7tdmi::cpu_state::thumb);
+            cpu.set_predecode(&cache);
+            cpu.set_aot(aot ? &module : nullptr);
+        };
+
+        auto untraced = arm7tdmi::cpu(&memory);
+        attach(untraced);
+        REQUIRE(untraced.step());
+        REQUIRE(untraced.get_cycles() == (aot ? 4 : 2));
+
+        std::stringstream stream;
+        {
+            arm7tdmi::trace_recorder recorder(&memory, stream);
+            auto cpu = arm7tdmi::cpu(&recorder);
+            attach(cpu);
+            for (u32 i = 0; i < steps; ++i) {
+                REQUIRE(recorder.step(cpu));
+            }
+            REQUIRE(cpu.get_cycles() == steps);
+        }
+
+        stream.seekg(0);
+        arm7tdmi::trace_reader reader(stream);
+        arm7tdmi::trace_record record;
+        for (u32 i = 0; i < steps; ++i) {
+            REQUIRE(reader.next(&record));
+            REQUIRE(record.pc == pcs[i]);
+            REQUIRE(record.opcode == thumb_compare_branch[pcs[i] / 2]);
+            REQUIRE(record.registers[0] == (i == 0 ? 5u : 8u));
+            REQUIRE(record.accesses.empty());
+        }
+        REQUIRE_FALSE(reader.next(&record));
+    }
+}
+
+TEST_CASE("trace_rejects_invalid_header", "[trace]")
+{
+    std::stringstream stream("not a trace");
+    arm7tdmi::trace_reader reader(stream);
+    REQUIRE_FALSE(reader.valid());
+}
+
+TEST_CASE("trace_opcode_as_dispatched", "[trace]")
+{
+    // 0x0002: LDRB R1, [R0, #0], reading the byte just past itself
+    // 0x0004: B 0x0004
+    auto memory = arm7tdmi::basic_memory(0x100);
+    memory.write<u16>(0x0002, 0x7801);
+    memory.write<u16>(0x0004, 0xe7fe);
+
+    for (const bool predecoded : {false, true}) {
+        arm7tdmi::predecode_cache cache(0x0000, 0x100);
+        cache.fill(memory);
+
+        std::stringstream stream;
+        {
+            arm7tdmi::trace_recorder recorder(&memory, stream);
+            auto cpu = arm7tdmi::cpu(&recorder);
+            cpu.set_state(arm7tdmi::cpu_state::thumb);
+            if (predecoded) {
+                cpu.set_predecode(&cache);
+            }
+            cpu.registers.pc(0x0002);
+            cpu.registers.r0(0x0004);
+            REQUIRE(recorder.step(cpu));
+            REQUIRE(recorder.step(cpu));
+        }
+
+        stream.seekg(0);
+        arm7tdmi::trace_reader reader(stream);
+        arm7tdmi::trace_record record;
+        REQUIRE(reader.next(&record));
+        REQUIRE(record.opcode == 0x7801);
+        REQUIRE(record.accesses.size() == 1);
+        REQUIRE(record.accesses[0].address == 0x0004);
+        REQUIRE(record.accesses[0].size == 1);
+        REQUIRE(record.accesses[0].value == 0xfe);
+        REQUIRE(record.registers[1] == 0xfe);
+
+        REQUIRE(reader.next(&record));
+        REQUIRE(record.opcode == 0xe7fe);
+        REQUIRE(record.accesses.empty());
+    }
+}
@@ -0,0 +1,26 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "workloads.h"
+
+#ifdef TEST_COMPILED_ASSEMBLY
+
+// Hidden until the data processing and load/store handlers are implemented, run with "[workloads]".
+TEST_CASE("workloads_checksum", "[workloads][.]")
+{
+    for (const auto& w : workloads) {
+        INFO(w.path);
+
+        auto memory = arm7tdmi::basic_memory(workload_memory_size);
+        auto cpu = arm7tdmi::cpu(&memory);
+        load_workload(w, memory, cpu);
+
+        REQUIRE(run_workload(w, memory, cpu, 50'000'000));
+        CHECK(cpu.registers.r0() == w.checksum);
+    }
+}
+
+#endif
@@ -0,0 +1,80 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+#pragma once
+
+#include <string>
+
+#include <arm7tdmi/cpu.h>
+#include <arm7tdmi/memory.h>
+
+#include "utility.h"
+
+// Guest workloads in assembly/{arm,thumb}/workloads. Each one starts in arm state at 0x8000, leaves its
+// checksum in r0, and finishes on a branch to itself. Addresses in the linked binary match file
+// offsets, so the whole file is loaded at address 0.
+struct workload {
+    const char* path;
+    u32 checksum;
+
+    // Cycles between timer interrupts, 0 if the workload doesn't use the timer
+    u32 timer_period = 0;
+};
+
+inline constexpr workload workloads[] = {
+    {"assembly/arm/workloads/crc32.s.bin", 0xc39b3ffa},
+    {"assembly/arm/workloads/dhrystone.s.bin", 0xe783a7da},
+    {"assembly/arm/workloads/memcpy_memset.s.bin", 0x7e04a7c0},
+    {"assembly/arm/workloads/quicksort.s.bin", 0x6b913a18},
+    {"assembly/arm/workloads/context_switch.s.bin", 0xd8aaf9a1},
+    {"assembly/arm/workloads/timer_irq.s.bin", 0xf5bfe400, 200},
+    {"assembly/thumb/workloads/crc32.s.bin", 0xc39b3ffa},
+    {"assembly/thumb/workloads/memcpy_memset.s.bin", 0x7e04a7c0},
+    {"assembly/thumb/workloads/bubble_sort.s.bin", 0x3f184cee},
+};
+
+inline constexpr u32 workload_memory_size = 0x40000;
+inline constexpr u32 workload_entry = 0x8000;
+
+// Timer registers written by the timer_irq workload's handler
+inline constexpr u32 workload_timer_ack = 0x30000;
+
+inline void load_workload(const workload& w, arm7tdmi::basic_memory& memory, arm7tdmi::cpu& cpu) {
+    const auto image = read_binary_from_file(w.path);
+    for (size_t i = 0; i < image.size() && i < memory.size(); ++i) {
+        memory.write<u8>(static_cast<u32>(i), image[i]);
+    }
+    cpu.registers.pc(workload_entry);
+    cpu.set_state(arm7tdmi::cpu_state::arm);
+}
+
+/**
+ * Runs a loaded workload until it branches to itself, or until max_instructions.
+ * @return True if the workload finished.
+ */
+inline bool run_workload(const workload& w, arm7tdmi::basic_memory& memory, arm7tdmi::cpu& cpu,
+                         const u64 max_instructions) {
+    for (u64 i = 0; i < max_instructions; ++i) {
+        if (w.timer_period != 0) {
+            u32 ack = 0;
+            memory.read<u32>(workload_timer_ack, &ack);
+            if (ack != 0) {
+                memory.write<u32>(workload_timer_ack, 0);
+                cpu.set_irq_line(false);
+            }
+            if (cpu.get_cycles() % w.timer_period == 0) {
+                cpu.set_irq_line(true);
+            }
+        }
+
+        const u32 pc = cpu.registers.pc();
+        if (!cpu.step()) {
+            return false;
+        }
+        if (cpu.registers.pc() == pc) {
+            return true;
+        }
+    }
+    return false;
+}
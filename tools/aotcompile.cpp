@@ -0,0 +1,100 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+// Compiles the code of an ELF image ahead of time into C++ (write_aot_source):
+//   aotcompile <firmware.elf> <out.cpp>
+// Blocks are found from the entry point and every symbol in an executable segment. Build the output
+// as a shared object for aot_module::load, e.g.
+//   c++ -std=c++20 -O2 -shared -fPIC -I<arm7tdmi>/include out.cpp -o firmware.so
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <arm7tdmi/aot.h>
+#include <arm7tdmi/elf.h>
+#include <arm7tdmi/memory.h>
+
+namespace {
+    // The image's segments, without backing the whole address space
+    class segment_memory final : public arm7tdmi::memory_interface {
+    public:
+        explicit segment_memory(const std::vector<arm7tdmi::elf_segment>& segments) {
+            for (const auto& segment : segments) {
+                _segments.push_back({segment.address, std::vector<u8>(segment.memory_size)});
+            }
+        }
+
+        [[nodiscard]] u64 size() const noexcept override { return u64{1} << 32; }
+
+    protected:
+        [[nodiscard]] bool read_byte(const u32 address, u8* out) const noexcept override {
+            for (const auto& [base, data] : _segments) {
+                if (address - base < data.size()) {
+                    *out = data[address - base];
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool write_byte(const size_t address, const u8 value) noexcept override {
+            for (auto& [base, data] : _segments) {
+                if (address - base < data.size()) {
+                    data[address - base] = value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::vector<std::pair<u32, std::vector<u8>>> _segments;
+    };
+}
+
+int main(const int argc, char** argv) {
+    if (argc != 3) {
+        fmt::print(stderr, "usage: {} <firmware.elf> <out.cpp>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    arm7tdmi::elf_image image;
+    if (!in || !image.load(in)) {
+        fmt::print(stderr, "{}: not a 32 bit ARM ELF file\n", argv[1]);
+        return 1;
+    }
+
+    segment_memory memory(image.segments());
+    image.load_segments(memory);
+
+    auto executable = [&](const u32 address) {
+        for (const auto& segment : image.segments()) {
+            if (segment.executable && address - segment.address < segment.memory_size) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<arm7tdmi::aot_seed> seeds;
+    seeds.push_back({image.entry() & ~1u, (image.entry() & 1u) != 0});
+    for (const auto& symbol : image.symbols()) {
+        if (executable(symbol.address)) {
+            seeds.push_back({symbol.address, symbol.thumb});
+        }
+    }
+
+    std::ofstream out(argv[2]);
+    const u32 blocks = arm7tdmi::write_aot_source(memory, seeds, out);
+    if (!out) {
+        fmt::print(stderr, "{}: could not be written\n", argv[2]);
+        return 1;
+    }
+    fmt::print("{} blocks from {} entry points\n", blocks, seeds.size());
+    return 0;
+}
@@ -0,0 +1,374 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+// Exhaustively verifies the decoders. Every one of the 2^32 ARM and 2^16 Thumb opcodes is classified,
+// in batches spread over every host core, and checked against:
+//   - the decoder's own patterns() table, which must agree with decode() on every opcode
+//   - decode_batch(), which must agree with decode() on every opcode
+//   - a reference table written independently from the ARM7TDMI data sheet encodings
+// Also reports where the decoder's patterns overlap, and which instruction decode() resolves them to,
+// and the reserved encodings (coprocessor, unallocated) the decoder accepts as an instruction anyway.
+//   decodeverify [--threads n] [--thumb]
+// Exits with 1 if decode() disagrees with its patterns or decode_batch(), or decodes an instruction as a different one.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <arm7tdmi/decoder.h>
+
+namespace {
+    template <typename Opcode, typename Instruction>
+    struct reference {
+        const char* name;
+        Instruction instr;
+        Opcode mask;
+        Opcode format;
+    };
+
+    using arm_instruction = arm7tdmi::arm::instruction;
+    using thumb_instruction = arm7tdmi::thumb::instruction;
+
+    // Disjoint by construction, a reserved row names an encoding the decoder has no instruction for
+    constexpr reference<u32, arm_instruction> arm_reference[] = {
+        {"data_processing", arm_instruction::data_processing, 0x0e100010, 0x00100000},
+        {"data_processing", arm_instruction::data_processing, 0x0f100010, 0x00000000},
+        {"data_processing", arm_instruction::data_processing, 0x0f900010, 0x01800000},
+        {"data_processing", arm_instruction::data_processing, 0x0e100090, 0x00100010},
+        {"data_processing", arm_instruction::data_processing, 0x0f100090, 0x00000010},
+        {"data_processing", arm_instruction::data_processing, 0x0f900090, 0x01800010},
+        {"data_processing", arm_instruction::data_processing, 0x0e100000, 0x02100000},
+        {"data_processing", arm_instruction::data_processing, 0x0f100000, 0x02000000},
+        {"data_processing", arm_instruction::data_processing, 0x0f900000, 0x03800000},
+        {"psr_transfer_mrs", arm_instruction::psr_transfer_mrs, 0x0fbf0fff, 0x010f0000},
+        {"psr_transfer_msr", arm_instruction::psr_transfer_msr, 0x0fb0fff0, 0x0120f000},
+        {"psr_transfer_msr", arm_instruction::psr_transfer_msr, 0x0fb0f000, 0x0320f000},
+        {"branch_and_exchange", arm_instruction::branch_and_exchange, 0x0ffffff0, 0x012fff10},
+        {"multiply", arm_instruction::multiply, 0x0fc000f0, 0x00000090},
+        {"multiply_long", arm_instruction::multiply_long, 0x0f8000f0, 0x00800090},
+        {"single_data_swap", arm_instruction::single_data_swap, 0x0fb00ff0, 0x01000090},
+        {"halfword_data_transfer_register", arm_instruction::halfword_data_transfer_register, 0x0e400ff0, 0x000000b0},
+        {"halfword_data_transfer_register", arm_instruction::halfword_data_transfer_register, 0x0e400fd0, 0x000000d0},
+        {"halfword_data_transfer_immediate", arm_instruction::halfword_data_transfer_immediate, 0x0e4000f0, 0x004000b0},
+        {"halfword_data_transfer_immediate", arm_instruction::halfword_data_transfer_immediate, 0x0e4000d0, 0x004000d0},
+        {"single_data_transfer", arm_instruction::single_data_transfer, 0x0e000000, 0x04000000},
+        {"single_data_transfer", arm_instruction::single_data_transfer, 0x0e000010, 0x06000000},
+        {"undefined", arm_instruction::undefined, 0x0e000010, 0x06000010},
+        {"block_data_transfer", arm_instruction::block_data_transfer, 0x0e000000, 0x08000000},
+        {"branch", arm_instruction::branch, 0x0e000000, 0x0a000000},
+        {"coprocessor_data_transfer", arm_instruction::unknown, 0x0e000000, 0x0c000000},
+        {"coprocessor_data_operation", arm_instruction::unknown, 0x0f000010, 0x0e000000},
+        {"coprocessor_register_transfer", arm_instruction::unknown, 0x0f000010, 0x0e000010},
+        {"software_interrupt", arm_instruction::software_interrupt, 0x0f000000, 0x0f000000},
+    };
+
+    constexpr reference<u16, thumb_instruction> thumb_reference[] = {
+        {"move_shifted_register", thumb_instruction::move_shifted_register, 0xf800, 0x0000},
+        {"move_shifted_register", thumb_instruction::move_shifted_register, 0xf800, 0x0800},
+        {"move_shifted_register", thumb_instruction::move_shifted_register, 0xf800, 0x1000},
+        {"add_subtract", thumb_instruction::add_subtract, 0xf800, 0x1800},
+        {"move_compare_add_subtract_immediate", thumb_instruction::move_compare_add_subtract_immediate, 0xe000, 0x2000},
+        {"alu_operations", thumb_instruction::alu_operations, 0xfc00, 0x4000},
+        {"hi_register_operations_branch_exchange", thumb_instruction::hi_register_operations_branch_exchange, 0xfc00, 0x4400},
+        {"pc_relative_load", thumb_instruction::pc_relative_load, 0xf800, 0x4800},
+        {"load_store_with_register_offset", thumb_instruction::load_store_with_register_offset, 0xf200, 0x5000},
+        {"load_store_sign_extended_byte_halfword", thumb_instruction::load_store_sign_extended_byte_halfword, 0xf200, 0x5200},
+        {"load_store_with_immediate_offset", thumb_instruction::load_store_with_immediate_offset, 0xe000, 0x6000},
+        {"load_store_halfword", thumb_instruction::load_store_halfword, 0xf000, 0x8000},
+        {"sp_relative_load_store", thumb_instruction::sp_relative_load_store, 0xf000, 0x9000},
+        {"load_address", thumb_instruction::load_address, 0xf000, 0xa000},
+        {"add_offset_to_stack_pointer", thumb_instruction::add_offset_to_stack_pointer, 0xff00, 0xb000},
+        {"push_pop_registers", thumb_instruction::push_pop_registers, 0xf600, 0xb400},
+        {"multiple_load_store", thumb_instruction::multiple_load_store, 0xf000, 0xc000},
+        {"conditional_branch", thumb_instruction::conditional_branch, 0xf800, 0xd000},
+        {"conditional_branch", thumb_instruction::conditional_branch, 0xfc00, 0xd800},
+        {"conditional_branch", thumb_instruction::conditional_branch, 0xfe00, 0xdc00},
+        {"software_interrupt", thumb_instruction::software_interrupt, 0xff00, 0xdf00},
+        {"unconditional_branch", thumb_instruction::unconditional_branch, 0xf800, 0xe000},
+        {"long_branch_with_link", thumb_instruction::long_branch_with_link, 0xf000, 0xf000},
+    };
+
+    struct arm_isa {
+        using opcode = u32;
+        using instruction = arm_instruction;
+        static constexpr const char* name = "arm";
+        static constexpr u64 opcodes = u64{1} << 32;
+        static instruction decode(const opcode op) noexcept { return arm7tdmi::arm::decode(op); }
+        static void decode_batch(const std::span<const opcode> ops, const std::span<instruction> out) noexcept { arm7tdmi::arm::decode_batch(ops, out); }
+        static auto patterns() noexcept { return arm7tdmi::arm::patterns(); }
+        static const char* to_string(const instruction instr) noexcept { return arm7tdmi::arm::instruction_to_string(instr); }
+        static std::span<const reference<opcode, instruction>> reference_table() noexcept { return arm_reference; }
+    };
+
+    struct thumb_isa {
+        using opcode = u16;
+        using instruction = thumb_instruction;
+        static constexpr const char* name = "thumb";
+        static constexpr u64 opcodes = u64{1} << 16;
+        static instruction decode(const opcode op) noexcept { return arm7tdmi::thumb::decode(op); }
+        static void decode_batch(const std::span<const opcode> ops, const std::span<instruction> out) noexcept { arm7tdmi::thumb::decode_batch(ops, out); }
+        static auto patterns() noexcept { return arm7tdmi::thumb::patterns(); }
+        static const char* to_string(const instruction instr) noexcept { return arm7tdmi::thumb::instruction_to_string(instr); }
+        static std::span<const reference<opcode, instruction>> reference_table() noexcept { return thumb_reference; }
+    };
+
+    struct tally {
+        u64 count = 0;
+        u64 example = std::numeric_limits<u64>::max();
+
+        void add(const u64 opcode) noexcept {
+            count++;
+            example = std::min(example, opcode);
+        }
+
+        void merge(const tally& other) noexcept {
+            count += other.count;
+            example = std::min(example, other.example);
+        }
+    };
+
+    constexpr u32 batch_size = 4096;
+
+    template <typename Isa>
+    struct scan_result {
+        // [patterns() instruction][decode() instruction], where they disagree
+        std::vector<tally> inconsistent;
+        // [decode() instruction][decode_batch() instruction], where they disagree
+        std::vector<tally> batched;
+        // Indexed by the set of decoder patterns an opcode matches, when it matches more than one
+        std::vector<tally> overlaps;
+        // [first reference row][last reference row], when an opcode matches more than one
+        std::vector<tally> reference_overlaps;
+        // [reference row, or one past the end for no row][decode() instruction], where they disagree
+        std::vector<tally> differences;
+
+        explicit scan_result(const size_t patterns, const size_t rows)
+            : inconsistent(instructions * instructions), batched(instructions * instructions), overlaps(size_t{1} << patterns),
+              reference_overlaps(rows * rows), differences((rows + 1) * instructions) {}
+
+        void merge(const scan_result& other) noexcept {
+            auto add = [](std::vector<tally>& to, const std::vector<tally>& from) noexcept {
+                for (size_t i = 0; i < to.size(); ++i) to[i].merge(from[i]);
+            };
+            add(inconsistent, other.inconsistent);
+            add(batched, other.batched);
+            add(overlaps, other.overlaps);
+            add(reference_overlaps, other.reference_overlaps);
+            add(differences, other.differences);
+        }
+
+        static constexpr size_t instructions = static_cast<size_t>(Isa::instruction::unknown) + 1;
+    };
+
+    template <typename Isa>
+    struct batch_buffers {
+        std::vector<typename Isa::opcode> opcodes = std::vector<typename Isa::opcode>(batch_size);
+        std::vector<typename Isa::instruction> batched = std::vector<typename Isa::instruction>(batch_size);
+        std::vector<u32> matched = std::vector<u32>(batch_size);
+        std::vector<u32> referenced = std::vector<u32>(batch_size);
+    };
+
+    template <typename Isa>
+    void classify_batch(const u64 base, const u32 size, scan_result<Isa>& result, batch_buffers<Isa>& buffers) noexcept {
+        using opcode = typename Isa::opcode;
+        auto& [opcodes, batched, matched, referenced] = buffers;
+        const auto patterns = Isa::patterns();
+        const auto rows = Isa::reference_table();
+        constexpr size_t instructions = scan_result<Isa>::instructions;
+
+        // One pass per pattern over the whole batch, branch free so the compiler vectorises it
+        for (u32 i = 0; i < size; ++i) {
+            opcodes[i] = static_cast<opcode>(base + i);
+        }
+        Isa::decode_batch(std::span(opcodes.data(), size), std::span(batched.data(), size));
+
+        std::fill_n(matched.begin(), size, 0u);
+        std::fill_n(referenced.begin(), size, 0u);
+        for (size_t p = 0; p < patterns.size(); ++p) {
+            const opcode mask = patterns[p].mask, format = patterns[p].format;
+            for (u32 i = 0; i < size; ++i) {
+                matched[i] |= static_cast<u32>((static_cast<opcode>(base + i) & mask) == format) << p;
+            }
+        }
+        for (size_t r = 0; r < rows.size(); ++r) {
+            const opcode mask = rows[r].mask, format = rows[r].format;
+            for (u32 i = 0; i < size; ++i) {
+                referenced[i] |= static_cast<u32>((static_cast<opcode>(base + i) & mask) == format) << r;
+            }
+        }
+
+        for (u32 i = 0; i < size; ++i) {
+            const u64 value = base + i;
+            const auto instr = Isa::decode(static_cast<opcode>(value));
+            const auto decoded = static_cast<size_t>(instr);
+            if (batched[i] != instr) {
+                result.batched[decoded * instructions + static_cast<size_t>(batched[i])].add(value);
+            }
+
+            const u32 set = matched[i];
+            const auto first = set ? patterns[std::countr_zero(set)].instr : Isa::instruction::unknown;
+            if (first != instr) {
+                result.inconsistent[static_cast<size_t>(first) * instructions + decoded].add(value);
+            }
+            if (std::popcount(set) > 1) {
+                result.overlaps[set].add(value);
+            }
+
+            const u32 rows_set = referenced[i];
+            const size_t row = rows_set ? std::countr_zero(rows_set) : rows.size();
+            if (std::popcount(rows_set) > 1) {
+                result.reference_overlaps[row * rows.size() + (31 - std::countl_zero(rows_set))].add(value);
+            }
+            const auto expected = rows_set ? rows[row].instr : Isa::instruction::unknown;
+            if (expected != instr) {
+                result.differences[row * instructions + decoded].add(value);
+            }
+        }
+    }
+
+    template <typename Isa>
+    scan_result<Isa> scan(u32 threads) noexcept {
+        static_assert(sizeof(u32) * 8 >= std::size(arm_reference) && sizeof(u32) * 8 >= std::size(thumb_reference));
+        const size_t patterns = Isa::patterns().size();
+        const size_t rows = Isa::reference_table().size();
+        const u64 batches = (Isa::opcodes + batch_size - 1) / batch_size;
+        threads = static_cast<u32>(std::min<u64>(threads, batches));
+
+        std::vector<scan_result<Isa>> results(threads, scan_result<Isa>(patterns, rows));
+        std::atomic<u64> next = 0;
+        auto work = [&](scan_result<Isa>& result) noexcept {
+            batch_buffers<Isa> buffers;
+            for (u64 batch = next++; batch < batches; batch = next++) {
+                const u64 base = batch * batch_size;
+                classify_batch<Isa>(base, static_cast<u32>(std::min<u64>(batch_size, Isa::opcodes - base)), result, buffers);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (u32 t = 1; t < threads; ++t) {
+            workers.emplace_back(work, std::ref(results[t]));
+        }
+        work(results[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (u32 t = 1; t < threads; ++t) {
+            results[0].merge(results[t]);
+        }
+        return std::move(results[0]);
+    }
+
+    template <typename Isa>
+    bool verify(const u32 threads) {
+        constexpr int digits = sizeof(typename Isa::opcode) * 2;
+        constexpr size_t instructions = scan_result<Isa>::instructions;
+        const auto patterns = Isa::patterns();
+        const auto rows = Isa::reference_table();
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = scan<Isa>(threads);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        fmt::print("{}: {} opcodes in {:.1f}s\n", Isa::name, Isa::opcodes, elapsed.count());
+
+        auto name = [](const size_t instr) { return Isa::to_string(static_cast<typename Isa::instruction>(instr)); };
+        bool ok = true;
+
+        for (size_t i = 0; i < result.inconsistent.size(); ++i) {
+            if (const auto& t = result.inconsistent[i]; t.count) {
+                fmt::print("  patterns() gives {}, decode() gives {}: {} opcodes, e.g. {:0{}x}\n",
+                    name(i / instructions), name(i % instructions), t.count, t.example, digits);
+                ok = false;
+            }
+        }
+
+        for (size_t i = 0; i < result.batched.size(); ++i) {
+            if (const auto& t = result.batched[i]; t.count) {
+                fmt::print("  decode() gives {}, decode_batch() gives {}: {} opcodes, e.g. {:0{}x}\n",
+                    name(i / instructions), name(i % instructions), t.count, t.example, digits);
+                ok = false;
+            }
+        }
+
+        fmt::print("  overlapping decoder patterns:\n");
+        for (u32 set = 0; set < result.overlaps.size(); ++set) {
+            const auto& t = result.overlaps[set];
+            if (!t.count) {
+                continue;
+            }
+            std::string names;
+            for (u32 bits = set; bits; bits &= bits - 1) {
+                names += fmt::format("{}{}", names.empty() ? "" : " + ", Isa::to_string(patterns[std::countr_zero(bits)].instr));
+            }
+            fmt::print("    {} -> {}: {} opcodes, e.g. {:0{}x}\n",
+                names, Isa::to_string(patterns[std::countr_zero(set)].instr), t.count, t.example, digits);
+        }
+
+        for (size_t i = 0; i < result.reference_overlaps.size(); ++i) {
+            if (const auto& t = result.reference_overlaps[i]; t.count) {
+                fmt::print("  reference rows {} and {} overlap: {} opcodes, e.g. {:0{}x}\n",
+                    i / rows.size(), i % rows.size(), t.count, t.example, digits);
+                ok = false;
+            }
+        }
+
+        fmt::print("  reserved encodings accepted:\n");
+        for (size_t i = 0; i < result.differences.size(); ++i) {
+            const auto& t = result.differences[i];
+            const size_t row = i / instructions;
+            if (t.count && (row == rows.size() || rows[row].instr == Isa::instruction::unknown)) {
+                fmt::print("    {} as {}: {} opcodes, e.g. {:0{}x}\n",
+                    row == rows.size() ? "unallocated" : rows[row].name, name(i % instructions), t.count, t.example, digits);
+            }
+        }
+
+        for (size_t i = 0; i < result.differences.size(); ++i) {
+            const auto& t = result.differences[i];
+            const size_t row = i / instructions;
+            if (t.count && row < rows.size() && rows[row].instr != Isa::instruction::unknown) {
+                fmt::print("  MISMATCH {} (reference row {}) decoded as {}: {} opcodes, e.g. {:0{}x}\n",
+                    rows[row].name, row, name(i % instructions), t.count, t.example, digits);
+                ok = false;
+            }
+        }
+
+        fmt::print("  {}\n", ok ? "ok" : "FAILED");
+        return ok;
+    }
+}
+
+int main(const int argc, char** argv) {
+    u32 threads = std::max(1u, std::thread::hardware_concurrency());
+    bool thumb_only = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1ul, std::strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--thumb") {
+            thumb_only = true;
+        }
+        else {
+            fmt::print(stderr, "usage: {} [--threads n] [--thumb]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    fmt::print("{} threads\n", threads);
+    bool ok = verify<thumb_isa>(threads);
+    if (!thumb_only) {
+        ok = verify<arm_isa>(threads) && ok;
+    }
+    return ok ? 0 : 1;
+}
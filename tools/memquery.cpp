@@ -0,0 +1,78 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+// Queries a memory access log (memory_log_recorder), scanning its chunks on every host core:
+//   memquery <log> writes <begin> <end>     every write overlapping [begin, end)
+//   memquery <log> hot [count]              most accessed 64 byte lines
+//   memquery <log> first-writer <address>   earliest write covering the address
+// Numbers may be decimal or 0x prefixed. --threads <n> limits the worker threads.
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <arm7tdmi/memory_log.h>
+
+namespace {
+    void print_access(const arm7tdmi::memory_log_access& access) {
+        fmt::print("{:>12} pc={:08x} {}{} [{:08x}]={:0{}x}\n", access.cycle, access.pc, access.fetch ? 'F' : access.write ? 'W' : 'R',
+            access.size * 8, access.address, access.value, access.size * 2);
+    }
+
+    int usage(const char* name) {
+        fmt::print(stderr, "usage: {} <log> [--threads n] writes <begin> <end> | hot [count] | first-writer <address>\n", name);
+        return 1;
+    }
+}
+
+int main(const int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    u32 threads = 0;
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--threads") {
+            threads = static_cast<u32>(std::strtoul(args[i + 1].c_str(), nullptr, 0));
+            args.erase(args.begin() + static_cast<std::ptrdiff_t>(i), args.begin() + static_cast<std::ptrdiff_t>(i) + 2);
+            break;
+        }
+    }
+    if (args.size() < 2) {
+        return usage(argv[0]);
+    }
+
+    arm7tdmi::memory_log_reader reader;
+    if (!reader.open(args[0])) {
+        fmt::print(stderr, "{}: not a memory log\n", args[0]);
+        return 1;
+    }
+
+    auto number = [&](const size_t index, const u64 fallback) -> u64 {
+        return index < args.size() ? std::strtoull(args[index].c_str(), nullptr, 0) : fallback;
+    };
+
+    const std::string& query = args[1];
+    if (query == "writes" && args.size() >= 4) {
+        for (const auto& access : reader.writes_in_range(static_cast<u32>(number(2, 0)), static_cast<u32>(number(3, 0)), threads)) {
+            print_access(access);
+        }
+    }
+    else if (query == "hot") {
+        for (const auto& [line, count] : reader.hottest_lines(number(2, 16), threads)) {
+            fmt::print("{:08x} {}\n", line, count);
+        }
+    }
+    else if (query == "first-writer" && args.size() >= 3) {
+        if (const auto access = reader.first_writer(static_cast<u32>(number(2, 0)), threads)) {
+            print_access(*access);
+        }
+        else {
+            fmt::print("never written\n");
+        }
+    }
+    else {
+        return usage(argv[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+//
+// Created by talexander on 10/19/2026.
+//
+
+// Converts a binary execution trace (trace_recorder) to text, one instruction per line:
+//   <index> <pc> <opcode> <A|T> <disassembly> [r<n>=<value>...] [<R|W><bits> [<address>]=<value>...]
+
+#include <cstdio>
+#include <fstream>
+
+#include <fmt/format.h>
+
+#include <arm7tdmi/disassembler.h>
+#include <arm7tdmi/trace.h>
+
+int main(const int argc, char** argv) {
+    if (argc < 2) {
+        fmt::print(stderr, "usage: {} <trace> [output]\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    arm7tdmi::trace_reader reader(in);
+    if (!in || !reader.valid()) {
+        fmt::print(stderr, "{}: not a trace file\n", argv[1]);
+        return 1;
+    }
+
+    std::FILE* out = stdout;
+    if (argc > 2) {
+        out = std::fopen(argv[2], "w");
+        if (!out) {
+            fmt::print(stderr, "{}: cannot open for writing\n", argv[2]);
+            return 1;
+        }
+    }
+
+    fmt::memory_buffer line;
+    char text[arm7tdmi::disassembly_line_size];
+    arm7tdmi::trace_record record;
+    for (u64 index = 0; reader.next(&record); ++index) {
+        line.clear();
+        const bool thumb = record.state == arm7tdmi::cpu_state::thumb;
+        if (thumb) {
+            arm7tdmi::thumb::disassemble(static_cast<u16>(record.opcode), record.pc, text, sizeof(text));
+        }
+        else {
+            arm7tdmi::arm::disassemble(record.opcode, record.pc, text, sizeof(text));
+        }
+
+        fmt::format_to(std::back_inserter(line), "{:>10} {:08x} {:0{}x} {} {:<32}{}", index, record.pc, record.opcode,
+            thumb ? 4 : 8, thumb ? 'T' : 'A', text, record.exception ? " (irq)" : "");
+
+        for (u32 i = 0; i < record.registers.size(); ++i) {
+            if (record.changed & (1u << i)) {
+                if (i == 15) {
+                    fmt::format_to(std::back_inserter(line), " cpsr={:08x}", record.registers[i]);
+                }
+                else {
+                    fmt::format_to(std::back_inserter(line), " r{}={:08x}", i, record.registers[i]);
+                }
+            }
+        }
+        for (const auto& access : record.accesses) {
+            fmt::format_to(std::back_inserter(line), " {}{} [{:08x}]={:0{}x}", access.write ? 'W' : 'R', access.size * 8,
+                access.address, access.value, access.size * 2);
+        }
+        line.push_back('\n');
+        std::fwrite(line.data(), 1, line.size(), out);
+    }
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}